@@ -0,0 +1,55 @@
+# Applicazione grafica (compilata da biblioteca.pro insieme alla libreria nucleo)
+# Configurazione base del progetto Qt
+QT += core widgets
+
+# Standard C++ moderno richiesto per smart pointers e altre funzionalità
+CONFIG += c++17
+
+# Nome dell'eseguibile finale
+TARGET = BibliotecaManager
+
+# Tipo di progetto: applicazione eseguibile
+TEMPLATE = app
+
+# Definizione delle cartelle per gli include
+INCLUDEPATH += modello_logico \
+               interfaccia \
+               json
+
+# Modello logico e JSON: libreria statica nucleo (vedi nucleo/nucleo.pro)
+include(modello.pri)
+
+# File sorgente - SUDDIVISI
+SOURCES += main.cpp \
+           interfaccia/mainwindow.cpp \
+           interfaccia/mainwindow_ui.cpp \
+           interfaccia/mainwindow_editpanel.cpp \
+           interfaccia/mainwindow_editlogic.cpp \
+           interfaccia/mainwindow_validation.cpp \
+           interfaccia/mediacard.cpp \
+           interfaccia/mediafactory.cpp \
+           interfaccia/pannelloprestazioni.cpp \
+           interfaccia/iconemedia.cpp \
+           interfaccia/selezionecard.cpp \
+           interfaccia/grigliacard.cpp
+
+# File header
+HEADERS += interfaccia/mainwindow.h \
+           interfaccia/mediacard.h \
+           interfaccia/mediafactory.h \
+           interfaccia/pannelloprestazioni.h \
+           interfaccia/iconemedia.h \
+           interfaccia/selezionecard.h \
+           interfaccia/grigliacard.h
+
+# Memoria residente per il pannello delle prestazioni
+win32: LIBS += -lpsapi
+
+# File di risorse 
+RESOURCES += resources.qrc
+
+# Abilitare warning per API Qt deprecate
+DEFINES += QT_DEPRECATED_WARNINGS
+
+# Disabilitare API Qt precedenti a una certa versione
+DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0x060000
\ No newline at end of file
@@ -0,0 +1,465 @@
+#include "modello_logico/collezione.h"
+#include "modello_logico/libro.h"
+#include "modello_logico/film.h"
+#include "modello_logico/articolo.h"
+#include "modello_logico/filtrostrategy.h"
+#include "modello_logico/programmafiltro.h"
+#include "json/jsonmanager.h"
+#include "interfaccia/mediacard.h"
+#include <QApplication>
+#include <QRandomGenerator>
+#include <QTemporaryDir>
+#include <QtTest>
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <vector>
+
+namespace {
+
+const QStringList PAROLE = {
+    "rosa", "notte", "viaggio", "mare", "città", "memoria", "silenzio", "vento",
+    "giardino", "ombra", "fiume", "tempo", "luce", "confine", "ritorno", "segreto"
+};
+
+const QStringList PERSONE = {
+    "Italo Calvino", "Umberto Eco", "Elsa Morante", "Natalia Ginzburg", "Primo Levi",
+    "Federico Fellini", "Sergio Leone", "Lina Wertmüller", "Rita Levi-Montalcini", "Enrico Fermi"
+};
+
+const QStringList EDITORI = {"Einaudi", "Feltrinelli", "Adelphi", "Mondadori", "Sellerio"};
+
+const int SEME = 20240601;
+
+QString frase(QRandomGenerator& generatore, int parole)
+{
+    QStringList testo;
+    for (int i = 0; i < parole; ++i) {
+        testo << PAROLE[generatore.bounded(static_cast<int>(PAROLE.size()))];
+    }
+    return testo.join(' ');
+}
+
+QString persona(QRandomGenerator& generatore)
+{
+    return PERSONE[generatore.bounded(static_cast<int>(PERSONE.size()))];
+}
+
+// Catalogo riproducibile: stesso seme, stessi media (a meno degli id)
+std::vector<std::unique_ptr<Media>> creaCatalogo(int dimensione)
+{
+    QRandomGenerator generatore(SEME);
+    std::vector<std::unique_ptr<Media>> catalogo;
+    catalogo.reserve(static_cast<size_t>(dimensione));
+
+    for (int i = 0; i < dimensione; ++i) {
+        QString titolo = QString("%1 %2").arg(frase(generatore, 3)).arg(i);
+        QString descrizione = frase(generatore, 40);
+        int anno = 1950 + generatore.bounded(70);
+
+        switch (i % 3) {
+            case 0:
+                catalogo.push_back(std::make_unique<Libro>(
+                    titolo, anno, descrizione, persona(generatore),
+                    EDITORI[generatore.bounded(static_cast<int>(EDITORI.size()))],
+                    100 + generatore.bounded(600), QString(),
+                    static_cast<Libro::Genere>(generatore.bounded(3))));
+                break;
+            case 1:
+                catalogo.push_back(std::make_unique<Film>(
+                    titolo, anno, descrizione, persona(generatore),
+                    QStringList{persona(generatore), persona(generatore)},
+                    80 + generatore.bounded(100),
+                    static_cast<Film::Genere>(generatore.bounded(3)),
+                    static_cast<Film::Classificazione>(generatore.bounded(4)),
+                    EDITORI[generatore.bounded(static_cast<int>(EDITORI.size()))]));
+                break;
+            default:
+                catalogo.push_back(std::make_unique<Articolo>(
+                    titolo, anno, descrizione,
+                    QStringList{persona(generatore), persona(generatore)},
+                    QString("Rivista %1").arg(PAROLE[generatore.bounded(static_cast<int>(PAROLE.size()))]),
+                    QString::number(1 + generatore.bounded(40)), QString::number(1 + generatore.bounded(12)),
+                    QString("%1-%2").arg(1 + generatore.bounded(50)).arg(60 + generatore.bounded(50)),
+                    static_cast<Articolo::Categoria>(generatore.bounded(3)),
+                    static_cast<Articolo::TipoRivista>(generatore.bounded(3)),
+                    QDate(anno, 1 + generatore.bounded(12), 1 + generatore.bounded(28))));
+                break;
+        }
+    }
+    return catalogo;
+}
+
+// Alberi annidati di AND/OR alternati, con una negazione e un filtro per tipo a ogni livello
+std::unique_ptr<FiltroStrategy> creaFiltroProfondo(int livelli)
+{
+    if (livelli == 0) {
+        return FiltroFactory::createRegistaFiltro("Fellini");
+    }
+
+    auto composto = std::make_unique<FiltroComposto>(livelli % 2 ? FiltroComposto::And : FiltroComposto::Or);
+    composto->addFiltro(FiltroFactory::createAnnoFiltro(1950 + livelli * 3, 2000 + livelli));
+    composto->addFiltro(std::make_unique<FiltroNegato>(
+        FiltroFactory::createAutoreFiltro(PERSONE[livelli % static_cast<int>(PERSONE.size())].section(' ', -1))));
+    composto->addFiltro(FiltroFactory::createTipoFiltro(livelli % 3 ? "Libro" : "Articolo"));
+    composto->addFiltro(creaFiltroProfondo(livelli - 1));
+    return composto;
+}
+
+const int LIVELLI_FILTRO_PROFONDO = 8;
+
+} // namespace
+
+/**
+ * @brief Benchmark delle operazioni principali a diverse dimensioni della collezione
+ *
+ * Ogni benchmark ha una riga per dimensione; collezioni e file sono creati una
+ * volta per dimensione e riusati, così la misura comprende solo l'operazione.
+ */
+class BenchmarkCollezione : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+
+    void loadCollection_data() { dimensioni(); }
+    void loadCollection();
+    void loadCollectionPigra_data() { dimensioni(); }
+    void loadCollectionPigra();
+    void saveCollection_data() { dimensioni(); }
+    void saveCollection();
+    void exportToCSV_data() { dimensioni(); }
+    void exportToCSV();
+    void salvataggioPigroRipetuto();
+
+    void searchMedia_data() { dimensioni(); }
+    void searchMedia();
+    void filterMedia_data() { dimensioni(); }
+    void filterMedia();
+    void filterMediaCache_data() { dimensioni(); }
+    void filterMediaCache();
+    void programmaFiltro_data() { dimensioni(); }
+    void programmaFiltro();
+    void filtroProfondo_data();
+    void filtroProfondo();
+    void findMedia_data() { dimensioni(); }
+    void findMedia();
+    void addMediaInBlocco_data() { dimensioni(); }
+    void addMediaInBlocco();
+
+    void costruzioneMediaCard_data();
+    void costruzioneMediaCard();
+
+private:
+    static void dimensioni();
+    Collezione& collezione(int dimensione);
+    QString fileCollezione(int dimensione);
+
+    QTemporaryDir m_cartella;
+    std::map<int, std::unique_ptr<Collezione>> m_collezioni;
+    std::map<int, QString> m_file;
+};
+
+void BenchmarkCollezione::initTestCase()
+{
+    QVERIFY(m_cartella.isValid());
+}
+
+void BenchmarkCollezione::loadCollection()
+{
+    QFETCH(int, dimensione);
+    QString file = fileCollezione(dimensione);
+
+    JsonManager manager;
+    manager.setCaricamentoPigro(false);
+    QBENCHMARK {
+        auto media = manager.loadCollection(file);
+        QCOMPARE(static_cast<int>(media.size()), dimensione);
+    }
+}
+
+void BenchmarkCollezione::loadCollectionPigra()
+{
+    QFETCH(int, dimensione);
+    QString file = fileCollezione(dimensione);
+
+    // Soglia zero: solo campi caldi, i campi freddi restano nel file
+    JsonManager manager;
+    manager.setCaricamentoPigro(true, 0);
+    QBENCHMARK {
+        auto media = manager.loadCollection(file);
+        QCOMPARE(static_cast<int>(media.size()), dimensione);
+    }
+}
+
+void BenchmarkCollezione::saveCollection()
+{
+    QFETCH(int, dimensione);
+    const auto& media = collezione(dimensione).getAllMedia();
+    QString file = m_cartella.filePath(QString("salvataggio_%1.json").arg(dimensione));
+
+    JsonManager manager;
+    QBENCHMARK {
+        QVERIFY(manager.saveCollection(media, file));
+    }
+}
+
+// Non una misura: salvare sul file da cui sono stati caricati in modo pigro non deve
+// perdere i campi freddi dei media mai aperti, nemmeno al secondo salvataggio
+void BenchmarkCollezione::salvataggioPigroRipetuto()
+{
+    QString file = m_cartella.filePath("salvataggio_pigro.json");
+    JsonManager manager;
+    QVERIFY(manager.saveCollection(creaCatalogo(30), file));
+
+    // Valori attesi letti senza caricamento pigro, prima di toccare il file
+    manager.setCaricamentoPigro(false);
+    std::map<QString, std::pair<QString, QStringList>> attesi;
+    for (const auto& media : manager.loadCollection(file)) {
+        const Film* film = dynamic_cast<const Film*>(media.get());
+        attesi[media->getId()] = {media->getDescrizione(), film ? film->getAttori() : QStringList()};
+    }
+
+    manager.setCaricamentoPigro(true, 0);
+    auto media = manager.loadCollection(file);
+    QCOMPARE(media.size(), attesi.size());
+    QVERIFY(media[1]->haCampiFreddiDaCaricare());
+
+    media[0]->setDescrizione("descrizione modificata");
+    attesi[media[0]->getId()].first = "descrizione modificata";
+    attesi.erase(media[2]->getId());
+    media.erase(media.begin() + 2);
+    media.push_back(std::make_unique<Film>("aggiunto", 2001, "descrizione aggiunta", "Sergio Leone",
+                                           QStringList{"Primo Levi"}, 90, Film::Azione, Film::G, "Adelphi"));
+    attesi[media.back()->getId()] = {"descrizione aggiunta", QStringList{"Primo Levi"}};
+
+    QVERIFY(manager.saveCollection(media, file));
+    QVERIFY(manager.saveCollection(media, file));
+
+    manager.setCaricamentoPigro(false);
+    auto ricaricati = manager.loadCollection(file);
+    QCOMPARE(ricaricati.size(), attesi.size());
+    for (const auto& ricaricato : ricaricati) {
+        auto atteso = attesi.find(ricaricato->getId());
+        QVERIFY(atteso != attesi.end());
+        QCOMPARE(ricaricato->getDescrizione(), atteso->second.first);
+        if (const Film* film = dynamic_cast<const Film*>(ricaricato.get())) {
+            QCOMPARE(film->getAttori(), atteso->second.second);
+        }
+    }
+}
+
+void BenchmarkCollezione::exportToCSV()
+{
+    QFETCH(int, dimensione);
+    const auto& media = collezione(dimensione).getAllMedia();
+    QString file = m_cartella.filePath(QString("esportazione_%1.csv").arg(dimensione));
+
+    JsonManager manager;
+    QBENCHMARK {
+        QVERIFY(manager.exportToCSV(media, file));
+    }
+}
+
+void BenchmarkCollezione::searchMedia()
+{
+    QFETCH(int, dimensione);
+    const Collezione& media = collezione(dimensione);
+
+    QBENCHMARK {
+        auto risultati = media.searchMedia("giardino");
+        Q_UNUSED(risultati);
+    }
+}
+
+void BenchmarkCollezione::filterMedia()
+{
+    QFETCH(int, dimensione);
+    const Collezione& media = collezione(dimensione);
+
+    // Stesso percorso di filterMedia (piano e programma) senza la cache dei filtri
+    QBENCHMARK {
+        PianoFiltro piano = media.pianificaFiltro(*FiltroFactory::createAutoreFiltro("Calvino"));
+        ProgrammaFiltro programma(*piano.filtro);
+        auto posizioni = piano.usaCandidati ? programma.seleziona(media.getAllMedia(), piano.candidati)
+                                            : programma.seleziona(media.getAllMedia());
+        Q_UNUSED(posizioni);
+    }
+}
+
+void BenchmarkCollezione::filterMediaCache()
+{
+    QFETCH(int, dimensione);
+    const Collezione& media = collezione(dimensione);
+
+    // Dalla seconda iterazione risponde la cache dei filtri: misura solo la ricerca della voce
+    QBENCHMARK {
+        auto risultati = media.filterMedia(FiltroFactory::createAutoreFiltro("Calvino"));
+        Q_UNUSED(risultati);
+    }
+}
+
+void BenchmarkCollezione::programmaFiltro()
+{
+    QFETCH(int, dimensione);
+    const auto& media = collezione(dimensione).getAllMedia();
+
+    // Valutazione senza cache: filtro composto compilato una volta e rieseguito
+    auto filtro = std::make_unique<FiltroComposto>(FiltroComposto::And);
+    filtro->addFiltro(FiltroFactory::createAnnoFiltro(1970, 2000));
+    filtro->addFiltro(FiltroFactory::createAutoreFiltro("Eco"));
+    ProgrammaFiltro programma(*filtro);
+
+    QBENCHMARK {
+        auto risultati = programma.filtra(media);
+        Q_UNUSED(risultati);
+    }
+}
+
+void BenchmarkCollezione::filtroProfondo_data()
+{
+    // Stesso filtro valutato come albero (FiltroStrategy::matches) e come programma compilato
+    QTest::addColumn<int>("dimensione");
+    QTest::addColumn<bool>("compilato");
+    for (int dimensione : {100, 1000, 10000}) {
+        QTest::newRow(QString("%1 albero").arg(dimensione).toUtf8().constData()) << dimensione << false;
+        QTest::newRow(QString("%1 programma").arg(dimensione).toUtf8().constData()) << dimensione << true;
+    }
+}
+
+void BenchmarkCollezione::filtroProfondo()
+{
+    QFETCH(int, dimensione);
+    QFETCH(bool, compilato);
+    const auto& media = collezione(dimensione).getAllMedia();
+
+    auto filtro = creaFiltroProfondo(LIVELLI_FILTRO_PROFONDO);
+
+    // Le due forme devono accettare gli stessi media prima di confrontarne i tempi
+    ProgrammaFiltro::Confronto confronto = ProgrammaFiltro::confronta(*filtro, media, 1);
+    QVERIFY(confronto.coincidono);
+
+    if (compilato) {
+        ProgrammaFiltro programma(*filtro);
+        QBENCHMARK {
+            auto risultati = programma.filtra(media);
+            Q_UNUSED(risultati);
+        }
+    } else {
+        QBENCHMARK {
+            std::vector<Media*> risultati;
+            for (const auto& elemento : media) {
+                if (filtro->matches(elemento.get())) {
+                    risultati.push_back(elemento.get());
+                }
+            }
+        }
+    }
+}
+
+void BenchmarkCollezione::findMedia()
+{
+    QFETCH(int, dimensione);
+    const Collezione& media = collezione(dimensione);
+
+    // Cento id distribuiti lungo tutta la collezione
+    QStringList id;
+    const auto& tutti = media.getAllMedia();
+    for (size_t i = 0; i < tutti.size(); i += std::max<size_t>(1, tutti.size() / 100)) {
+        id << tutti[i]->getId();
+    }
+
+    QBENCHMARK {
+        for (const QString& cercato : id) {
+            QVERIFY(media.findMedia(cercato) != nullptr);
+        }
+    }
+}
+
+void BenchmarkCollezione::addMediaInBlocco()
+{
+    QFETCH(int, dimensione);
+    auto catalogo = creaCatalogo(dimensione);
+
+    // I media vengono consumati: una sola misura per dimensione
+    QBENCHMARK_ONCE {
+        Collezione destinazione;
+        for (auto& media : catalogo) {
+            destinazione.addMedia(std::move(media));
+        }
+        QCOMPARE(static_cast<int>(destinazione.size()), dimensione);
+    }
+}
+
+void BenchmarkCollezione::costruzioneMediaCard_data()
+{
+    // Una card per media visibile: dimensioni di una o poche pagine di risultati
+    QTest::addColumn<int>("dimensione");
+    for (int dimensione : {10, 60, 300}) {
+        QTest::newRow(QByteArray::number(dimensione).constData()) << dimensione;
+    }
+}
+
+void BenchmarkCollezione::costruzioneMediaCard()
+{
+    QFETCH(int, dimensione);
+    const auto& media = collezione(dimensione).getAllMedia();
+
+    QBENCHMARK {
+        std::vector<std::unique_ptr<MediaCard>> card;
+        card.reserve(media.size());
+        for (const auto& elemento : media) {
+            card.push_back(std::make_unique<MediaCard>(elemento.get()));
+        }
+    }
+}
+
+// Private methods
+void BenchmarkCollezione::dimensioni()
+{
+    QTest::addColumn<int>("dimensione");
+    for (int dimensione : {100, 1000, 10000}) {
+        QTest::newRow(QByteArray::number(dimensione).constData()) << dimensione;
+    }
+}
+
+Collezione& BenchmarkCollezione::collezione(int dimensione)
+{
+    auto it = m_collezioni.find(dimensione);
+    if (it == m_collezioni.end()) {
+        auto nuova = std::make_unique<Collezione>();
+        for (auto& media : creaCatalogo(dimensione)) {
+            nuova->addMedia(std::move(media));
+        }
+        it = m_collezioni.emplace(dimensione, std::move(nuova)).first;
+    }
+    return *it->second;
+}
+
+QString BenchmarkCollezione::fileCollezione(int dimensione)
+{
+    auto it = m_file.find(dimensione);
+    if (it == m_file.end()) {
+        QString file = m_cartella.filePath(QString("collezione_%1.json").arg(dimensione));
+        JsonManager manager;
+        manager.saveCollection(collezione(dimensione).getAllMedia(), file);
+        it = m_file.emplace(dimensione, file).first;
+    }
+    return it->second;
+}
+
+int main(int argc, char* argv[])
+{
+    QApplication app(argc, argv);
+    BenchmarkCollezione benchmark;
+
+    // Risultati leggibili a macchina anche senza opzioni: csv su file, testo a video
+    QStringList argomenti = app.arguments();
+    if (!argomenti.contains("-o")) {
+        argomenti << "-o" << "benchmark.csv,csv" << "-o" << "-,txt";
+    }
+    return QTest::qExec(&benchmark, argomenti);
+}
+
+#include "benchmarkcollezione.moc"
@@ -0,0 +1,29 @@
+# Benchmark QtTest (QBENCHMARK) del modello, della persistenza JSON e delle card
+#
+# Compilati da ../biblioteca.pro (servono la libreria nucleo); poi
+# QT_QPA_PLATFORM=offscreen ./benchmarks
+# Senza l'opzione -o i risultati vanno anche in benchmark.csv (formato csv di QtTest),
+# da confrontare tra una versione e l'altra per individuare le regressioni.
+QT += core widgets testlib
+
+CONFIG += c++17 console testcase
+CONFIG -= app_bundle
+
+TARGET = benchmarks
+TEMPLATE = app
+
+include(../modello.pri)
+
+INCLUDEPATH += ../interfaccia
+
+SOURCES += benchmarkcollezione.cpp \
+           ../interfaccia/mediacard.cpp \
+           ../interfaccia/iconemedia.cpp
+
+HEADERS += ../interfaccia/mediacard.h \
+           ../interfaccia/iconemedia.h
+
+RESOURCES += ../resources.qrc
+
+DEFINES += QT_DEPRECATED_WARNINGS
+DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0x060000
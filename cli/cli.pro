@@ -0,0 +1,21 @@
+# Interfaccia a riga di comando per i lavori batch sul catalogo
+#
+# Compilata da ../biblioteca.pro insieme alla libreria nucleo; poi ./biblioteca-cli --help
+# Usa solo QtCore: gira su server e in pipeline senza display.
+QT = core
+
+CONFIG += c++17 console
+CONFIG -= app_bundle
+
+TARGET = biblioteca-cli
+TEMPLATE = app
+
+include(../modello.pri)
+
+SOURCES += main.cpp \
+           comandicli.cpp
+
+HEADERS += comandicli.h
+
+DEFINES += QT_DEPRECATED_WARNINGS
+DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0x060000
@@ -0,0 +1,446 @@
+#include "comandicli.h"
+#include "modello_logico/collezione.h"
+#include "modello_logico/cursoremedia.h"
+#include "modello_logico/filtrostrategy.h"
+#include "modello_logico/ordinamentomedia.h"
+#include "json/jsonmanager.h"
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonDocument>
+#include <algorithm>
+#include <cstdio>
+
+namespace {
+
+const QStringList TIPI = {"Libro", "Film", "Articolo"};
+
+// I campi di testo non devono spezzare le righe e le colonne del formato tabellare
+QString campoTabella(QString testo)
+{
+    testo.replace('\t', ' ');
+    testo.replace('\n', ' ');
+    testo.replace('\r', ' ');
+    return testo;
+}
+
+} // namespace
+
+ComandiCli::ComandiCli(QTextStream& uscita, QTextStream& errori)
+    : m_uscita(uscita)
+    , m_errori(errori)
+{
+}
+
+int ComandiCli::esegui(const QStringList& argomenti)
+{
+    if (argomenti.isEmpty() || argomenti.first() == "-h" || argomenti.first() == "--help"
+        || argomenti.first() == "help") {
+        (argomenti.isEmpty() ? m_errori : m_uscita) << getUso();
+        return argomenti.isEmpty() ? ErroreUso : Successo;
+    }
+
+    const QString comando = argomenti.first();
+    // QCommandLineParser si aspetta il nome del programma come primo argomento
+    QStringList resto = argomenti;
+    resto[0] = QString("biblioteca-cli %1").arg(comando);
+
+    try {
+        if (comando == "load") return load(resto);
+        if (comando == "query") return query(resto);
+        if (comando == "filter") return filter(resto);
+        if (comando == "validate") return validate(resto);
+        if (comando == "convert") return convert(resto);
+        if (comando == "export") return esporta(resto);
+    } catch (const std::exception& e) {
+        m_errori << "Errore: " << e.what() << "\n";
+        m_errori.flush();
+        return ErroreEsecuzione;
+    }
+
+    m_errori << "Sottocomando sconosciuto: " << comando << "\n\n" << getUso();
+    return ErroreUso;
+}
+
+QString ComandiCli::getUso()
+{
+    return QString(
+        "Uso: biblioteca-cli <sottocomando> [opzioni]\n"
+        "\n"
+        "Sottocomandi:\n"
+        "  load <file> [--memoria] [--formato testo|json]\n"
+        "      Carica la collezione e ne riassume il contenuto\n"
+        "  query <file> <query> [--formato tsv|json|id] [--limite N]\n"
+        "      Esegue una query testuale (es. \"tipo:libro anno:1990..2000 autore:eco\")\n"
+        "  filter <file> [--tipo T] [--anno-min A] [--anno-max A] [--autore X]\n"
+        "         [--regista X] [--rivista X] [--formato tsv|json|id] [--limite N]\n"
+        "      Applica i filtri indicati (in AND); \"=x\" corrispondenza esatta, \"x*\" prefisso\n"
+        "  validate <file> [--thread N]\n"
+        "      Controlla i media in parallelo; codice di uscita 3 se la collezione non è valida\n"
+        "      (gli avvisi, es. cifra di controllo dell'ISBN errata, non cambiano il codice)\n"
+        "  convert <ingresso> <uscita|-> [--compatto]\n"
+        "      Riscrive la collezione nel formato corrente, media per media\n"
+        "  export <ingresso> <uscita.csv>\n"
+        "      Esporta la collezione in CSV\n"
+        "\n"
+        "I risultati vanno su standard output, messaggi e riepiloghi su standard error.\n");
+}
+
+// Sottocomandi
+int ComandiCli::load(const QStringList& argomenti)
+{
+    QCommandLineParser parser;
+    parser.addPositionalArgument("file", "Collezione JSON");
+    parser.addOption(QCommandLineOption("memoria", "Stima della memoria per tipo e per campo"));
+    parser.addOption(QCommandLineOption("formato", "testo oppure json", "formato", "testo"));
+    if (!parser.parse(argomenti) || parser.positionalArguments().size() != 1) {
+        m_errori << (parser.errorText().isEmpty() ? QString("Indicare un file") : parser.errorText())
+                 << "\n";
+        return ErroreUso;
+    }
+
+    const QString formato = parser.value("formato");
+    if (formato != "testo" && formato != "json") {
+        m_errori << "Formato non valido: " << formato << "\n";
+        return ErroreUso;
+    }
+
+    Collezione collezione;
+    QElapsedTimer timer;
+    timer.start();
+    if (!carica(parser.positionalArguments().first(), collezione)) {
+        return ErroreEsecuzione;
+    }
+    const qint64 millisecondi = timer.elapsed();
+
+    if (formato == "json") {
+        QJsonObject riepilogo;
+        riepilogo["file"] = parser.positionalArguments().first();
+        riepilogo["numero_media"] = static_cast<qint64>(collezione.size());
+        QJsonObject perTipo;
+        for (const QString& tipo : TIPI) {
+            perTipo[tipo] = static_cast<qint64>(collezione.countByType(tipo));
+        }
+        riepilogo["per_tipo"] = perTipo;
+        riepilogo["millisecondi_caricamento"] = millisecondi;
+        if (parser.isSet("memoria")) {
+            riepilogo["memoria"] = collezione.getRapportoMemoria().toJson();
+        }
+        m_uscita << QJsonDocument(riepilogo).toJson(QJsonDocument::Indented);
+        return Successo;
+    }
+
+    m_uscita << "Media: " << collezione.size() << "\n";
+    for (const QString& tipo : TIPI) {
+        m_uscita << "  " << tipo << ": " << collezione.countByType(tipo) << "\n";
+    }
+    m_uscita << "Caricamento: " << millisecondi << " ms\n";
+    if (parser.isSet("memoria")) {
+        m_uscita << "\n" << collezione.getRapportoMemoria().toString();
+    }
+    return Successo;
+}
+
+int ComandiCli::query(const QStringList& argomenti)
+{
+    QCommandLineParser parser;
+    parser.addPositionalArgument("file", "Collezione JSON");
+    parser.addPositionalArgument("query", "Query testuale");
+    parser.addOption(QCommandLineOption("formato", "tsv, json oppure id", "formato", "tsv"));
+    parser.addOption(QCommandLineOption("limite", "Numero massimo di risultati", "numero", "0"));
+    if (!parser.parse(argomenti) || parser.positionalArguments().size() != 2) {
+        m_errori << (parser.errorText().isEmpty() ? QString("Indicare file e query") : parser.errorText())
+                 << "\n";
+        return ErroreUso;
+    }
+
+    Formato formato;
+    bool limiteValido = false;
+    const qulonglong limite = parser.value("limite").toULongLong(&limiteValido);
+    if (!leggiFormato(parser.value("formato"), formato) || !limiteValido) {
+        m_errori << "Opzioni non valide\n";
+        return ErroreUso;
+    }
+
+    Collezione collezione;
+    if (!carica(parser.positionalArguments().at(0), collezione)) {
+        return ErroreEsecuzione;
+    }
+
+    QString errore;
+    auto filtro = collezione.compilaQuery(parser.positionalArguments().at(1), &errore);
+    if (!filtro) {
+        m_errori << "Query non valida: " << errore << "\n";
+        return ErroreUso;
+    }
+
+    size_t scritti = scriviRisultati(collezione, std::move(filtro), formato, limite);
+    m_errori << scritti << " risultati\n";
+    return Successo;
+}
+
+int ComandiCli::filter(const QStringList& argomenti)
+{
+    QCommandLineParser parser;
+    parser.addPositionalArgument("file", "Collezione JSON");
+    parser.addOption(QCommandLineOption("tipo", "Libro, Film o Articolo", "tipo"));
+    parser.addOption(QCommandLineOption("anno-min", "Anno minimo", "anno"));
+    parser.addOption(QCommandLineOption("anno-max", "Anno massimo", "anno"));
+    parser.addOption(QCommandLineOption("autore", "Autore", "testo"));
+    parser.addOption(QCommandLineOption("regista", "Regista", "testo"));
+    parser.addOption(QCommandLineOption("rivista", "Rivista", "testo"));
+    parser.addOption(QCommandLineOption("formato", "tsv, json oppure id", "formato", "tsv"));
+    parser.addOption(QCommandLineOption("limite", "Numero massimo di risultati", "numero", "0"));
+    if (!parser.parse(argomenti) || parser.positionalArguments().size() != 1) {
+        m_errori << (parser.errorText().isEmpty() ? QString("Indicare un file") : parser.errorText())
+                 << "\n";
+        return ErroreUso;
+    }
+
+    Formato formato;
+    bool limiteValido = false;
+    const qulonglong limite = parser.value("limite").toULongLong(&limiteValido);
+    if (!leggiFormato(parser.value("formato"), formato) || !limiteValido) {
+        m_errori << "Opzioni non valide\n";
+        return ErroreUso;
+    }
+
+    auto filtro = std::make_unique<FiltroComposto>(FiltroComposto::And);
+    if (parser.isSet("tipo")) {
+        filtro->addFiltro(FiltroFactory::createTipoFiltro(parser.value("tipo")));
+    }
+    if (parser.isSet("anno-min") || parser.isSet("anno-max")) {
+        bool minimoValido = true;
+        bool massimoValido = true;
+        int annoMin = parser.isSet("anno-min") ? parser.value("anno-min").toInt(&minimoValido) : 0;
+        int annoMax = parser.isSet("anno-max") ? parser.value("anno-max").toInt(&massimoValido) : 9999;
+        if (!minimoValido || !massimoValido || annoMin > annoMax) {
+            m_errori << "Intervallo di anni non valido\n";
+            return ErroreUso;
+        }
+        filtro->addFiltro(FiltroFactory::createAnnoFiltro(annoMin, annoMax));
+    }
+    if (parser.isSet("autore")) {
+        QString testo = parser.value("autore");
+        auto modalita = FiltroFactory::modalitaDaTesto(testo);
+        filtro->addFiltro(FiltroFactory::createAutoreFiltro(testo, modalita));
+    }
+    if (parser.isSet("regista")) {
+        QString testo = parser.value("regista");
+        auto modalita = FiltroFactory::modalitaDaTesto(testo);
+        filtro->addFiltro(FiltroFactory::createRegistaFiltro(testo, modalita));
+    }
+    if (parser.isSet("rivista")) {
+        QString testo = parser.value("rivista");
+        auto modalita = FiltroFactory::modalitaDaTesto(testo);
+        filtro->addFiltro(FiltroFactory::createRivistaFiltro(testo, modalita));
+    }
+
+    Collezione collezione;
+    if (!carica(parser.positionalArguments().first(), collezione)) {
+        return ErroreEsecuzione;
+    }
+
+    // Nessun criterio: tutti i media
+    std::unique_ptr<FiltroStrategy> strategia;
+    if (filtro->size() > 0) {
+        strategia = std::move(filtro);
+    }
+
+    size_t scritti = scriviRisultati(collezione, std::move(strategia), formato, limite);
+    m_errori << scritti << " risultati\n";
+    return Successo;
+}
+
+int ComandiCli::validate(const QStringList& argomenti)
+{
+    QCommandLineParser parser;
+    parser.addPositionalArgument("file", "Collezione JSON");
+    parser.addOption(QCommandLineOption("thread", "Thread di validazione, 0 per uno per core", "numero", "0"));
+    if (!parser.parse(argomenti) || parser.positionalArguments().size() != 1) {
+        m_errori << (parser.errorText().isEmpty() ? QString("Indicare un file") : parser.errorText())
+                 << "\n";
+        return ErroreUso;
+    }
+
+    bool threadValido = false;
+    const int numeroThread = parser.value("thread").toInt(&threadValido);
+    if (!threadValido || numeroThread < 0) {
+        m_errori << "Opzioni non valide\n";
+        return ErroreUso;
+    }
+
+    Collezione collezione;
+    if (!carica(parser.positionalArguments().first(), collezione)) {
+        return ErroreEsecuzione;
+    }
+
+    const RapportoValidazione rapporto = collezione.valida(numeroThread);
+    for (const ProblemaValidazione& problema : rapporto.problemi) {
+        if (problema.gravita == ProblemaValidazione::Avviso) {
+            m_uscita << "Avviso: ";
+        }
+        m_uscita << problema.messaggio << "\n";
+    }
+
+    m_errori << rapporto.controllati << " media controllati, " << rapporto.errori << " errori, "
+             << rapporto.avvisi << " avvisi ("
+             << QString::number(static_cast<double>(rapporto.nsTotali) / 1e6, 'f', 1) << " ms, "
+             << rapporto.thread << " thread)\n";
+    return rapporto.isValido() ? Successo : CollezioneNonValida;
+}
+
+int ComandiCli::convert(const QStringList& argomenti)
+{
+    QCommandLineParser parser;
+    parser.addPositionalArgument("ingresso", "Collezione JSON");
+    parser.addPositionalArgument("uscita", "File di destinazione, - per lo standard output");
+    parser.addOption(QCommandLineOption("compatto", "JSON senza indentazione"));
+    if (!parser.parse(argomenti) || parser.positionalArguments().size() != 2) {
+        m_errori << (parser.errorText().isEmpty() ? QString("Indicare ingresso e uscita") : parser.errorText())
+                 << "\n";
+        return ErroreUso;
+    }
+
+    const QString ingresso = parser.positionalArguments().at(0);
+    const QString destinazione = parser.positionalArguments().at(1);
+
+    // I campi freddi del caricamento pigro vengono letti dal file d'ingresso
+    // durante la scrittura: sovrascriverlo corromperebbe le letture successive
+    QFileInfo infoIngresso(ingresso);
+    QFileInfo infoUscita(destinazione);
+    if (destinazione != "-" && infoUscita.exists()
+        && infoIngresso.canonicalFilePath() == infoUscita.canonicalFilePath()) {
+        m_errori << "Il file di uscita coincide con quello di ingresso\n";
+        return ErroreUso;
+    }
+
+    Collezione collezione;
+    if (!carica(ingresso, collezione)) {
+        return ErroreEsecuzione;
+    }
+
+    JsonManager manager;
+    const bool indentato = !parser.isSet("compatto");
+    bool riuscito = false;
+
+    if (destinazione == "-") {
+        m_uscita.flush();
+        QFile standardOutput;
+        if (!standardOutput.open(stdout, QIODevice::WriteOnly)) {
+            m_errori << "Impossibile scrivere sullo standard output\n";
+            return ErroreEsecuzione;
+        }
+        riuscito = manager.saveCollectionStream(collezione.getAllMedia(), standardOutput, indentato);
+    } else {
+        QFile file(destinazione);
+        if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+            m_errori << "Impossibile aprire il file: " << file.errorString() << "\n";
+            return ErroreEsecuzione;
+        }
+        riuscito = manager.saveCollectionStream(collezione.getAllMedia(), file, indentato);
+    }
+
+    if (!riuscito) {
+        m_errori << "Errore durante la scrittura: " << manager.getLastError() << "\n";
+        return ErroreEsecuzione;
+    }
+
+    m_errori << collezione.size() << " media scritti\n";
+    return Successo;
+}
+
+int ComandiCli::esporta(const QStringList& argomenti)
+{
+    QCommandLineParser parser;
+    parser.addPositionalArgument("ingresso", "Collezione JSON");
+    parser.addPositionalArgument("uscita", "File CSV");
+    if (!parser.parse(argomenti) || parser.positionalArguments().size() != 2) {
+        m_errori << (parser.errorText().isEmpty() ? QString("Indicare ingresso e uscita") : parser.errorText())
+                 << "\n";
+        return ErroreUso;
+    }
+
+    Collezione collezione;
+    if (!carica(parser.positionalArguments().at(0), collezione)) {
+        return ErroreEsecuzione;
+    }
+
+    JsonManager manager;
+    if (!manager.exportToCSV(collezione.getAllMedia(), parser.positionalArguments().at(1))) {
+        m_errori << "Errore durante l'esportazione: " << manager.getLastError() << "\n";
+        return ErroreEsecuzione;
+    }
+
+    m_errori << collezione.size() << " media esportati\n";
+    return Successo;
+}
+
+// Private methods
+bool ComandiCli::carica(const QString& filename, Collezione& collezione)
+{
+    if (!QFileInfo::exists(filename)) {
+        m_errori << "File non trovato: " << filename << "\n";
+        return false;
+    }
+    if (!collezione.loadFromFile(filename)) {
+        m_errori << "Impossibile caricare " << filename << ": " << collezione.getLastError() << "\n";
+        return false;
+    }
+    return true;
+}
+
+size_t ComandiCli::scriviRisultati(const Collezione& collezione, std::unique_ptr<FiltroStrategy> filtro,
+                                   Formato formato, size_t limite)
+{
+    // Pagina per pagina: con milioni di media non si raccoglie mai l'intero risultato
+    auto cursore = collezione.apriCursore(std::move(filtro));
+    size_t scritti = 0;
+
+    while (cursore->haAltri() && (limite == 0 || scritti < limite)) {
+        size_t dimensione = DIMENSIONE_PAGINA;
+        if (limite > 0) {
+            dimensione = std::min(dimensione, limite - scritti);
+        }
+        for (Media* media : cursore->prossimaPagina(dimensione)) {
+            scriviMedia(*media, formato);
+            ++scritti;
+        }
+        m_uscita.flush();
+    }
+    return scritti;
+}
+
+void ComandiCli::scriviMedia(const Media& media, Formato formato)
+{
+    switch (formato) {
+        case Tabella:
+            m_uscita << media.getId() << '\t'
+                     << media.getTypeDisplayName() << '\t'
+                     << media.getAnno() << '\t'
+                     << campoTabella(media.getTitolo()) << '\t'
+                     << campoTabella(OrdinamentoMedia::personaPrincipale(media)) << '\n';
+            break;
+        case JsonLinee:
+            m_uscita << QJsonDocument(media.toJson()).toJson(QJsonDocument::Compact) << '\n';
+            break;
+        case SoloId:
+            m_uscita << media.getId() << '\n';
+            break;
+    }
+}
+
+bool ComandiCli::leggiFormato(const QString& testo, Formato& formato)
+{
+    if (testo == "tsv") {
+        formato = Tabella;
+    } else if (testo == "json") {
+        formato = JsonLinee;
+    } else if (testo == "id") {
+        formato = SoloId;
+    } else {
+        return false;
+    }
+    return true;
+}
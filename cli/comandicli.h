@@ -0,0 +1,65 @@
+#ifndef COMANDICLI_H
+#define COMANDICLI_H
+
+#include <QString>
+#include <QStringList>
+#include <QTextStream>
+#include <memory>
+
+class Collezione;
+class FiltroStrategy;
+class Media;
+
+/**
+ * @brief Sottocomandi di biblioteca-cli
+ *
+ * Ogni sottocomando carica la collezione con Collezione (quindi con il
+ * caricamento pigro per i file grandi) e scrive i risultati su standard
+ * output man mano che il cursore li produce, senza raccoglierli prima.
+ * Diagnostica e riepiloghi vanno su standard error, così l'uscita resta
+ * utilizzabile in una pipeline.
+ */
+class ComandiCli
+{
+public:
+    enum CodiceUscita {
+        Successo = 0,
+        ErroreUso = 1,
+        ErroreEsecuzione = 2,
+        CollezioneNonValida = 3
+    };
+
+    ComandiCli(QTextStream& uscita, QTextStream& errori);
+
+    // Argomenti senza il nome del programma: <sottocomando> [opzioni] ...
+    int esegui(const QStringList& argomenti);
+
+    static QString getUso();
+
+private:
+    enum Formato {
+        Tabella,     // id, tipo, anno, titolo, persona principale separati da tabulazioni
+        JsonLinee,   // un oggetto JSON compatto per riga
+        SoloId
+    };
+
+    int load(const QStringList& argomenti);
+    int query(const QStringList& argomenti);
+    int filter(const QStringList& argomenti);
+    int validate(const QStringList& argomenti);
+    int convert(const QStringList& argomenti);
+    int esporta(const QStringList& argomenti);
+
+    bool carica(const QString& filename, Collezione& collezione);
+    size_t scriviRisultati(const Collezione& collezione, std::unique_ptr<FiltroStrategy> filtro,
+                           Formato formato, size_t limite);
+    void scriviMedia(const Media& media, Formato formato);
+    bool leggiFormato(const QString& testo, Formato& formato);
+
+    QTextStream& m_uscita;
+    QTextStream& m_errori;
+
+    static const size_t DIMENSIONE_PAGINA = 4096;
+};
+
+#endif
@@ -0,0 +1,23 @@
+#include <QCoreApplication>
+#include <QTextStream>
+#include <cstdio>
+#include "comandicli.h"
+
+int main(int argc, char *argv[])
+{
+    // Solo QtCore: niente widget, niente display, avvio immediato
+    QCoreApplication app(argc, argv);
+    app.setApplicationName("biblioteca-cli");
+    app.setApplicationVersion("1.0");
+    app.setOrganizationName("Library Systems");
+
+    QTextStream uscita(stdout);
+    QTextStream errori(stderr);
+
+    ComandiCli comandi(uscita, errori);
+    int codice = comandi.esegui(app.arguments().mid(1));
+
+    uscita.flush();
+    errori.flush();
+    return codice;
+}
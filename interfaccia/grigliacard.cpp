@@ -0,0 +1,118 @@
+#include "grigliacard.h"
+#include <QWidget>
+
+GrigliaCard::GrigliaCard(QWidget* parent, const QSize& cella)
+    : QLayout(parent)
+    , m_cella(cella)
+    , m_colonne(0)
+    , m_posizionati(0)
+{
+}
+
+GrigliaCard::~GrigliaCard()
+{
+    qDeleteAll(m_elementi);
+}
+
+void GrigliaCard::addItem(QLayoutItem* item)
+{
+    // In coda: le posizioni precedenti non cambiano
+    m_elementi.append(item);
+}
+
+int GrigliaCard::count() const
+{
+    return static_cast<int>(m_elementi.size());
+}
+
+QLayoutItem* GrigliaCard::itemAt(int index) const
+{
+    return index >= 0 && index < m_elementi.size() ? m_elementi.at(index) : nullptr;
+}
+
+QLayoutItem* GrigliaCard::takeAt(int index)
+{
+    if (index < 0 || index >= m_elementi.size()) {
+        return nullptr;
+    }
+    // Gli elementi successivi scalano di una cella
+    m_posizionati = qMin(m_posizionati, index);
+    return m_elementi.takeAt(index);
+}
+
+Qt::Orientations GrigliaCard::expandingDirections() const
+{
+    return {};
+}
+
+bool GrigliaCard::hasHeightForWidth() const
+{
+    return true;
+}
+
+int GrigliaCard::heightForWidth(int width) const
+{
+    const QMargins margini = contentsMargins();
+    const int colonne = colonnePerLarghezza(width - margini.left() - margini.right());
+    const int righe = (count() + colonne - 1) / colonne;
+    const int altezza = righe > 0 ? righe * m_cella.height() + (righe - 1) * spaziatura() : 0;
+    return altezza + margini.top() + margini.bottom();
+}
+
+QSize GrigliaCard::sizeHint() const
+{
+    return minimumSize();
+}
+
+QSize GrigliaCard::minimumSize() const
+{
+    // Almeno una colonna; l'altezza dipende dalla larghezza (heightForWidth)
+    const QMargins margini = contentsMargins();
+    return QSize(m_cella.width() + margini.left() + margini.right(),
+                 m_cella.height() + margini.top() + margini.bottom());
+}
+
+void GrigliaCard::setGeometry(const QRect& rect)
+{
+    QLayout::setGeometry(rect);
+
+    const QRect area = rect.marginsRemoved(contentsMargins());
+    const int colonne = colonnePerLarghezza(area.width());
+
+    // Le card sono allineate a sinistra: a parità di colonne e origine una
+    // larghezza diversa non sposta nulla
+    if (colonne != m_colonne || area.topLeft() != m_area.topLeft()) {
+        m_posizionati = 0;
+    }
+    m_area = area;
+    m_colonne = colonne;
+
+    for (int i = m_posizionati; i < m_elementi.size(); ++i) {
+        m_elementi[i]->setGeometry(cella(i, area));
+    }
+    m_posizionati = static_cast<int>(m_elementi.size());
+}
+
+void GrigliaCard::svuota()
+{
+    qDeleteAll(m_elementi);
+    m_elementi.clear();
+    m_posizionati = 0;
+    invalidate();
+}
+
+int GrigliaCard::colonnePerLarghezza(int width) const
+{
+    const int passo = m_cella.width() + spaziatura();
+    return qMax(1, (width + spaziatura()) / qMax(1, passo));
+}
+
+// Private methods
+QRect GrigliaCard::cella(int indice, const QRect& area) const
+{
+    const int riga = indice / m_colonne;
+    const int colonna = indice % m_colonne;
+    return QRect(area.x() + colonna * (m_cella.width() + spaziatura()),
+                 area.y() + riga * (m_cella.height() + spaziatura()),
+                 m_cella.width(), m_cella.height());
+}
@@ -0,0 +1,55 @@
+#ifndef GRIGLIACARD_H
+#define GRIGLIACARD_H
+
+#include <QLayout>
+#include <QList>
+#include <QRect>
+#include <QSize>
+
+/**
+ * @brief Layout a flusso per card di dimensione fissa
+ *
+ * Le posizioni si calcolano dall'indice: riga = i / colonne, colonna =
+ * i % colonne. Gli elementi restano nel layout anche quando il numero di
+ * colonne cambia (si spostano soltanto i widget), e finché area e colonne
+ * restano le stesse vengono posizionati solo gli elementi nuovi: aggiungere
+ * una pagina di card non sposta quelle già presenti.
+ */
+class GrigliaCard : public QLayout
+{
+public:
+    GrigliaCard(QWidget* parent, const QSize& cella);
+    ~GrigliaCard() override;
+
+    void addItem(QLayoutItem* item) override;
+    int count() const override;
+    QLayoutItem* itemAt(int index) const override;
+    QLayoutItem* takeAt(int index) override;
+
+    Qt::Orientations expandingDirections() const override;
+    bool hasHeightForWidth() const override;
+    int heightForWidth(int width) const override;
+    QSize sizeHint() const override;
+    QSize minimumSize() const override;
+    void setGeometry(const QRect& rect) override;
+
+    // Elimina tutti gli elementi in una volta; i widget restano a chi li possiede
+    void svuota();
+
+    int colonnePerLarghezza(int width) const;
+    int getColonne() const { return m_colonne; }
+
+private:
+    QRect cella(int indice, const QRect& area) const;
+    int spaziatura() const { return qMax(0, spacing()); }
+
+    QList<QLayoutItem*> m_elementi;
+    QSize m_cella;
+
+    // Stato dell'ultimo posizionamento: gli elementi prima di m_posizionati sono già al loro posto
+    QRect m_area;
+    int m_colonne;
+    int m_posizionati;
+};
+
+#endif
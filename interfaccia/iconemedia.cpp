@@ -0,0 +1,89 @@
+#include "iconemedia.h"
+#include "modello_logico/rapportomemoria.h"
+#include <QImageReader>
+
+QPixmap IconeMedia::pixmap(Media::TipoMedia tipo, int lato, qreal rapportoPixel)
+{
+    if (rapportoPixel <= 0) {
+        rapportoPixel = 1.0;
+    }
+
+    QHash<quint64, QPixmap>& icone = cache();
+    const quint64 voce = chiave(tipo, lato, rapportoPixel);
+    auto it = icone.constFind(voce);
+    if (it != icone.constEnd()) {
+        return it.value();
+    }
+
+    // Il PNG viene decodificato direttamente alla dimensione fisica richiesta
+    QImageReader lettore(percorso(tipo));
+    const int latoFisico = qRound(lato * rapportoPixel);
+    QSize dimensione = lettore.size();
+    if (dimensione.isValid()) {
+        lettore.setScaledSize(dimensione.scaled(latoFisico, latoFisico, Qt::KeepAspectRatio));
+    }
+
+    QPixmap risultato = QPixmap::fromImage(lettore.read());
+    if (!risultato.isNull()) {
+        risultato.setDevicePixelRatio(rapportoPixel);
+    }
+
+    // Anche un'icona mancante resta in cache: non si ritenta per ogni card
+    icone.insert(voce, risultato);
+    return risultato;
+}
+
+void IconeMedia::precarica(int lato, qreal rapportoPixel)
+{
+    for (Media::TipoMedia tipo : {Media::TipoMedia::Libro, Media::TipoMedia::Film,
+                                  Media::TipoMedia::Articolo}) {
+        pixmap(tipo, lato, rapportoPixel);
+    }
+}
+
+void IconeMedia::svuota()
+{
+    cache().clear();
+}
+
+int IconeMedia::size()
+{
+    return static_cast<int>(cache().size());
+}
+
+qint64 IconeMedia::byteOccupati()
+{
+    qint64 byte = RapportoMemoria::byteHash(cache().size(), sizeof(quint64) + sizeof(QPixmap));
+    for (const QPixmap& icona : cache()) {
+        byte += RapportoMemoria::byteAllocazione(static_cast<qint64>(icona.width()) * icona.height()
+                                                 * icona.depth() / 8);
+    }
+    return byte;
+}
+
+// Private methods
+QString IconeMedia::percorso(Media::TipoMedia tipo)
+{
+    switch (tipo) {
+        case Media::TipoMedia::Libro:
+            return ":/icons/libro.png";
+        case Media::TipoMedia::Film:
+            return ":/icons/film.png";
+        case Media::TipoMedia::Articolo:
+            return ":/icons/articolo.png";
+    }
+    return QString();
+}
+
+quint64 IconeMedia::chiave(Media::TipoMedia tipo, int lato, qreal rapportoPixel)
+{
+    // Rapporto in centesimi: 1.25 e 1.5 restano distinti
+    const quint64 centesimi = static_cast<quint64>(qRound(rapportoPixel * 100));
+    return (static_cast<quint64>(tipo) << 48) | (static_cast<quint64>(lato & 0xFFFF) << 32) | centesimi;
+}
+
+QHash<quint64, QPixmap>& IconeMedia::cache()
+{
+    static QHash<quint64, QPixmap> istanza;
+    return istanza;
+}
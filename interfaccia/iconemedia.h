@@ -0,0 +1,35 @@
+#ifndef ICONEMEDIA_H
+#define ICONEMEDIA_H
+
+#include "modello_logico/media.h"
+#include <QHash>
+#include <QPixmap>
+
+/**
+ * @brief Cache condivisa delle icone dei tipi di media, già scalate
+ *
+ * Ogni combinazione di tipo, lato (in pixel logici) e device pixel ratio
+ * viene decodificata dalle risorse e scalata una sola volta; le card ricevono
+ * copie condivise (implicit sharing) dello stesso QPixmap, senza decodifica
+ * né ridimensionamento. Va usata solo dal thread dell'interfaccia.
+ */
+class IconeMedia
+{
+public:
+    static QPixmap pixmap(Media::TipoMedia tipo, int lato, qreal rapportoPixel);
+
+    // Decodifica in anticipo le icone di tutti i tipi (es. all'avvio)
+    static void precarica(int lato, qreal rapportoPixel);
+    static void svuota();
+    static int size();
+
+    // Pixel decodificati delle icone in cache (vedi RapportoMemoria)
+    static qint64 byteOccupati();
+
+private:
+    static QString percorso(Media::TipoMedia tipo);
+    static quint64 chiave(Media::TipoMedia tipo, int lato, qreal rapportoPixel);
+    static QHash<quint64, QPixmap>& cache();
+};
+
+#endif
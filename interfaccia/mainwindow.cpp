@@ -1,7 +1,15 @@
 #include "mainwindow.h"
 #include "mediacard.h"
+#include "selezionecard.h"
+#include "grigliacard.h"
+#include "iconemedia.h"
 #include "modello_logico/collezione.h"
 #include "modello_logico/filtrostrategy.h"
+#include "modello_logico/risultatiricerca.h"
+#include "modello_logico/parserfiltri.h"
+#include "modello_logico/cursoremedia.h"
+#include "modello_logico/testocompresso.h"
+#include "modello_logico/traccia.h"
 #include "modello_logico/libro.h"
 #include "modello_logico/film.h"
 #include "modello_logico/articolo.h"
@@ -38,6 +46,8 @@
 #include <QFileInfo>
 #include <QRegularExpression>
 #include <QRegularExpressionValidator>
+#include <QElapsedTimer>
+#include <QSignalBlocker>
 
 MainWindow::MainWindow(QWidget *parent)
     : QMainWindow(parent)
@@ -50,6 +60,10 @@ MainWindow::MainWindow(QWidget *parent)
     , m_mediaScrollArea(nullptr)
     , m_mediaContainer(nullptr)
     , m_mediaLayout(nullptr)
+    , m_totaleCursore(0)
+    , m_pannelloPrestazioni(nullptr)
+    , m_prestazioniAction(nullptr)
+    , m_selezione(std::make_unique<SelezioneCard>(m_mediaCards))
     , m_editPanel(nullptr)
     , m_editContentContainer(nullptr)
     , m_editScrollArea(nullptr)
@@ -108,7 +122,14 @@ MainWindow::MainWindow(QWidget *parent)
     resize(1200, 800);
     
     try {
+        // Le descrizioni lunghe restano compresse in memoria (0 = disattivato);
+        // la soglia va impostata prima di caricare la collezione. Meno memoria
+        // in cambio di decompressioni nelle ricerche per sottostringa (vedi TestoCompresso)
+        TestoCompresso::setSoglia(QSettings().value("sogliaCompressioneDescrizioni",
+                                                    SOGLIA_COMPRESSIONE_DEFAULT).toInt());
+        
         setupUI();
+        MediaCard::precaricaIcone(devicePixelRatioF());
         
         // Connessioni con la collezione
         connect(m_collezione.get(), &Collezione::mediaAdded,
@@ -170,55 +191,17 @@ void MainWindow::closeEvent(QCloseEvent *event)
 
 void MainWindow::resizeEvent(QResizeEvent *event)
 {
+    // La griglia si riadatta da sola: cambia solo il numero di colonne e si spostano i widget
     QMainWindow::resizeEvent(event);
-    
-    // Timer per evitare troppi aggiornamenti durante il resize
-    static QTimer* resizeTimer = nullptr;
-    if (!resizeTimer) {
-        resizeTimer = new QTimer(this);
-        resizeTimer->setSingleShot(true);
-        resizeTimer->setInterval(100); // 100ms delay
-        connect(resizeTimer, &QTimer::timeout, [this]() {
-            updateLayout();
-        });
-    }
-    
-    resizeTimer->start();
 }
 
 void MainWindow::updateLayout()
 {
     if (!m_mediaLayout || !m_mediaScrollArea) return;
+    TRACCIA_INTERVALLO("interfaccia", "MainWindow::updateLayout");
     
-    // Calcola il numero di colonne in base alla larghezza disponibile
-    int containerWidth = m_mediaScrollArea->viewport()->width();
-    int cardWidthWithMargin = CARD_WIDTH + CARD_MARGIN;
-    int columns = qMax(1, (containerWidth - CARD_MARGIN) / cardWidthWithMargin);
-
-    for (MediaCard* card : m_mediaCards) {
-        if (card) {
-            m_mediaLayout->removeWidget(card);
-        }
-    }
-    
-    QLayoutItem* item;
-    while ((item = m_mediaLayout->takeAt(0)) != nullptr) {
-        delete item;
-    }
-    
-    // Riposiziona tutte le card nel layout
-    for (int i = 0; i < m_mediaCards.size(); ++i) {
-        MediaCard* card = m_mediaCards[i];
-        if (card) {
-            int row = i / columns;
-            int col = i % columns;
-            m_mediaLayout->addWidget(card, row, col);
-        }
-    }
-    
-    // Aggiungi stretch finale per spingere le card in alto
-    int totalRows = (m_mediaCards.size() + columns - 1) / columns;
-    m_mediaLayout->setRowStretch(totalRows, 1);
+    // GrigliaCard posiziona solo le card nuove; al resize sposta i widget da sola
+    m_mediaLayout->activate();
     
     // Forza un update del container
     m_mediaContainer->updateGeometry();
@@ -227,55 +210,102 @@ void MainWindow::updateLayout()
 
 void MainWindow::refreshMediaCards() {
     if (!m_mediaLayout) return;
+    TRACCIA_INTERVALLO("interfaccia", "MainWindow::refreshMediaCards");
     
     try {
         clearMediaCards();
+        m_risultatiRicerca.reset();
+        m_cursore.reset();
         
-        std::vector<Media*> media;
+        QElapsedTimer timer;
+        timer.start();
+        m_misura = MisuraOperazione();
+        m_misura.nome = "Aggiornamento";
         
-        // Applica ricerca
+        std::vector<Media*> media;
+
         QString searchText = m_searchEdit->text().trimmed();
+        auto filtro = creaFiltroCorrente();
+        auto criteri = criteriOrdinamento();
+
+        auto selezionaMedia = [&](std::unique_ptr<FiltroStrategy> selezione) {
+            if (criteri.empty()) {
+                // Si scorre la collezione solo per la prima pagina; il totale è un semplice conteggio
+                m_totaleCursore = m_collezione->contaMedia(selezione ? selezione->clone() : nullptr);
+                m_cursore = m_collezione->apriCursore(std::move(selezione));
+                media = m_cursore->prossimaPagina(PAGINA_RISULTATI);
+                m_misura.esaminati = static_cast<qint64>(m_cursore->getEsaminati());
+            } else if (selezione) {
+                // Il pianificatore sceglie ordine di valutazione e indici
+                media = m_collezione->filterMedia(std::move(selezione));
+                m_misura.esaminati = static_cast<qint64>(m_collezione->getEsaminatiUltimoFiltro());
+            } else {
+                const auto& allMedia = m_collezione->getAllMedia();
+                for (const auto& m : allMedia) {
+                    media.push_back(m.get());
+                }
+                m_misura.esaminati = static_cast<qint64>(allMedia.size());
+            }
+        };
+
         if (searchText.isEmpty()) {
-            const auto& allMedia = m_collezione->getAllMedia();
-            for (const auto& m : allMedia) {
-                media.push_back(m.get());
+            selezionaMedia(std::move(filtro));
+        } else if (ParserFiltri::isQuery(searchText)) {
+            // Linguaggio di interrogazione: la query si combina in AND con i filtri laterali
+            QString errore;
+            auto query = m_collezione->compilaQuery(searchText, &errore);
+            if (query) {
+                auto combinato = std::make_unique<FiltroComposto>();
+                combinato->addFiltro(std::move(query));
+                if (filtro) {
+                    combinato->addFiltro(std::move(filtro));
+                }
+                selezionaMedia(std::move(combinato));
+            } else {
+                mostraInfo(QString("Query non valida: %1").arg(errore));
+            }
+        } else if (m_fuzzyCheck->isChecked()) {
+            // Senza filtri laterali né ordinamento bastano i migliori risultati: una parola
+            // corta ne trova moltissimi, e anche così si mostra solo la prima pagina
+            size_t massimo = (filtro || !criteri.empty()) ? 0 : MASSIMO_RISULTATI_APPROSSIMATI;
+            m_risultatiRicerca = std::make_unique<RisultatiRicerca>(
+                m_collezione->cercaApprossimata(searchText, massimo));
+            if (filtro) {
+                PianoFiltro piano = m_collezione->pianificaFiltro(*filtro);
+                m_risultatiRicerca->filtra(*piano.filtro);
             }
+            media = criteri.empty() ? m_risultatiRicerca->pagina(0, PAGINA_RISULTATI)
+                                    : m_risultatiRicerca->intervallo(0, m_risultatiRicerca->totale());
         } else {
-            media = m_collezione->searchMedia(searchText);
-        }
-        
-        // Applica filtri
-        auto filtro = creaFiltroCorrente();
-        if (filtro) {
-            std::vector<Media*> filteredMedia;
-            for (Media* m : media) {
-                if (filtro->matches(m)) {
-                    filteredMedia.push_back(m);
-                }
+            // Risultati per rilevanza: si mostra solo la prima pagina
+            m_risultatiRicerca = std::make_unique<RisultatiRicerca>(
+                m_collezione->cercaPerRilevanza(searchText));
+            if (filtro) {
+                PianoFiltro piano = m_collezione->pianificaFiltro(*filtro);
+                m_risultatiRicerca->filtra(*piano.filtro);
             }
-            media = filteredMedia;
+            // Con un ordinamento esplicito servono tutti i risultati; la rilevanza decide le parità
+            media = criteri.empty() ? m_risultatiRicerca->pagina(0, PAGINA_RISULTATI)
+                                    : m_risultatiRicerca->intervallo(0, m_risultatiRicerca->totale());
         }
         
-        // Crea nuove card per tutti i media
-        for (Media* mediaPtr : media) {
-            if (mediaPtr) {
-                try {
-                    MediaCard* card = new MediaCard(mediaPtr, m_mediaContainer);
-                    m_mediaCards.push_back(card);
-                    
-                    // Connessioni per selezione
-                    connect(card, &MediaCard::selezionato,
-                            this, &MainWindow::onCardSelezionata);
-                    connect(card, &MediaCard::doppioClick,
-                            this, &MainWindow::onCardDoubleClic);
-                    
-                } catch (const std::exception& e) {
-                    qWarning() << "Errore nella creazione MediaCard:" << e.what();
-                }
-            }
+        if (!criteri.empty()) {
+            // Si ordinano tutti i risultati ma si creano le card della sola prima pagina
+            m_collezione->ordina(media, criteri);
+            m_risultatiRicerca = std::make_unique<RisultatiRicerca>(RisultatiRicerca::inOrdine(std::move(media)));
+            media = m_risultatiRicerca->pagina(0, PAGINA_RISULTATI);
         }
+        m_misura.nsQuery = timer.nsecsElapsed();
+        m_misura.corrispondenti = static_cast<qint64>(
+            m_risultatiRicerca ? m_risultatiRicerca->totale()
+                               : (m_cursore ? m_totaleCursore : media.size()));
+        aggiungiCards(media);
         
+        timer.restart();
         updateLayout();
+        m_misura.nsLayout = timer.nsecsElapsed();
+        m_pannelloPrestazioni->registra(m_misura);
+        
         aggiornaStatistiche();
         
     } catch (const std::exception& e) {
@@ -283,23 +313,87 @@ void MainWindow::refreshMediaCards() {
     }
 }
 
+void MainWindow::aggiungiCards(const std::vector<Media*>& media)
+{
+    TRACCIA_INTERVALLO("interfaccia", "MainWindow::aggiungiCards");
+    TRACCIA_CONTATORE("interfaccia", "card create", media.size());
+    for (Media* mediaPtr : media) {
+        if (mediaPtr) {
+            try {
+                MediaCard* card = new MediaCard(mediaPtr, m_mediaContainer);
+                m_mediaLayout->addWidget(card);
+                m_mediaCards.push_back(card);
+                m_selezione->registra(card, m_mediaCards.size() - 1);
+                ++m_misura.cardCreate;
+                
+                // Connessioni per selezione
+                connect(card, &MediaCard::selezionato,
+                        this, &MainWindow::onCardSelezionata);
+                connect(card, &MediaCard::doppioClick,
+                        this, &MainWindow::onCardDoubleClic);
+                
+            } catch (const std::exception& e) {
+                qWarning() << "Errore nella creazione MediaCard:" << e.what();
+            }
+        }
+    }
+    
+    size_t totale = m_risultatiRicerca ? m_risultatiRicerca->totale() : m_totaleCursore;
+    bool altri = (m_risultatiRicerca && static_cast<size_t>(m_mediaCards.size()) < totale) ||
+                 (m_cursore && m_cursore->haAltri());
+    m_altriRisultatiButton->setVisible(altri);
+    if (altri) {
+        m_altriRisultatiButton->setText(QString("Mostra altri (%1 di %2)")
+                                        .arg(m_mediaCards.size())
+                                        .arg(totale));
+    }
+}
+
+void MainWindow::mostraAltriRisultati()
+{
+    if (!m_risultatiRicerca && !m_cursore) return;
+    
+    try {
+        QElapsedTimer timer;
+        timer.start();
+        m_misura = MisuraOperazione();
+        m_misura.nome = "Altri risultati";
+        
+        std::vector<Media*> pagina;
+        if (m_cursore) {
+            size_t esaminatiPrima = m_cursore->getEsaminati();
+            pagina = m_cursore->prossimaPagina(PAGINA_RISULTATI);
+            m_misura.esaminati = static_cast<qint64>(m_cursore->getEsaminati() - esaminatiPrima);
+        } else {
+            pagina = m_risultatiRicerca->intervallo(m_mediaCards.size(), PAGINA_RISULTATI);
+        }
+        m_misura.nsQuery = timer.nsecsElapsed();
+        m_misura.corrispondenti = static_cast<qint64>(pagina.size());
+        aggiungiCards(pagina);
+        
+        timer.restart();
+        updateLayout();
+        m_misura.nsLayout = timer.nsecsElapsed();
+        m_pannelloPrestazioni->registra(m_misura);
+    } catch (const std::exception& e) {
+        mostraErrore(QString("Errore nella ricerca: %1").arg(e.what()));
+    }
+}
+
 void MainWindow::clearMediaCards()
 {
     for (MediaCard* card : m_mediaCards) {
         if (card) {
             disconnect(card, nullptr, this, nullptr);
-            m_mediaLayout->removeWidget(card);
             card->deleteLater();
         }
     }
     
     m_mediaCards.clear();
+    m_selezione->azzera();
     
-    // Rimuovi eventuali elementi residui dal layout
-    QLayoutItem* item;
-    while ((item = m_mediaLayout->takeAt(0)) != nullptr) {
-        delete item;
-    }
+    // Tutti gli elementi del layout in una volta (removeWidget cercherebbe ogni card)
+    m_mediaLayout->svuota();
     
     m_selezionato_id.clear();
     aggiornaStatoBottoni();
@@ -310,6 +404,24 @@ void MainWindow::applicaRicercaCorrente()
     refreshMediaCards();
 }
 
+std::vector<CriterioOrdinamento> MainWindow::criteriOrdinamento() const
+{
+    // Ogni voce ha chiavi secondarie per dare un ordine deterministico alle parità
+    switch (m_ordinamentoCombo->currentIndex()) {
+        case 1:
+            return {{CriterioOrdinamento::Titolo, true}, {CriterioOrdinamento::Anno, false}};
+        case 2:
+            return {{CriterioOrdinamento::Anno, false}, {CriterioOrdinamento::Titolo, true}};
+        case 3:
+            return {{CriterioOrdinamento::Persona, true}, {CriterioOrdinamento::Anno, true},
+                    {CriterioOrdinamento::Titolo, true}};
+        case 4:
+            return {{CriterioOrdinamento::Tipo, true}, {CriterioOrdinamento::Titolo, true}};
+        default:
+            return {};
+    }
+}
+
 std::unique_ptr<FiltroStrategy> MainWindow::creaFiltroCorrente()
 {
     auto filtroComposto = std::make_unique<FiltroComposto>();
@@ -329,19 +441,25 @@ std::unique_ptr<FiltroStrategy> MainWindow::creaFiltroCorrente()
         hasFiltri = true;
     }
     
-    // Filtri per campi specifici
+    // Filtri per campi specifici ("=valore" esatto, "valore*" prefisso)
     if (!m_autoreEdit->text().isEmpty()) {
-        filtroComposto->addFiltro(FiltroFactory::createAutoreFiltro(m_autoreEdit->text()));
+        QString autore = m_autoreEdit->text();
+        auto modalita = FiltroFactory::modalitaDaTesto(autore);
+        filtroComposto->addFiltro(FiltroFactory::createAutoreFiltro(autore, modalita));
         hasFiltri = true;
     }
     
     if (!m_registaEdit->text().isEmpty()) {
-        filtroComposto->addFiltro(FiltroFactory::createRegistaFiltro(m_registaEdit->text()));
+        QString regista = m_registaEdit->text();
+        auto modalita = FiltroFactory::modalitaDaTesto(regista);
+        filtroComposto->addFiltro(FiltroFactory::createRegistaFiltro(regista, modalita));
         hasFiltri = true;
     }
     
     if (!m_rivistaEdit->text().isEmpty()) {
-        filtroComposto->addFiltro(FiltroFactory::createRivistaFiltro(m_rivistaEdit->text()));
+        QString rivista = m_rivistaEdit->text();
+        auto modalita = FiltroFactory::modalitaDaTesto(rivista);
+        filtroComposto->addFiltro(FiltroFactory::createRivistaFiltro(rivista, modalita));
         hasFiltri = true;
     }
     
@@ -452,10 +570,8 @@ void MainWindow::modificaMedia()
         m_editingMediaId = m_selezionato_id;
         showEditPanel(false, false);
         
-        // Carica i dati dopo aver mostrato il pannello
-        QTimer::singleShot(100, [this, media]() {
-            loadEditMediaData(media);
-        });
+        // I form sono già pronti: i dati si caricano subito
+        loadEditMediaData(media);
         
     } catch (const std::exception& e) {
         mostraErrore(QString("Errore nella modifica: %1").arg(e.what()));
@@ -465,6 +581,11 @@ void MainWindow::modificaMedia()
 void MainWindow::rimuoviMedia()
 {
     try {
+        if (m_selezione->size() > 1) {
+            rimuoviSelezionati();
+            return;
+        }
+        
         if (m_selezionato_id.isEmpty()) {
             mostraInfo("Seleziona un media da rimuovere");
             return;
@@ -518,6 +639,44 @@ void MainWindow::rimuoviMedia()
     }
 }
 
+void MainWindow::rimuoviSelezionati()
+{
+    QStringList selezionati = m_selezione->getSelezionati();
+    
+    QMessageBox msgBox(this);
+    msgBox.setWindowTitle("Conferma Rimozione");
+    msgBox.setText(QString("Sei sicuro di voler rimuovere i %1 media selezionati?\n\n"
+                           "Questa azione non può essere annullata.").arg(selezionati.size()));
+    msgBox.setIcon(QMessageBox::Question);
+    msgBox.setStandardButtons(QMessageBox::Yes | QMessageBox::No);
+    msgBox.setDefaultButton(QMessageBox::No);
+    
+    msgBox.button(QMessageBox::Yes)->setText("Sì");
+    msgBox.button(QMessageBox::No)->setText("No");
+    
+    if (msgBox.exec() != QMessageBox::Yes) return;
+    
+    int rimossi = 0;
+    {
+        // Una sola ricostruzione della griglia alla fine, non una per media
+        QSignalBlocker blocco(m_collezione.get());
+        for (const QString& id : selezionati) {
+            if (m_collezione->removeMedia(id)) {
+                ++rimossi;
+            }
+        }
+    }
+    
+    m_selezionato_id.clear();
+    if (rimossi > 0) {
+        m_modificato = true;
+    }
+    aggiornaStatusBar();
+    refreshMediaCards();
+    
+    mostraInfo(QString("%1 media rimossi").arg(rimossi));
+}
+
 void MainWindow::visualizzaDettagli()
 {
     try {
@@ -537,10 +696,8 @@ void MainWindow::visualizzaDettagli()
         m_editingMediaId = m_selezionato_id;
         showEditPanel(false, true);
         
-        // Carica i dati dopo aver mostrato il pannello
-        QTimer::singleShot(100, [this, media]() {
-            loadEditMediaData(media);
-        });
+        // I form sono già pronti: i dati si caricano subito
+        loadEditMediaData(media);
         
     } catch (const std::exception& e) {
         mostraErrore(QString("Errore nella visualizzazione: %1").arg(e.what()));
@@ -607,24 +764,11 @@ void MainWindow::onCollezioneCaricata(int count)
 }
 
 // Gestione card
-void MainWindow::onCardSelezionata(const QString& id)
+void MainWindow::onCardSelezionata(const QString& id, Qt::KeyboardModifiers modificatori)
 {
-    m_selezionato_id = id;
-    
-    // Deseleziona altre card
-    for (MediaCard* card : m_mediaCards) {
-        if (card && card->getId() != id) {
-            card->setSelected(false);
-        }
-    }
-    
-    // Trova e seleziona la card corretta
-    for (MediaCard* card : m_mediaCards) {
-        if (card && card->getId() == id) {
-            card->setSelected(true);
-            break;
-        }
-    }
+    // Il modello tocca solo le card che cambiano stato
+    m_selezione->seleziona(id, modificatori);
+    m_selezionato_id = m_selezione->getCorrente();
     
     aggiornaStatoBottoni();
 }
@@ -637,6 +781,7 @@ void MainWindow::onCardDoubleClic(const QString& id)
             return;
         }
         
+        m_selezione->seleziona(id);
         m_selezionato_id = id;
         aggiornaStatoBottoni();
         
@@ -650,9 +795,14 @@ void MainWindow::onCardDoubleClic(const QString& id)
 void MainWindow::aggiornaStatoBottoni()
 {
     bool hasSelection = !m_selezionato_id.isEmpty();
+    int selezionati = m_selezione->size();
     
-    if (m_editButton) m_editButton->setEnabled(hasSelection);
-    if (m_removeButton) m_removeButton->setEnabled(hasSelection);
+    // Modifica e dettagli agiscono sul media corrente, la rimozione su tutta la selezione
+    if (m_editButton) m_editButton->setEnabled(hasSelection && selezionati <= 1);
+    if (m_removeButton) {
+        m_removeButton->setEnabled(hasSelection || selezionati > 0);
+        m_removeButton->setText(selezionati > 1 ? QString("Rimuovi (%1)").arg(selezionati) : QString("Rimuovi"));
+    }
     if (m_detailsButton) m_detailsButton->setEnabled(hasSelection);
 }
 
@@ -668,11 +818,68 @@ void MainWindow::aggiornaStatistiche()
         m_libriLabel->setText(QString("Libri: %1").arg(libri));
         m_filmLabel->setText(QString("Film: %1").arg(film));
         m_articoliLabel->setText(QString("Articoli: %1").arg(articoli));
+        
+        TestoCompresso::Statistiche compressione = TestoCompresso::getStatistiche();
+        m_totalLabel->setToolTip(compressione.testiCompressi > 0
+            ? QString("Descrizioni compresse: %1\nMemoria risparmiata: %2 KB")
+                  .arg(compressione.testiCompressi)
+                  .arg(compressione.byteRisparmiati() / 1024)
+            : QString());
     } catch (const std::exception& e) {
         qWarning() << "Errore nell'aggiornamento statistiche:" << e.what();
     }
 }
 
+void MainWindow::mostraRapportoMemoria()
+{
+    RapportoMemoria rapporto = m_collezione->getRapportoMemoria();
+    rapporto.aggiungiContenitore("icone dei media", IconeMedia::byteOccupati());
+    
+    QStringList riepilogo;
+    riepilogo << QString("Memoria stimata: %1").arg(RapportoMemoria::formattaByte(rapporto.getTotale()));
+    for (const QString& tipo : rapporto.getTipi()) {
+        riepilogo << QString("%1: %2 media, %3")
+                         .arg(tipo)
+                         .arg(rapporto.getNumeroMedia(tipo))
+                         .arg(RapportoMemoria::formattaByte(rapporto.getTotaleTipo(tipo)));
+    }
+    
+    QMessageBox box(this);
+    box.setWindowTitle("Memoria della collezione");
+    box.setIcon(QMessageBox::Information);
+    box.setText(riepilogo.join('\n'));
+    box.setDetailedText(rapporto.toString());
+    box.exec();
+}
+
+void MainWindow::attivaTraccia(bool attiva)
+{
+    if (attiva) {
+        Traccia::avvia();
+        m_statusLabel->setText("Traccia in registrazione");
+        return;
+    }
+    
+    Traccia::ferma();
+    QString fileName = QFileDialog::getSaveFileName(this,
+        "Salva traccia", "traccia.json", "Chrome trace (*.json)");
+    if (fileName.isEmpty()) {
+        aggiornaStatusBar();
+        return;
+    }
+    
+    if (Traccia::salva(fileName)) {
+        QString messaggio = QString("Traccia salvata: %1 eventi").arg(Traccia::getNumeroEventi());
+        if (Traccia::getEventiPersi() > 0) {
+            messaggio += QString(" (%1 persi: buffer pieno)").arg(Traccia::getEventiPersi());
+        }
+        mostraInfo(messaggio);
+    } else {
+        mostraErrore("Impossibile salvare la traccia: " + fileName);
+    }
+    aggiornaStatusBar();
+}
+
 void MainWindow::aggiornaStatusBar()
 {
     try {
@@ -692,6 +899,8 @@ void MainWindow::salvaImpostazioni()
         QSettings settings;
         settings.setValue("geometria", saveGeometry());
         settings.setValue("splitter", m_splitter->saveState());
+        settings.setValue("ordinamento", m_ordinamentoCombo->currentIndex());
+        settings.setValue("pannelloPrestazioni", m_prestazioniAction->isChecked());
     } catch (const std::exception& e) {
         qWarning() << "Errore nel salvataggio impostazioni:" << e.what();
     }
@@ -703,6 +912,8 @@ void MainWindow::caricaImpostazioni()
         QSettings settings;
         restoreGeometry(settings.value("geometria").toByteArray());
         m_splitter->restoreState(settings.value("splitter").toByteArray());
+        m_ordinamentoCombo->setCurrentIndex(settings.value("ordinamento", 0).toInt());
+        m_prestazioniAction->setChecked(settings.value("pannelloPrestazioni", false).toBool());
     } catch (const std::exception& e) {
         qWarning() << "Errore nel caricamento impostazioni:" << e.what();
     }
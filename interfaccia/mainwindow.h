@@ -2,6 +2,7 @@
 #define MAINWINDOW_H
 
 #include <QMainWindow>
+#include <QAction>
 #include <QVBoxLayout>
 #include <QHBoxLayout>
 #include <QGridLayout>
@@ -24,6 +25,7 @@
 #include <QTimer>
 #include <QMessageBox>
 #include <QDate>
+#include "pannelloprestazioni.h"
 #include <vector>
 #include <memory>
 
@@ -31,6 +33,11 @@ class Collezione;
 class Media;
 class MediaCard;
 class FiltroStrategy;
+class RisultatiRicerca;
+class CursoreMedia;
+class SelezioneCard;
+class GrigliaCard;
+struct CriterioOrdinamento;
 
 /**
  * @brief Finestra principale dell'applicazione
@@ -59,11 +66,13 @@ private slots:
     // Gestione media
     void aggiungiMedia();
     void rimuoviMedia();
+    void rimuoviSelezionati();
     void modificaMedia();
     void visualizzaDettagli();
     
     // Ricerca e filtri
     void cercaMedia();
+    void mostraAltriRisultati();
     void applicaFiltri();
     void resetFiltri();
     
@@ -74,7 +83,7 @@ private slots:
     void onCollezioneCaricata(int count);
     
     // Gestione card
-    void onCardSelezionata(const QString& id);
+    void onCardSelezionata(const QString& id, Qt::KeyboardModifiers modificatori);
     void onCardDoubleClic(const QString& id);
 
     // Slots per il pannello integrato
@@ -101,18 +110,17 @@ public:
     void setupFilterArea();
     void setupMediaArea();
     void setupEditPanel();
+    void collegaCompletamento(QLineEdit* campo, const QString& nomeCampo);
     
     // Metodi per il pannello edit (chiamati da editpanel.cpp)
     void setupEditBaseForm();
     void setupEditLibroForm();
     void setupEditFilmForm();
     void setupEditArticoloForm();
-    void clearEditSpecificForm();
-    void setupEditTypeSpecificForm();
     void setupEditConnections();
     void setupEditSpecificConnections();
-    void disconnectEditGroupWidgets(QGroupBox* group);
-    void resetEditSpecificPointers();
+    void showEditTypeSpecificForm(const QString& tipo);
+    void resetEditTypeSpecificForm(const QString& tipo);
     void resetEditPanelState();
     
     // Gestione dati pannello edit
@@ -136,13 +144,17 @@ private:
     void updateLayout();
     void refreshMediaCards();
     void clearMediaCards();
+    void aggiungiCards(const std::vector<Media*>& media);
     
     // Filtri e ricerca
     void applicaRicercaCorrente();
     std::unique_ptr<FiltroStrategy> creaFiltroCorrente();
+    std::vector<CriterioOrdinamento> criteriOrdinamento() const;
     
     // Utility
     void aggiornaStatistiche();
+    void mostraRapportoMemoria();
+    void attivaTraccia(bool attiva);
     void aggiornaStatusBar();
     void aggiornaStatoBottoni();
     void salvaImpostazioni();
@@ -166,12 +178,23 @@ public:
     QWidget* m_filterWidget;
     QScrollArea* m_mediaScrollArea;
     QWidget* m_mediaContainer;
-    QGridLayout* m_mediaLayout;
+    GrigliaCard* m_mediaLayout;
     
     // Area filtri
     QGroupBox* m_searchGroup;
     QLineEdit* m_searchEdit;
     QPushButton* m_clearSearchButton;
+    QCheckBox* m_fuzzyCheck;
+    QComboBox* m_ordinamentoCombo;
+    QTimer* m_searchTimer;
+    QPushButton* m_altriRisultatiButton;
+    
+    // Ricerca per rilevanza corrente, paginata senza ricalcolare i punteggi
+    std::unique_ptr<RisultatiRicerca> m_risultatiRicerca;
+    
+    // Senza ricerca testuale né ordinamento le card arrivano a pagine da un cursore
+    std::unique_ptr<CursoreMedia> m_cursore;
+    size_t m_totaleCursore;
     
     QGroupBox* m_filterGroup;
     QComboBox* m_tipoCombo;
@@ -199,9 +222,17 @@ public:
     // Status bar
     QLabel* m_statusLabel;
     QProgressBar* m_progressBar;
+    PannelloPrestazioni* m_pannelloPrestazioni;
+    QAction* m_prestazioniAction;
+    
+    // Misure dell'aggiornamento in corso, passate al pannello alla fine
+    MisuraOperazione m_misura;
     
     QList<MediaCard*> m_mediaCards;
     
+    // Selezione (anche multipla) delle card; m_selezionato_id ne segue il media corrente
+    std::unique_ptr<SelezioneCard> m_selezione;
+    
     // Pannello di modifica integrato
     QWidget* m_editPanel;
     QWidget* m_editContentContainer;
@@ -272,6 +303,9 @@ public:
     static const int CARD_WIDTH = 280;
     static const int CARD_HEIGHT = 200;
     static const int CARD_MARGIN = 10;
+    static const int PAGINA_RISULTATI = 60;
+    static const int MASSIMO_RISULTATI_APPROSSIMATI = 2000;
+    static const int SOGLIA_COMPRESSIONE_DEFAULT = 512;
     static const int FILTER_WIDTH = 270;
     
     // Dimensioni dei componenti filtri
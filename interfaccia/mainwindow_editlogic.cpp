@@ -5,6 +5,7 @@
 #include "modello_logico/articolo.h"
 #include <QApplication>
 #include <QMessageBox>
+#include <QSignalBlocker>
 #include <QTimer>
 #include <QDebug>
 #include <QDate>
@@ -58,7 +59,6 @@ void MainWindow::showEditPanel(bool isNew, bool readOnly)
         }
         
         if (isNew) {
-            clearEditSpecificForm();
             if (m_editTipoCombo) {
                 m_editTipoCombo->blockSignals(true);
                 m_editTipoCombo->setCurrentIndex(0);
@@ -82,37 +82,16 @@ void MainWindow::showEditPanel(bool isNew, bool readOnly)
                 m_editDescrizioneEdit->blockSignals(false);
             }
             
-            // Trigger cambio tipo
-            QTimer::singleShot(10, this, [this, readOnly]() {
-                onEditTipoChanged();
-                
-                QTimer::singleShot(800, this, [this, readOnly]() {
-                    if (!readOnly) {
-                        m_editValidationEnabled = true;
-                        enableEditForm(true);
-                        
-                        // Prima validazione
-                        QTimer::singleShot(200, this, [this]() {
-                            if (m_editValidationEnabled && !m_editTypeChanging) {
-                                onEditValidationChanged();
-                            }
-                        });
-                    } else {
-                        m_editValidationEnabled = false;
-                        enableEditForm(false);
-                    }
-                });
-            });
+            // I form sono già costruiti: il cambio tipo azzera e mostra quello del primo tipo,
+            // poi abilita la validazione
+            onEditTipoChanged();
+            enableEditForm(!readOnly);
         } else {
             if (!readOnly) {
-                // Modalità modifica
-                QTimer::singleShot(300, this, [this]() {
+                // Modalità modifica: si valida dopo loadEditMediaData, chiamata subito dopo
+                QTimer::singleShot(0, this, [this]() {
                     m_editValidationEnabled = true;
-                    QTimer::singleShot(100, this, [this]() {
-                        if (m_editValidationEnabled && !m_editTypeChanging) {
-                            onEditValidationChanged();
-                        }
-                    });
+                    onEditValidationChanged();
                 });
             } else {
                 // Modalità read-only
@@ -124,7 +103,7 @@ void MainWindow::showEditPanel(bool isNew, bool readOnly)
         }
 
         if (!readOnly && m_editTitoloEdit) {
-            QTimer::singleShot(1000, [this]() {
+            QTimer::singleShot(0, this, [this]() {
                 if (m_editTitoloEdit && m_editPanel && m_editPanel->isVisible()) {
                     m_editTitoloEdit->setFocus();
                 }
@@ -203,13 +182,6 @@ void MainWindow::loadEditMediaData(Media* media)
     if (!media) return;
     
     try {
-        if (m_editAttoriList) {
-            m_editAttoriList->clear();
-        }
-        if (m_editAutoriList) {
-            m_editAutoriList->clear();
-        }
-        
         // Dati base
         if (m_editTitoloEdit) {
             m_editTitoloEdit->setText(media->getTitolo());
@@ -224,11 +196,14 @@ void MainWindow::loadEditMediaData(Media* media)
         // Dati specifici
         QString tipo = media->getTypeDisplayName();
         if (m_editTipoCombo) {
+            // Senza onEditTipoChanged: il form viene riempito qui sotto
+            QSignalBlocker bloccoTipo(m_editTipoCombo);
             m_editTipoCombo->setCurrentText(tipo);
         }
-        m_editTipoCorrente = tipo;
         
-        setupEditTypeSpecificForm();
+        // Il form è riusato: si parte dai valori iniziali (es. liste vuote)
+        resetEditTypeSpecificForm(tipo);
+        showEditTypeSpecificForm(tipo);
         
         // Dati specifici per tipo
         if (tipo == "Libro") {
@@ -266,10 +241,7 @@ void MainWindow::loadEditMediaData(Media* media)
         }
         
         updateEditFormVisibility();
-        
-        QTimer::singleShot(10, this, [this]() {
-            enableEditForm(!m_editReadOnly);
-        });
+        enableEditForm(!m_editReadOnly);
         
     } catch (const std::exception& e) {
         mostraErrore(QString("Errore nel caricamento dati: %1").arg(e.what()));
@@ -304,33 +276,21 @@ void MainWindow::onEditTipoChanged()
                 m_editSalvaButton->setEnabled(false);
             }
             
-            m_editTipoCorrente = nuovoTipo;
+            // Il form del nuovo tipo riparte dai valori iniziali, già costruito e collegato
+            resetEditTypeSpecificForm(nuovoTipo);
+            showEditTypeSpecificForm(nuovoTipo);
             
-            // Ricrea il form specifico
-            setupEditTypeSpecificForm();
-            updateEditFormVisibility();
+            m_editTypeChanging = false;
             
-            // Riabilita tutto dopo un delay
-            QTimer::singleShot(300, this, [this]() {
-                m_editTypeChanging = false;
-                
-                if (!m_editReadOnly) {
-                    m_editValidationEnabled = true;
-                    setupEditSpecificConnections();
-                    
-                    // Trigger validazione iniziale dopo delay
-                    QTimer::singleShot(200, this, [this]() {
-                        if (m_editValidationEnabled && !m_editTypeChanging) {
-                            onEditValidationChanged();
-                        }
-                    });
-                } else {
-                    m_editValidationEnabled = false;
-                    if (m_editValidationLabel) {
-                        m_editValidationLabel->setVisible(false);
-                    }
+            if (!m_editReadOnly) {
+                m_editValidationEnabled = true;
+                onEditValidationChanged();
+            } else {
+                m_editValidationEnabled = false;
+                if (m_editValidationLabel) {
+                    m_editValidationLabel->setVisible(false);
                 }
-            });
+            }
         }
     } catch (const std::exception& e) {
         m_editTypeChanging = false;
@@ -742,15 +702,15 @@ void MainWindow::hideManagementControls()
 
 void MainWindow::showManagementControls()
 {
-    QString tipo = m_editTipoCombo ? m_editTipoCombo->currentText() : "";
+    // Tutti i tipi: i form restano costruiti e il cambio tipo non passa di qui
     
-    if (tipo == "Film") {
-        if (m_editNuovoAttoreEdit) m_editNuovoAttoreEdit->setVisible(true);
-        if (m_editAggiungiAttoreBtn) m_editAggiungiAttoreBtn->setVisible(true);
-        if (m_editRimuoviAttoreBtn) m_editRimuoviAttoreBtn->setVisible(true);
-    } else if (tipo == "Articolo") {
-        if (m_editNuovoAutoreEdit) m_editNuovoAutoreEdit->setVisible(true);
-        if (m_editAggiungiAutoreBtn) m_editAggiungiAutoreBtn->setVisible(true);
-        if (m_editRimuoviAutoreBtn) m_editRimuoviAutoreBtn->setVisible(true);
-    }
+    // Film
+    if (m_editNuovoAttoreEdit) m_editNuovoAttoreEdit->setVisible(true);
+    if (m_editAggiungiAttoreBtn) m_editAggiungiAttoreBtn->setVisible(true);
+    if (m_editRimuoviAttoreBtn) m_editRimuoviAttoreBtn->setVisible(true);
+    
+    // Articolo
+    if (m_editNuovoAutoreEdit) m_editNuovoAutoreEdit->setVisible(true);
+    if (m_editAggiungiAutoreBtn) m_editAggiungiAutoreBtn->setVisible(true);
+    if (m_editRimuoviAutoreBtn) m_editRimuoviAutoreBtn->setVisible(true);
 }
\ No newline at end of file
@@ -3,7 +3,6 @@
 #include "modello_logico/libro.h"
 #include "modello_logico/film.h"
 #include "modello_logico/articolo.h"
-#include <QApplication>
 #include <QMessageBox>
 #include <QVBoxLayout>
 #include <QHBoxLayout>
@@ -87,6 +86,11 @@ void MainWindow::setupEditPanel()
         
         setupEditBaseForm();
         
+        // I form specifici vengono costruiti una volta sola e mostrati in base al tipo
+        setupEditLibroForm();
+        setupEditFilmForm();
+        setupEditArticoloForm();
+        
         m_editScrollArea->setWidget(formWidget);
         editLayout->addWidget(m_editScrollArea);
         
@@ -138,6 +142,10 @@ void MainWindow::setupEditPanel()
         editLayout->addLayout(buttonLayout);
         
         setupEditConnections();
+        setupEditSpecificConnections();
+        if (m_editTipoCombo) {
+            showEditTypeSpecificForm(m_editTipoCombo->currentText());
+        }
         
     } catch (const std::exception& e) {
         mostraErrore(QString("Errore nella creazione pannello edit: %1").arg(e.what()));
@@ -256,6 +264,7 @@ void MainWindow::setupEditLibroForm()
         libroLayout->addRow("Genere:", m_editGenereLibroCombo);
     }
     
+    m_editLibroGroup->setVisible(false);
     m_editFormLayout->addWidget(m_editLibroGroup);
 }
 
@@ -341,6 +350,7 @@ void MainWindow::setupEditFilmForm()
         filmLayout->addRow("Casa Produzione:", m_editCasaProduzioneEdit);
     }
     
+    m_editFilmGroup->setVisible(false);
     m_editFormLayout->addWidget(m_editFilmGroup);
 }
 
@@ -456,6 +466,7 @@ void MainWindow::setupEditArticoloForm()
         articoloLayout->addRow("DOI:", m_editDoiEdit);
     }
     
+    m_editArticoloGroup->setVisible(false);
     m_editFormLayout->addWidget(m_editArticoloGroup);
 }
 
@@ -492,324 +503,102 @@ void MainWindow::setupEditConnections()
 
 void MainWindow::setupEditSpecificConnections()
 {
-    if (m_editTypeChanging) {
-        qDebug() << "Skip connessioni specifiche - cambio tipo in corso";
+    // Chiamata una volta sola da setupEditPanel: i form di tutti i tipi restano costruiti
+    // e collegati, il cambio tipo ne cambia solo la visibilità
+    
+    // Libro
+    connect(m_editAutoreEdit, &QLineEdit::textChanged, this, &MainWindow::scheduleValidation);
+    connect(m_editEditoreEdit, &QLineEdit::textChanged, this, &MainWindow::scheduleValidation);
+    connect(m_editPagineSpin, QOverload<int>::of(&QSpinBox::valueChanged),
+            this, &MainWindow::scheduleValidation);
+    connect(m_editIsbnEdit, &QLineEdit::textChanged, this, &MainWindow::scheduleValidation);
+    connect(m_editGenereLibroCombo, QOverload<int>::of(&QComboBox::currentIndexChanged),
+            this, &MainWindow::scheduleValidation);
+    
+    // Film
+    connect(m_editRegistaEdit, &QLineEdit::textChanged, this, &MainWindow::scheduleValidation);
+    connect(m_editDurataSpin, QOverload<int>::of(&QSpinBox::valueChanged),
+            this, &MainWindow::scheduleValidation);
+    connect(m_editCasaProduzioneEdit, &QLineEdit::textChanged, this, &MainWindow::scheduleValidation);
+    connect(m_editGenereFilmCombo, QOverload<int>::of(&QComboBox::currentIndexChanged),
+            this, &MainWindow::scheduleValidation);
+    connect(m_editClassificazioneCombo, QOverload<int>::of(&QComboBox::currentIndexChanged),
+            this, &MainWindow::scheduleValidation);
+    connect(m_editAggiungiAttoreBtn, &QPushButton::clicked, this, &MainWindow::onEditAggiungiAttoreClicked);
+    connect(m_editRimuoviAttoreBtn, &QPushButton::clicked, this, &MainWindow::onEditRimuoviAttoreClicked);
+    connect(m_editNuovoAttoreEdit, &QLineEdit::returnPressed, this, &MainWindow::onEditAggiungiAttoreClicked);
+    
+    // Articolo
+    connect(m_editRivisteEdit, &QLineEdit::textChanged, this, &MainWindow::scheduleValidation);
+    connect(m_editDataPubblicazioneEdit, &QDateEdit::dateChanged, this, &MainWindow::scheduleValidation);
+    connect(m_editVolumeEdit, &QLineEdit::textChanged, this, &MainWindow::scheduleValidation);
+    connect(m_editNumeroEdit, &QLineEdit::textChanged, this, &MainWindow::scheduleValidation);
+    connect(m_editPagineEdit, &QLineEdit::textChanged, this, &MainWindow::scheduleValidation);
+    connect(m_editCategoriaCombo, QOverload<int>::of(&QComboBox::currentIndexChanged),
+            this, &MainWindow::scheduleValidation);
+    connect(m_editTipoRivistaCombo, QOverload<int>::of(&QComboBox::currentIndexChanged),
+            this, &MainWindow::scheduleValidation);
+    connect(m_editDoiEdit, &QLineEdit::textChanged, this, &MainWindow::scheduleValidation);
+    connect(m_editAggiungiAutoreBtn, &QPushButton::clicked, this, &MainWindow::onEditAggiungiAutoreClicked);
+    connect(m_editRimuoviAutoreBtn, &QPushButton::clicked, this, &MainWindow::onEditRimuoviAutoreClicked);
+    connect(m_editNuovoAutoreEdit, &QLineEdit::returnPressed, this, &MainWindow::onEditAggiungiAutoreClicked);
+}
+
+void MainWindow::showEditTypeSpecificForm(const QString& tipo)
+{
+    if (m_editLibroGroup) m_editLibroGroup->setVisible(tipo == "Libro");
+    if (m_editFilmGroup) m_editFilmGroup->setVisible(tipo == "Film");
+    if (m_editArticoloGroup) m_editArticoloGroup->setVisible(tipo == "Articolo");
+    
+    m_editTipoCorrente = tipo;
+}
+
+void MainWindow::resetEditTypeSpecificForm(const QString& tipo)
+{
+    QGroupBox* gruppo = tipo == "Libro" ? m_editLibroGroup
+                      : tipo == "Film" ? m_editFilmGroup
+                      : tipo == "Articolo" ? m_editArticoloGroup
+                      : nullptr;
+    if (!gruppo) {
+        qWarning() << "Tipo non riconosciuto in resetEditTypeSpecificForm:" << tipo;
         return;
     }
     
-    QString tipo = m_editTipoCombo ? m_editTipoCombo->currentText() : "";
-    qDebug() << "Setup connessioni specifiche per:" << tipo;
+    // Nessuna validazione per ogni campo azzerato: chi chiama valida una volta alla fine
+    const QList<QWidget*> campi = gruppo->findChildren<QWidget*>();
+    for (QWidget* campo : campi) {
+        campo->blockSignals(true);
+    }
     
+    // Stessi valori iniziali di setupEditLibroForm, setupEditFilmForm e setupEditArticoloForm
     if (tipo == "Libro") {
-        // Connessioni per validazione
-        if (m_editAutoreEdit) {
-            connect(m_editAutoreEdit, &QLineEdit::textChanged, this, [this]() {
-                scheduleValidation();
-            });
-        }
-        if (m_editPagineSpin) {
-            connect(m_editPagineSpin, QOverload<int>::of(&QSpinBox::valueChanged), 
-                    this, [this]() {
-                        scheduleValidation();
-                    });
-        }
-        if (m_editEditoreEdit) {
-            connect(m_editEditoreEdit, &QLineEdit::textChanged, this, [this]() {
-                scheduleValidation();
-            });
-        }
-        if (m_editIsbnEdit) {
-            connect(m_editIsbnEdit, &QLineEdit::textChanged, this, [this]() {
-                scheduleValidation();
-            });
-        }
-        if (m_editGenereLibroCombo) {
-            connect(m_editGenereLibroCombo, QOverload<int>::of(&QComboBox::currentIndexChanged), 
-                    this, [this]() {
-                        scheduleValidation();
-                    });
-        }
-        
+        m_editAutoreEdit->clear();
+        m_editEditoreEdit->clear();
+        m_editPagineSpin->setValue(200);
+        m_editIsbnEdit->clear();
+        m_editGenereLibroCombo->setCurrentIndex(0);
     } else if (tipo == "Film") {
-        // Connessioni per validazione
-        if (m_editRegistaEdit) {
-            connect(m_editRegistaEdit, &QLineEdit::textChanged, this, [this]() {
-                scheduleValidation();
-            });
-        }
-        if (m_editDurataSpin) {
-            connect(m_editDurataSpin, QOverload<int>::of(&QSpinBox::valueChanged), 
-                    this, [this]() {
-                        scheduleValidation();
-                    });
-        }
-        if (m_editCasaProduzioneEdit) {
-            connect(m_editCasaProduzioneEdit, &QLineEdit::textChanged, this, [this]() {
-                scheduleValidation();
-            });
-        }
-        if (m_editGenereFilmCombo) {
-            connect(m_editGenereFilmCombo, QOverload<int>::of(&QComboBox::currentIndexChanged), 
-                    this, [this]() {
-                        scheduleValidation();
-                    });
-        }
-        if (m_editClassificazioneCombo) {
-            connect(m_editClassificazioneCombo, QOverload<int>::of(&QComboBox::currentIndexChanged), 
-                    this, [this]() {
-                        scheduleValidation();
-                    });
-        }
-        
-        // Connessioni per i bottoni
-        if (m_editAggiungiAttoreBtn) {
-            qDebug() << "Connetto bottone aggiungi attore";
-            connect(m_editAggiungiAttoreBtn, &QPushButton::clicked, 
-                    this, &MainWindow::onEditAggiungiAttoreClicked);
-        }
-        if (m_editRimuoviAttoreBtn) {
-            qDebug() << "Connetto bottone rimuovi attore";
-            connect(m_editRimuoviAttoreBtn, &QPushButton::clicked, 
-                    this, &MainWindow::onEditRimuoviAttoreClicked);
-        }
-        if (m_editNuovoAttoreEdit) {
-            qDebug() << "Connetto enter su nuovo attore";
-            connect(m_editNuovoAttoreEdit, &QLineEdit::returnPressed, 
-                    this, &MainWindow::onEditAggiungiAttoreClicked);
-        }
-        
-    } else if (tipo == "Articolo") {
-        // Connessioni per validazione
-        if (m_editRivisteEdit) {
-            connect(m_editRivisteEdit, &QLineEdit::textChanged, this, [this]() {
-                scheduleValidation();
-            });
-        }
-        if (m_editDataPubblicazioneEdit) {
-            connect(m_editDataPubblicazioneEdit, &QDateEdit::dateChanged, 
-                    this, [this]() {
-                        scheduleValidation();
-                    });
-        }
-        if (m_editVolumeEdit) {
-            connect(m_editVolumeEdit, &QLineEdit::textChanged, this, [this]() {
-                scheduleValidation();
-            });
-        }
-        if (m_editNumeroEdit) {
-            connect(m_editNumeroEdit, &QLineEdit::textChanged, this, [this]() {
-                scheduleValidation();
-            });
-        }
-        if (m_editPagineEdit) {
-            connect(m_editPagineEdit, &QLineEdit::textChanged, this, [this]() {
-                scheduleValidation();
-            });
-        }
-        if (m_editCategoriaCombo) {
-            connect(m_editCategoriaCombo, QOverload<int>::of(&QComboBox::currentIndexChanged), 
-                    this, [this]() {
-                        scheduleValidation();
-                    });
-        }
-        if (m_editTipoRivistaCombo) {
-            connect(m_editTipoRivistaCombo, QOverload<int>::of(&QComboBox::currentIndexChanged), 
-                    this, [this]() {
-                        scheduleValidation();
-                    });
-        }
-        if (m_editDoiEdit) {
-            connect(m_editDoiEdit, &QLineEdit::textChanged, this, [this]() {
-                scheduleValidation();
-            });
-        }
-        
-        // Connessioni per i bottoni
-        if (m_editAggiungiAutoreBtn) {
-            qDebug() << "Connetto bottone aggiungi autore";
-            connect(m_editAggiungiAutoreBtn, &QPushButton::clicked, 
-                    this, &MainWindow::onEditAggiungiAutoreClicked);
-        }
-        if (m_editRimuoviAutoreBtn) {
-            qDebug() << "Connetto bottone rimuovi autore";
-            connect(m_editRimuoviAutoreBtn, &QPushButton::clicked, 
-                    this, &MainWindow::onEditRimuoviAutoreClicked);
-        }
-        if (m_editNuovoAutoreEdit) {
-            qDebug() << "Connetto enter su nuovo autore";
-            connect(m_editNuovoAutoreEdit, &QLineEdit::returnPressed, 
-                    this, &MainWindow::onEditAggiungiAutoreClicked);
-        }
-    }
-    
-    qDebug() << "Connessioni specifiche completate per:" << tipo;
-}
-
-void MainWindow::clearEditSpecificForm()
-{
-    try {
-        if (!m_editFormLayout) return;
-        
-        if (m_editLibroGroup) {
-            // Disconnetti i widget specifici del libro
-            if (m_editAutoreEdit) disconnect(m_editAutoreEdit, nullptr, this, nullptr);
-            if (m_editEditoreEdit) disconnect(m_editEditoreEdit, nullptr, this, nullptr);
-            if (m_editPagineSpin) disconnect(m_editPagineSpin, nullptr, this, nullptr);
-            if (m_editIsbnEdit) disconnect(m_editIsbnEdit, nullptr, this, nullptr);
-            if (m_editGenereLibroCombo) disconnect(m_editGenereLibroCombo, nullptr, this, nullptr);
-            
-            m_editFormLayout->removeWidget(m_editLibroGroup);
-            m_editLibroGroup->deleteLater();
-            m_editLibroGroup = nullptr;
-        }
-        
-        if (m_editFilmGroup) {
-            // Disconnetti i widget specifici del film
-            if (m_editRegistaEdit) disconnect(m_editRegistaEdit, nullptr, this, nullptr);
-            if (m_editDurataSpin) disconnect(m_editDurataSpin, nullptr, this, nullptr);
-            if (m_editCasaProduzioneEdit) disconnect(m_editCasaProduzioneEdit, nullptr, this, nullptr);
-            if (m_editGenereFilmCombo) disconnect(m_editGenereFilmCombo, nullptr, this, nullptr);
-            if (m_editClassificazioneCombo) disconnect(m_editClassificazioneCombo, nullptr, this, nullptr);
-            if (m_editAttoriList) disconnect(m_editAttoriList, nullptr, this, nullptr);
-            
-            // Disconnetti i bottoni per evitare connessioni doppie
-            if (m_editAggiungiAttoreBtn) {
-                disconnect(m_editAggiungiAttoreBtn, nullptr, this, nullptr);
-            }
-            if (m_editRimuoviAttoreBtn) {
-                disconnect(m_editRimuoviAttoreBtn, nullptr, this, nullptr);
-            }
-            if (m_editNuovoAttoreEdit) {
-                disconnect(m_editNuovoAttoreEdit, nullptr, this, nullptr);
-            }
-            
-            m_editFormLayout->removeWidget(m_editFilmGroup);
-            m_editFilmGroup->deleteLater();
-            m_editFilmGroup = nullptr;
-        }
-        
-        if (m_editArticoloGroup) {
-            // Disconnetti i widget specifici dell'articolo
-            if (m_editRivisteEdit) disconnect(m_editRivisteEdit, nullptr, this, nullptr);
-            if (m_editDataPubblicazioneEdit) disconnect(m_editDataPubblicazioneEdit, nullptr, this, nullptr);
-            if (m_editVolumeEdit) disconnect(m_editVolumeEdit, nullptr, this, nullptr);
-            if (m_editNumeroEdit) disconnect(m_editNumeroEdit, nullptr, this, nullptr);
-            if (m_editPagineEdit) disconnect(m_editPagineEdit, nullptr, this, nullptr);
-            if (m_editCategoriaCombo) disconnect(m_editCategoriaCombo, nullptr, this, nullptr);
-            if (m_editTipoRivistaCombo) disconnect(m_editTipoRivistaCombo, nullptr, this, nullptr);
-            if (m_editDoiEdit) disconnect(m_editDoiEdit, nullptr, this, nullptr);
-            if (m_editAutoriList) disconnect(m_editAutoriList, nullptr, this, nullptr);
-            
-            // Disconnetti i bottoni per evitare connessioni doppie
-            if (m_editAggiungiAutoreBtn) {
-                disconnect(m_editAggiungiAutoreBtn, nullptr, this, nullptr);
-            }
-            if (m_editRimuoviAutoreBtn) {
-                disconnect(m_editRimuoviAutoreBtn, nullptr, this, nullptr);
-            }
-            if (m_editNuovoAutoreEdit) {
-                disconnect(m_editNuovoAutoreEdit, nullptr, this, nullptr);
-            }
-            
-            m_editFormLayout->removeWidget(m_editArticoloGroup);
-            m_editArticoloGroup->deleteLater();
-            m_editArticoloGroup = nullptr;
-        }
-        
-        // Reset di tutti puntatori specifici
-        resetEditSpecificPointers();
-        
-        // Forza il processamento degli eventi per completare la cancellazione
-        QApplication::processEvents();
-        
-    } catch (const std::exception& e) {
-        qWarning() << "Errore in clearEditSpecificForm:" << e.what();
+        m_editRegistaEdit->clear();
+        m_editAttoriList->clear();
+        m_editNuovoAttoreEdit->clear();
+        m_editDurataSpin->setValue(90);
+        m_editGenereFilmCombo->setCurrentIndex(0);
+        m_editClassificazioneCombo->setCurrentIndex(0);
+        m_editCasaProduzioneEdit->clear();
+    } else {
+        m_editAutoriList->clear();
+        m_editNuovoAutoreEdit->clear();
+        m_editRivisteEdit->clear();
+        m_editDataPubblicazioneEdit->setDate(QDate::currentDate());
+        m_editVolumeEdit->clear();
+        m_editNumeroEdit->clear();
+        m_editPagineEdit->clear();
+        m_editCategoriaCombo->setCurrentIndex(0);
+        m_editTipoRivistaCombo->setCurrentIndex(0);
+        m_editDoiEdit->clear();
     }
-}
-
-void MainWindow::disconnectEditGroupWidgets(QGroupBox* group)
-{
-    if (!group) return;
     
-    try {
-        // Trova tutti i widget figli e disconnettili
-        QList<QWidget*> widgets = group->findChildren<QWidget*>();
-        for (QWidget* widget : widgets) {
-            if (widget) {
-                disconnect(widget, nullptr, this, nullptr);
-            }
-        }
-    } catch (const std::exception& e) {
-        qWarning() << "Errore in disconnectEditGroupWidgets:" << e.what();
+    for (QWidget* campo : campi) {
+        campo->blockSignals(false);
     }
 }
-
-void MainWindow::resetEditSpecificPointers()
-{
-    // Reset puntatori libro
-    m_editAutoreEdit = nullptr;
-    m_editEditoreEdit = nullptr;
-    m_editPagineSpin = nullptr;
-    m_editIsbnEdit = nullptr;
-    m_editGenereLibroCombo = nullptr;
-    
-    // Reset puntatori film
-    m_editRegistaEdit = nullptr;
-    m_editAttoriList = nullptr;
-    m_editNuovoAttoreEdit = nullptr;
-    m_editAggiungiAttoreBtn = nullptr;
-    m_editRimuoviAttoreBtn = nullptr;
-    m_editDurataSpin = nullptr;
-    m_editGenereFilmCombo = nullptr;
-    m_editClassificazioneCombo = nullptr;
-    m_editCasaProduzioneEdit = nullptr;
-    
-    // Reset puntatori articolo
-    m_editAutoriList = nullptr;
-    m_editNuovoAutoreEdit = nullptr;
-    m_editAggiungiAutoreBtn = nullptr;
-    m_editRimuoviAutoreBtn = nullptr;
-    m_editRivisteEdit = nullptr;
-    m_editVolumeEdit = nullptr;
-    m_editNumeroEdit = nullptr;
-    m_editPagineEdit = nullptr;
-    m_editCategoriaCombo = nullptr;
-    m_editTipoRivistaCombo = nullptr;
-    m_editDataPubblicazioneEdit = nullptr;
-    m_editDoiEdit = nullptr;
-}
-
-void MainWindow::setupEditTypeSpecificForm()
-{
-    try {
-        clearEditSpecificForm();
-        
-        if (!m_editTipoCombo) {
-            qWarning() << "TipoCombo non inizializzato in setupEditTypeSpecificForm";
-            return;
-        }
-        
-        QString tipo = m_editTipoCombo->currentText();
-        m_editTipoCorrente = tipo;
-        
-        qDebug() << "Setup form specifico per tipo:" << tipo;
-        
-        if (tipo == "Libro") {
-            setupEditLibroForm();
-        } else if (tipo == "Film") {
-            setupEditFilmForm();
-        } else if (tipo == "Articolo") {
-            setupEditArticoloForm();
-        } else {
-            qWarning() << "Tipo non riconosciuto in setupEditTypeSpecificForm:" << tipo;
-        }
-        
-        // Setup connessioni specifiche per il tipo
-        setupEditSpecificConnections();
-        
-        qDebug() << "Form specifico completato per tipo:" << tipo;
-        
-    } catch (const std::exception& e) {
-        mostraErrore(QString("Errore nel setup form specifico: %1").arg(e.what()));
-    }
-}
\ No newline at end of file
@@ -1,5 +1,6 @@
 #include "mainwindow.h"
 #include "mediacard.h"
+#include "grigliacard.h"
 #include "modello_logico/collezione.h"
 #include "modello_logico/filtrostrategy.h"
 #include <QApplication>
@@ -19,7 +20,10 @@
 #include <QLabel>
 #include <QSpinBox>
 #include <QCheckBox>
+#include <QTimer>
 #include <QDate>
+#include <QCompleter>
+#include <QStringListModel>
 
 void MainWindow::setupUI()
 {
@@ -65,6 +69,36 @@ void MainWindow::setupToolBar()
             mostraErrore(QString("Errore: %1").arg(e.what()));
         }
     });
+    
+    toolBar->addSeparator();
+    
+    m_prestazioniAction = toolBar->addAction("Prestazioni");
+    m_prestazioniAction->setToolTip("Mostra latenze, card e memoria delle ultime operazioni");
+    m_prestazioniAction->setCheckable(true);
+    
+    QAction* memoriaAction = toolBar->addAction("Memoria");
+    memoriaAction->setToolTip("Stima della memoria occupata dalla collezione");
+    connect(memoriaAction, &QAction::triggered, this, [this]() {
+        try {
+            mostraRapportoMemoria();
+        } catch (const std::exception& e) {
+            mostraErrore(QString("Errore: %1").arg(e.what()));
+        }
+    });
+    
+#ifdef BIBLIOTECA_TRACCIA
+    // Solo nelle build con CONFIG+=traccia: registra e salva in formato Chrome trace
+    QAction* tracciaAction = toolBar->addAction("Traccia");
+    tracciaAction->setToolTip("Avvia o ferma la registrazione della traccia di esecuzione");
+    tracciaAction->setCheckable(true);
+    connect(tracciaAction, &QAction::toggled, this, [this](bool attiva) {
+        try {
+            attivaTraccia(attiva);
+        } catch (const std::exception& e) {
+            mostraErrore(QString("Errore: %1").arg(e.what()));
+        }
+    });
+#endif
 }
 
 void MainWindow::setupStatusBar()
@@ -75,6 +109,12 @@ void MainWindow::setupStatusBar()
     m_progressBar = new QProgressBar();
     m_progressBar->setVisible(false);
     statusBar()->addPermanentWidget(m_progressBar);
+    
+    // Nascosto finché non viene attivato dalla toolbar (scelta salvata nelle impostazioni)
+    m_pannelloPrestazioni = new PannelloPrestazioni();
+    m_pannelloPrestazioni->setVisible(m_prestazioniAction->isChecked());
+    statusBar()->addPermanentWidget(m_pannelloPrestazioni);
+    connect(m_prestazioniAction, &QAction::toggled, m_pannelloPrestazioni, &QWidget::setVisible);
 }
 
 void MainWindow::setupMainArea()
@@ -129,6 +169,9 @@ void MainWindow::setupFilterArea()
 
     m_searchEdit = new QLineEdit();
     m_searchEdit->setPlaceholderText("Cerca nei media...");
+    m_searchEdit->setToolTip("Testo libero oppure query, ad esempio:\n"
+                             "tipo:film anno:1990..2000 regista:nolan -genere:horror \"parola esatta\"\n"
+                             "campo:=valore per il valore esatto, campo:valore* per il prefisso, OR e parentesi");
     m_searchEdit->setMinimumHeight(25);
     searchInputLayout->addWidget(m_searchEdit);
 
@@ -141,15 +184,53 @@ void MainWindow::setupFilterArea()
 
     searchLayout->addLayout(searchInputLayout);
 
+    m_fuzzyCheck = new QCheckBox("Ricerca approssimata");
+    m_fuzzyCheck->setToolTip("Tollera errori di battitura e ordina i risultati per rilevanza");
+    searchLayout->addWidget(m_fuzzyCheck);
+
+    QHBoxLayout* ordinamentoLayout = new QHBoxLayout();
+    ordinamentoLayout->addWidget(new QLabel("Ordina per:"));
+    m_ordinamentoCombo = new QComboBox();
+    m_ordinamentoCombo->addItems({"Predefinito", "Titolo", "Anno (più recenti)", "Autore / Regista", "Tipo"});
+    m_ordinamentoCombo->setToolTip("Predefinito: ordine di inserimento, oppure di rilevanza durante una ricerca");
+    ordinamentoLayout->addWidget(m_ordinamentoCombo, 1);
+    searchLayout->addLayout(ordinamentoLayout);
+
+    m_altriRisultatiButton = new QPushButton("Mostra altri");
+    m_altriRisultatiButton->setToolTip("Mostra la pagina successiva dei risultati");
+    m_altriRisultatiButton->setVisible(false);
+    searchLayout->addWidget(m_altriRisultatiButton);
+    connect(m_altriRisultatiButton, &QPushButton::clicked, this, &MainWindow::mostraAltriRisultati);
+
+    // Attende una pausa nella digitazione prima di rieseguire la ricerca
+    m_searchTimer = new QTimer(this);
+    m_searchTimer->setSingleShot(true);
+    m_searchTimer->setInterval(200);
+    connect(m_searchTimer, &QTimer::timeout, this, &MainWindow::cercaMedia);
+
     // Connessioni
     connect(m_searchEdit, &QLineEdit::textChanged, this, [this](const QString& text) {
         m_clearSearchButton->setEnabled(!text.isEmpty());
+        m_searchTimer->start();
+    });
+
+    connect(m_searchEdit, &QLineEdit::returnPressed, this, [this]() {
+        m_searchTimer->stop();
         cercaMedia();
     });
+    collegaCompletamento(m_searchEdit, "titolo");
+
+    connect(m_fuzzyCheck, &QCheckBox::toggled, this, [this]() {
+        if (!m_searchEdit->text().trimmed().isEmpty()) {
+            cercaMedia();
+        }
+    });
 
-    connect(m_searchEdit, &QLineEdit::returnPressed, this, &MainWindow::cercaMedia);
+    connect(m_ordinamentoCombo, QOverload<int>::of(&QComboBox::currentIndexChanged),
+            this, &MainWindow::refreshMediaCards);
 
     connect(m_clearSearchButton, &QPushButton::clicked, this, [this]() {
+        m_searchTimer->stop();
         m_searchEdit->clear();
         m_clearSearchButton->setEnabled(false);
         cercaMedia();
@@ -194,23 +275,27 @@ void MainWindow::setupFilterArea()
     m_autoreEdit = new QLineEdit();
     m_autoreEdit->setPlaceholderText("Nome autore...");
     m_autoreEdit->setMaximumHeight(30);
-    m_autoreEdit->setToolTip("Filtra per nome dell'autore (solo libri e articoli)");
+    m_autoreEdit->setToolTip("Filtra per nome dell'autore (solo libri e articoli)\n\"=nome\" per il valore esatto, \"nome*\" per il prefisso");
     filtersLayout->addWidget(m_autoreEdit);
     
     filtersLayout->addWidget(new QLabel("Regista:"));
     m_registaEdit = new QLineEdit();
     m_registaEdit->setPlaceholderText("Nome regista...");
     m_registaEdit->setMaximumHeight(30);
-    m_registaEdit->setToolTip("Filtra per nome del regista (solo film)");
+    m_registaEdit->setToolTip("Filtra per nome del regista (solo film)\n\"=nome\" per il valore esatto, \"nome*\" per il prefisso");
     filtersLayout->addWidget(m_registaEdit);
     
     filtersLayout->addWidget(new QLabel("Rivista:"));
     m_rivistaEdit = new QLineEdit();
     m_rivistaEdit->setPlaceholderText("Nome rivista...");
     m_rivistaEdit->setMaximumHeight(30);
-    m_rivistaEdit->setToolTip("Filtra per nome della rivista (solo articoli)");
+    m_rivistaEdit->setToolTip("Filtra per nome della rivista (solo articoli)\n\"=nome\" per il valore esatto, \"nome*\" per il prefisso");
     filtersLayout->addWidget(m_rivistaEdit);
     
+    collegaCompletamento(m_autoreEdit, "autore");
+    collegaCompletamento(m_registaEdit, "regista");
+    collegaCompletamento(m_rivistaEdit, "rivista");
+    
     // Bottoni filtri
     QHBoxLayout* filterButtonLayout = new QHBoxLayout();
     m_applyFilterButton = new QPushButton("Applica"); 
@@ -293,11 +378,35 @@ void MainWindow::setupMediaArea()
     m_mediaScrollArea->setHorizontalScrollBarPolicy(Qt::ScrollBarAsNeeded);
     m_mediaScrollArea->setVerticalScrollBarPolicy(Qt::ScrollBarAsNeeded);
     
-    // Container per le card
+    // Container per le card: posizioni calcolate dall'indice, senza ricostruire il layout
     m_mediaContainer = new QWidget();
-    m_mediaLayout = new QGridLayout(m_mediaContainer);
+    m_mediaLayout = new GrigliaCard(m_mediaContainer, QSize(CARD_WIDTH, CARD_HEIGHT));
     m_mediaLayout->setContentsMargins(CARD_MARGIN, CARD_MARGIN, CARD_MARGIN, CARD_MARGIN);
     m_mediaLayout->setSpacing(CARD_MARGIN);
     
     m_mediaScrollArea->setWidget(m_mediaContainer);
-}
\ No newline at end of file
+}
+
+void MainWindow::collegaCompletamento(QLineEdit* campo, const QString& nomeCampo)
+{
+    // I suggerimenti arrivano già filtrati e ordinati dal trie della collezione
+    QStringListModel* modello = new QStringListModel(campo);
+    QCompleter* completer = new QCompleter(modello, campo);
+    completer->setCaseSensitivity(Qt::CaseInsensitive);
+    completer->setCompletionMode(QCompleter::UnfilteredPopupCompletion);
+    campo->setCompleter(completer);
+    
+    connect(campo, &QLineEdit::textEdited, this, [this, modello, completer, nomeCampo](const QString& testo) {
+        // Nessun suggerimento per le sintassi "=valore" e "valore*"
+        QString prefisso = testo.trimmed();
+        if (prefisso.isEmpty() || prefisso.startsWith('=') || prefisso.endsWith('*')) {
+            modello->setStringList(QStringList());
+            return;
+        }
+        
+        modello->setStringList(m_collezione->completa(nomeCampo, prefisso));
+        if (modello->rowCount() > 0) {
+            completer->complete();
+        }
+    });
+}
@@ -3,6 +3,8 @@
 #include "modello_logico/libro.h"
 #include "modello_logico/film.h"
 #include "modello_logico/articolo.h"
+#include "modello_logico/traccia.h"
+#include "iconemedia.h"
 #include <QMouseEvent>
 #include <QPainter>
 #include <QStyleOption>
@@ -15,6 +17,8 @@ MediaCard::MediaCard(Media* media, QWidget *parent)
     , m_media(media)
     , m_selected(false)
     , m_hovered(false)
+    , m_sfondoSelezione(0xE3, 0xF2, 0xFD)
+    , m_bordoSelezione(0x21, 0x96, 0xF3)
     , m_mainLayout(nullptr)
     , m_headerLayout(nullptr)
     , m_contentLayout(nullptr)
@@ -37,9 +41,6 @@ MediaCard::MediaCard(Media* media, QWidget *parent)
     QString mediaType = m_media->getTypeDisplayName().toLower();
     setProperty("mediaType", mediaType);
     
-    // Imposta stato iniziale
-    setProperty("selected", false);
-    
     try {
         setupUI();
     } catch (const std::exception& e) {
@@ -61,17 +62,25 @@ Media* MediaCard::getMedia() const
 
 void MediaCard::setSelected(bool selected)
 {
+    // Solo un ridisegno: unpolish/polish rivaluterebbero il foglio di stile globale
     if (m_selected != selected) {
         m_selected = selected;
-        setProperty("selected", selected);
-        
-        // Forza il refresh dello stile
-        style()->unpolish(this);
-        style()->polish(this);
         update();
     }
 }
 
+void MediaCard::setSfondoSelezione(const QColor& colore)
+{
+    m_sfondoSelezione = colore;
+    if (m_selected) update();
+}
+
+void MediaCard::setBordoSelezione(const QColor& colore)
+{
+    m_bordoSelezione = colore;
+    if (m_selected) update();
+}
+
 bool MediaCard::isSelected() const
 {
     return m_selected;
@@ -82,21 +91,22 @@ void MediaCard::updateContent()
     if (!m_media) return;
     
     try {
-        // Aggiorna i contenuti delle label
+        // Aggiorna i contenuti delle label: i testi vengono ricalcolati solo se il media è cambiato
+        const Media::TestiVisualizzati& testi = m_media->getTestiVisualizzati();
         if (m_titleLabel) {
-            m_titleLabel->setText(truncateText(m_media->getTitolo(), 25));
+            m_titleLabel->setText(testi.titoloBreve);
         }
         if (m_yearLabel) {
             m_yearLabel->setText(QString::number(m_media->getAnno()));
         }
         if (m_descriptionLabel) {
-            m_descriptionLabel->setText(truncateText(m_media->getDescrizione(), 80));
+            m_descriptionLabel->setText(testi.descrizioneBreve);
         }
         if (m_typeLabel) {
             m_typeLabel->setText(m_media->getTypeDisplayName());
         }
         if (m_infoLabel) {
-            m_infoLabel->setText(formatDisplayInfo());
+            m_infoLabel->setText(testi.infoBreve);
         }
         if (m_imageLabel) {
             m_imageLabel->setPixmap(getTypeIcon());
@@ -109,9 +119,9 @@ void MediaCard::updateContent()
 
 void MediaCard::mousePressEvent(QMouseEvent *event)
 {
+    // Lo stato della selezione lo decide la finestra (selezione singola o multipla)
     if (event->button() == Qt::LeftButton) {
-        setSelected(true);
-        emit selezionato(getId());
+        emit selezionato(getId(), event->modifiers());
     }
     QFrame::mousePressEvent(event);
 }
@@ -139,36 +149,49 @@ void MediaCard::leaveEvent(QEvent *event)
 void MediaCard::paintEvent(QPaintEvent *event)
 {
     QFrame::paintEvent(event);
+    
+    if (m_selected) {
+        // Stesso margine (2px) e raggio (8px) del riquadro definito nel CSS
+        QPainter painter(this);
+        painter.setRenderHint(QPainter::Antialiasing);
+        painter.setPen(QPen(m_bordoSelezione, 2));
+        painter.setBrush(m_sfondoSelezione);
+        painter.drawRoundedRect(QRectF(rect()).adjusted(3, 3, -3, -3), 8, 8);
+    }
 }
 
 void MediaCard::setupUI()
 {
     if (!m_media) return;
+    TRACCIA_INTERVALLO("interfaccia", "MediaCard::setupUI");
     
     try {
         setupLayout();
         
+        const Media::TestiVisualizzati& testi = m_media->getTestiVisualizzati();
+        
         // Configurazione delle label
         m_typeLabel = new QLabel(m_media->getTypeDisplayName(), this);
         m_typeLabel->setObjectName("typeLabel");
         
-        m_titleLabel = new QLabel(truncateText(m_media->getTitolo(), 25), this);
+        m_titleLabel = new QLabel(testi.titoloBreve, this);
         m_titleLabel->setObjectName("titleLabel");
         m_titleLabel->setWordWrap(true);
         
         m_yearLabel = new QLabel(QString::number(m_media->getAnno()), this);
         m_yearLabel->setObjectName("yearLabel");
         
-        m_descriptionLabel = new QLabel(truncateText(m_media->getDescrizione(), 80), this);
+        m_descriptionLabel = new QLabel(testi.descrizioneBreve, this);
         m_descriptionLabel->setObjectName("descriptionLabel");
         m_descriptionLabel->setWordWrap(true);
         
         m_imageLabel = new QLabel(this);
         m_imageLabel->setFixedSize(IMAGE_SIZE, IMAGE_SIZE);
-        m_imageLabel->setScaledContents(true);
+        // Il pixmap ha già la dimensione giusta: scalarlo di nuovo costerebbe una copia per label
+        m_imageLabel->setAlignment(Qt::AlignCenter);
         m_imageLabel->setPixmap(getTypeIcon());
         
-        m_infoLabel = new QLabel(formatDisplayInfo(), this);
+        m_infoLabel = new QLabel(testi.infoBreve, this);
         m_infoLabel->setObjectName("infoLabel");
         m_infoLabel->setWordWrap(true);
         
@@ -255,49 +278,11 @@ QPixmap MediaCard::getTypeIcon() const
         return QPixmap();
     }
     
-    QString type = m_media->getTypeDisplayName().toLower();
-
-    QIcon icon;
-    if (type == "libro") {
-        icon = QIcon(":/icons/libro.png");
-    } else if (type == "film") {
-        icon = QIcon(":/icons/film.png");
-    } else if (type == "articolo") {
-        icon = QIcon(":/icons/articolo.png");
-    }
-    
-    // Se l'icona esiste nel resources.qrc, convertila in QPixmap
-    if (!icon.isNull()) {
-        return icon.pixmap(IMAGE_SIZE, IMAGE_SIZE);
-    }
-    
-    // Se non esiste l'icona nel resources.qrc, restituisci un pixmap vuoto
-    return QPixmap();
+    // Pixmap condiviso e già scalato: nessuna decodifica per card
+    return IconeMedia::pixmap(m_media->getTipoMedia(), IMAGE_SIZE, devicePixelRatioF());
 }
 
-QString MediaCard::truncateText(const QString& text, int maxLength) const
+void MediaCard::precaricaIcone(qreal rapportoPixel)
 {
-    if (text.length() <= maxLength) {
-        return text;
-    }
-    return text.left(maxLength - 3) + "...";
+    IconeMedia::precarica(IMAGE_SIZE, rapportoPixel);
 }
-
-QString MediaCard::formatDisplayInfo() const
-{
-    if (!m_media) return QString();
-    
-    try {
-        QString info = m_media->getDisplayInfo();
-
-        QStringList lines = info.split('\n');
-        if (lines.size() > 2) {
-            return lines.mid(0, 2).join('\n') + "...";
-        }
-        
-        return info;
-    } catch (const std::exception& e) {
-        qWarning() << "Errore in formatDisplayInfo:" << e.what();
-        return "Errore nel formato";
-    }
-}
\ No newline at end of file
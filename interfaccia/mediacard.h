@@ -10,6 +10,7 @@
 #include <QFrame>
 #include <QPushButton>
 #include <QPixmap>
+#include <QColor>
 #include <memory>
 
 class Media;
@@ -23,6 +24,9 @@ class Media;
 class MediaCard : public QFrame
 {
     Q_OBJECT
+    // Colori della selezione, impostabili dal CSS con qproperty-sfondoSelezione/qproperty-bordoSelezione
+    Q_PROPERTY(QColor sfondoSelezione READ getSfondoSelezione WRITE setSfondoSelezione)
+    Q_PROPERTY(QColor bordoSelezione READ getBordoSelezione WRITE setBordoSelezione)
 
 public:
     explicit MediaCard(Media* media, QWidget *parent = nullptr);
@@ -32,15 +36,24 @@ public:
     QString getId() const;
     Media* getMedia() const;
     
-    // Gestione selezione
+    // Gestione selezione: disegnata in paintEvent, senza ricalcolare lo stile
     void setSelected(bool selected);
     bool isSelected() const;
     
+    QColor getSfondoSelezione() const { return m_sfondoSelezione; }
+    void setSfondoSelezione(const QColor& colore);
+    QColor getBordoSelezione() const { return m_bordoSelezione; }
+    void setBordoSelezione(const QColor& colore);
+    
     // Aggiornamento contenuto
     void updateContent();
+    
+    // Icone dei tipi decodificate e scalate prima di creare le card
+    static void precaricaIcone(qreal rapportoPixel);
 
 signals:
-    void selezionato(const QString& id);
+    // I modificatori (Ctrl, Shift) distinguono la selezione multipla
+    void selezionato(const QString& id, Qt::KeyboardModifiers modificatori);
     void doppioClick(const QString& id);
 
 protected:
@@ -58,14 +71,12 @@ private:
     // Gestione immagini
     QPixmap getTypeIcon() const;
     
-    // Utility
-    QString truncateText(const QString& text, int maxLength) const;
-    QString formatDisplayInfo() const;
-    
     // Puntatore al media
     Media* m_media;
     bool m_selected;
     bool m_hovered;
+    QColor m_sfondoSelezione;
+    QColor m_bordoSelezione;
     
     // Widgets UI per layout
     QVBoxLayout* m_mainLayout;
@@ -0,0 +1,115 @@
+#include "pannelloprestazioni.h"
+#include "modello_logico/rapportomemoria.h"
+#include <QFile>
+#include <algorithm>
+
+#if defined(Q_OS_LINUX)
+#include <unistd.h>
+#elif defined(Q_OS_WIN)
+#include <windows.h>
+#include <psapi.h>
+#elif defined(Q_OS_MACOS)
+#include <mach/mach.h>
+#endif
+
+PannelloPrestazioni::PannelloPrestazioni(QWidget* parent)
+    : QLabel(parent)
+    , m_operazioni(0)
+{
+    setObjectName("pannelloPrestazioni");
+    setText("Prestazioni: nessuna operazione");
+}
+
+void PannelloPrestazioni::registra(const MisuraOperazione& misura)
+{
+    ++m_operazioni;
+    m_query.aggiungi(misura.nsQuery);
+    m_layout.aggiungi(misura.nsLayout);
+
+    QString esaminati = misura.esaminati >= 0 ? QString::number(misura.esaminati) : QString("n/d");
+    qint64 memoria = memoriaResidente();
+
+    QStringList parti;
+    parti << QString("%1: query %2").arg(misura.nome, millisecondi(misura.nsQuery))
+          << QString("%1 esaminati / %2 trovati").arg(esaminati).arg(misura.corrispondenti)
+          << QString("card %1 nuove").arg(misura.cardCreate)
+          << QString("layout %1").arg(millisecondi(misura.nsLayout));
+    if (memoria >= 0) {
+        parti << QString("RSS %1").arg(RapportoMemoria::formattaByte(memoria));
+    }
+    setText(parti.join(" | "));
+
+    setToolTip(QString("Ultime %1 operazioni (su %2)\nQuery: %3\nLayout: %4")
+                   .arg(m_query.size())
+                   .arg(m_operazioni)
+                   .arg(percentili(m_query))
+                   .arg(percentili(m_layout)));
+}
+
+qint64 PannelloPrestazioni::memoriaResidente()
+{
+#if defined(Q_OS_LINUX)
+    // Seconda colonna di statm: pagine residenti
+    QFile statm("/proc/self/statm");
+    if (!statm.open(QIODevice::ReadOnly)) {
+        return -1;
+    }
+    QList<QByteArray> colonne = statm.readLine().split(' ');
+    if (colonne.size() < 2) {
+        return -1;
+    }
+    return colonne[1].toLongLong() * static_cast<qint64>(sysconf(_SC_PAGESIZE));
+#elif defined(Q_OS_WIN)
+    PROCESS_MEMORY_COUNTERS contatori;
+    if (!GetProcessMemoryInfo(GetCurrentProcess(), &contatori, sizeof(contatori))) {
+        return -1;
+    }
+    return static_cast<qint64>(contatori.WorkingSetSize);
+#elif defined(Q_OS_MACOS)
+    mach_task_basic_info_data_t informazioni;
+    mach_msg_type_number_t quanti = MACH_TASK_BASIC_INFO_COUNT;
+    if (task_info(mach_task_self(), MACH_TASK_BASIC_INFO,
+                  reinterpret_cast<task_info_t>(&informazioni), &quanti) != KERN_SUCCESS) {
+        return -1;
+    }
+    return static_cast<qint64>(informazioni.resident_size);
+#else
+    return -1;
+#endif
+}
+
+// Private methods
+void PannelloPrestazioni::Finestra::aggiungi(qint64 valore)
+{
+    if (m_valori.size() < static_cast<size_t>(FINESTRA_PERCENTILI)) {
+        m_valori.push_back(valore);
+    } else {
+        m_valori[m_prossimo] = valore;
+    }
+    m_prossimo = (m_prossimo + 1) % FINESTRA_PERCENTILI;
+}
+
+qint64 PannelloPrestazioni::Finestra::percentile(int percento) const
+{
+    if (m_valori.empty()) return 0;
+
+    // Nearest-rank su una copia: la finestra è piccola
+    std::vector<qint64> ordinati = m_valori;
+    size_t rango = (static_cast<size_t>(percento) * ordinati.size() + 99) / 100;
+    size_t indice = rango > 0 ? rango - 1 : 0;
+    std::nth_element(ordinati.begin(), ordinati.begin() + indice, ordinati.end());
+    return ordinati[indice];
+}
+
+QString PannelloPrestazioni::millisecondi(qint64 nanosecondi)
+{
+    return QString("%1 ms").arg(static_cast<double>(nanosecondi) / 1e6, 0, 'f', 1);
+}
+
+QString PannelloPrestazioni::percentili(const Finestra& finestra) const
+{
+    return QString("p50 %1, p95 %2, p99 %3")
+        .arg(millisecondi(finestra.percentile(50)),
+             millisecondi(finestra.percentile(95)),
+             millisecondi(finestra.percentile(99)));
+}
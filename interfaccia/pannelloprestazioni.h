@@ -0,0 +1,64 @@
+#ifndef PANNELLOPRESTAZIONI_H
+#define PANNELLOPRESTAZIONI_H
+
+#include <QLabel>
+#include <QString>
+#include <vector>
+
+/**
+ * @brief Misure dell'ultima operazione sulla vista dei media
+ */
+struct MisuraOperazione
+{
+    QString nome;
+    qint64 nsQuery = 0;
+    qint64 esaminati = -1;        // -1 se l'operazione non lo sa (es. ricerca per rilevanza)
+    qint64 corrispondenti = 0;
+    int cardCreate = 0;
+    qint64 nsLayout = 0;
+};
+
+/**
+ * @brief Pannello delle prestazioni nella status bar
+ *
+ * Mostra latenza della query, media esaminati e corrispondenti, card create,
+ * tempo di layout e memoria residente dell'ultima operazione; il
+ * tooltip riporta i percentili (p50/p95/p99) delle ultime operazioni.
+ */
+class PannelloPrestazioni : public QLabel
+{
+    Q_OBJECT
+
+public:
+    explicit PannelloPrestazioni(QWidget* parent = nullptr);
+
+    void registra(const MisuraOperazione& misura);
+
+    // Byte residenti del processo, -1 se la piattaforma non li fornisce
+    static qint64 memoriaResidente();
+
+    static const int FINESTRA_PERCENTILI = 200;
+
+private:
+    // Campioni in un buffer circolare: i percentili valgono per le ultime operazioni
+    class Finestra
+    {
+    public:
+        void aggiungi(qint64 valore);
+        qint64 percentile(int percento) const;
+        int size() const { return static_cast<int>(m_valori.size()); }
+
+    private:
+        std::vector<qint64> m_valori;
+        size_t m_prossimo = 0;
+    };
+
+    static QString millisecondi(qint64 nanosecondi);
+    QString percentili(const Finestra& finestra) const;
+
+    Finestra m_query;
+    Finestra m_layout;
+    qint64 m_operazioni;
+};
+
+#endif
@@ -0,0 +1,124 @@
+#include "selezionecard.h"
+#include "mediacard.h"
+#include <algorithm>
+#include <vector>
+
+SelezioneCard::SelezioneCard(const QList<MediaCard*>& card)
+    : m_card(card)
+{
+}
+
+void SelezioneCard::registra(MediaCard* card, int posizione)
+{
+    if (card) {
+        m_posizioni.insert(card->getId(), posizione);
+    }
+}
+
+void SelezioneCard::azzera()
+{
+    m_posizioni.clear();
+    m_selezionati.clear();
+    m_corrente.clear();
+    m_ancora.clear();
+}
+
+void SelezioneCard::seleziona(const QString& id, Qt::KeyboardModifiers modificatori)
+{
+    if (!m_posizioni.contains(id)) return;
+
+    const bool aggiungi = modificatori & Qt::ControlModifier;
+    const bool intervallo = (modificatori & Qt::ShiftModifier) && !m_ancora.isEmpty();
+
+    if (intervallo) {
+        if (!aggiungi) {
+            deselezionaTutto();
+        }
+        selezionaIntervallo(m_ancora, id);
+        m_corrente = id;
+        return;
+    }
+
+    if (aggiungi) {
+        // Ctrl+clic alterna il media e ne fa la nuova ancora
+        bool selezionato = !m_selezionati.contains(id);
+        imposta(id, selezionato);
+        m_ancora = id;
+        if (selezionato) {
+            m_corrente = id;
+        } else if (m_corrente == id) {
+            m_corrente = m_selezionati.isEmpty() ? QString() : getSelezionati().last();
+        }
+        return;
+    }
+
+    // Clic semplice: solo le card già selezionate vengono ridisegnate
+    if (!(m_selezionati.size() == 1 && m_selezionati.contains(id))) {
+        deselezionaTutto();
+        imposta(id, true);
+    }
+    m_corrente = id;
+    m_ancora = id;
+}
+
+void SelezioneCard::deselezionaTutto()
+{
+    for (const QString& id : m_selezionati) {
+        auto it = m_posizioni.constFind(id);
+        if (it != m_posizioni.constEnd() && it.value() < m_card.size() && m_card[it.value()]) {
+            m_card[it.value()]->setSelected(false);
+        }
+    }
+    m_selezionati.clear();
+    m_corrente.clear();
+}
+
+QStringList SelezioneCard::getSelezionati() const
+{
+    std::vector<std::pair<int, QString>> ordinati;
+    ordinati.reserve(m_selezionati.size());
+    for (const QString& id : m_selezionati) {
+        ordinati.emplace_back(m_posizioni.value(id, -1), id);
+    }
+    std::sort(ordinati.begin(), ordinati.end());
+
+    QStringList risultato;
+    risultato.reserve(static_cast<int>(ordinati.size()));
+    for (const auto& voce : ordinati) {
+        risultato << voce.second;
+    }
+    return risultato;
+}
+
+// Private methods
+void SelezioneCard::imposta(const QString& id, bool selezionato)
+{
+    auto it = m_posizioni.constFind(id);
+    if (it == m_posizioni.constEnd()) return;
+
+    if (selezionato) {
+        m_selezionati.insert(id);
+    } else {
+        m_selezionati.remove(id);
+    }
+
+    int posizione = it.value();
+    if (posizione < m_card.size() && m_card[posizione]) {
+        m_card[posizione]->setSelected(selezionato);
+    }
+}
+
+void SelezioneCard::selezionaIntervallo(const QString& da, const QString& a)
+{
+    int inizio = m_posizioni.value(da, -1);
+    int fine = m_posizioni.value(a, -1);
+    if (inizio < 0 || fine < 0) return;
+    if (inizio > fine) std::swap(inizio, fine);
+
+    for (int i = inizio; i <= fine && i < m_card.size(); ++i) {
+        if (m_card[i] && !m_selezionati.contains(m_card[i]->getId())) {
+            m_selezionati.insert(m_card[i]->getId());
+            m_card[i]->setSelected(true);
+        }
+    }
+}
@@ -0,0 +1,53 @@
+#ifndef SELEZIONECARD_H
+#define SELEZIONECARD_H
+
+#include <QHash>
+#include <QList>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+#include <Qt>
+
+class MediaCard;
+
+/**
+ * @brief Modello di selezione della griglia di card
+ *
+ * Conosce la posizione di ogni card per id, quindi un clic tocca solo le
+ * card che cambiano stato: la vecchia e la nuova selezione, non l'intera
+ * griglia. Supporta la selezione multipla come nelle viste di Qt: Ctrl
+ * aggiunge o toglie un media, Shift seleziona l'intervallo dall'ultimo
+ * clic semplice (l'ancora), Ctrl+Shift aggiunge l'intervallo.
+ */
+class SelezioneCard
+{
+public:
+    explicit SelezioneCard(const QList<MediaCard*>& card);
+
+    // Da chiamare per ogni card aggiunta alla griglia, nell'ordine di visualizzazione
+    void registra(MediaCard* card, int posizione);
+    // Le card stanno per essere distrutte: si dimentica tutto senza toccarle
+    void azzera();
+
+    void seleziona(const QString& id, Qt::KeyboardModifiers modificatori = Qt::NoModifier);
+    void deselezionaTutto();
+
+    // Media su cui agiscono le operazioni singole (ultimo clic), vuoto se nessuno
+    QString getCorrente() const { return m_corrente; }
+    // Media selezionati nell'ordine della griglia
+    QStringList getSelezionati() const;
+    int size() const { return static_cast<int>(m_selezionati.size()); }
+    bool contiene(const QString& id) const { return m_selezionati.contains(id); }
+
+private:
+    void imposta(const QString& id, bool selezionato);
+    void selezionaIntervallo(const QString& da, const QString& a);
+
+    const QList<MediaCard*>& m_card;
+    QHash<QString, int> m_posizioni;
+    QSet<QString> m_selezionati;
+    QString m_corrente;
+    QString m_ancora;
+};
+
+#endif
@@ -0,0 +1,279 @@
+#include "caricamentopigro.h"
+#include <QByteArray>
+#include <QJsonDocument>
+#include <QJsonParseError>
+#include <QMutexLocker>
+#include <cstring>
+
+namespace {
+
+/**
+ * @brief Lettore sequenziale sul testo JSON grezzo
+ *
+ * Riconosce solo la struttura (oggetti, array, stringhe con escape): i valori
+ * vengono saltati e restituiti come intervalli di byte, senza decodifica.
+ */
+class Lettore
+{
+public:
+    Lettore(const char* inizio, const char* fine) : m_p(inizio), m_fine(fine) {}
+
+    void avanza(qint64 n) { m_p += n; }
+    const char* posizione() const { return m_p; }
+
+    void spazi()
+    {
+        while (m_p < m_fine && (*m_p == ' ' || *m_p == '\n' || *m_p == '\r' || *m_p == '\t')) {
+            ++m_p;
+        }
+    }
+
+    bool guarda(char c)
+    {
+        spazi();
+        return m_p < m_fine && *m_p == c;
+    }
+
+    bool consuma(char c)
+    {
+        if (!guarda(c)) {
+            return false;
+        }
+        ++m_p;
+        return true;
+    }
+
+    // Contenuto tra le virgolette, escape compresi
+    bool stringa(const char*& da, const char*& a)
+    {
+        if (!consuma('"')) {
+            return false;
+        }
+        da = m_p;
+        while (m_p < m_fine) {
+            if (*m_p == '\\') {
+                m_p += 2;
+                continue;
+            }
+            if (*m_p == '"') {
+                a = m_p++;
+                return true;
+            }
+            ++m_p;
+        }
+        return false;
+    }
+
+    bool valore()
+    {
+        spazi();
+        if (m_p >= m_fine) {
+            return false;
+        }
+
+        const char* da;
+        const char* a;
+        if (*m_p == '"') {
+            return stringa(da, a);
+        }
+
+        if (*m_p == '{' || *m_p == '[') {
+            // Basta contare la profondità: le parentesi dentro le stringhe sono saltate con esse
+            int profondita = 0;
+            while (m_p < m_fine) {
+                char c = *m_p;
+                if (c == '"') {
+                    if (!stringa(da, a)) {
+                        return false;
+                    }
+                    continue;
+                }
+                if (c == '{' || c == '[') {
+                    ++profondita;
+                } else if ((c == '}' || c == ']') && --profondita == 0) {
+                    ++m_p;
+                    return true;
+                }
+                ++m_p;
+            }
+            return false;
+        }
+
+        // Numeri, true, false, null
+        da = m_p;
+        while (m_p < m_fine && *m_p != ',' && *m_p != '}' && *m_p != ']'
+               && *m_p != ' ' && *m_p != '\n' && *m_p != '\r' && *m_p != '\t') {
+            ++m_p;
+        }
+        return m_p > da;
+    }
+
+private:
+    const char* m_p;
+    const char* m_fine;
+};
+
+bool scansionaArrayMedia(Lettore& lettore, const char* dati,
+                         std::vector<ScansioneCollezione::OggettoMedia>& oggetti, QString& errore)
+{
+    const QStringList& campiFreddi = ScansioneCollezione::getCampiFreddi();
+
+    if (!lettore.consuma('[')) {
+        errore = "Il campo 'media' deve essere un array";
+        return false;
+    }
+    if (lettore.consuma(']')) {
+        return true;
+    }
+
+    do {
+        lettore.spazi();
+        const char* inizio = lettore.posizione();
+        if (!lettore.consuma('{')) {
+            errore = "Elemento dell'array 'media' non valido";
+            return false;
+        }
+
+        // Oggetto ridotto: campi caldi copiati dal testo, campi freddi vuoti
+        // (le chiavi restano, così la validazione del media non cambia)
+        QByteArray caldi("{");
+        if (!lettore.guarda('}')) {
+            do {
+                const char* chiaveDa;
+                const char* chiaveA;
+                if (!lettore.stringa(chiaveDa, chiaveA) || !lettore.consuma(':')) {
+                    errore = "Chiave non valida in un media";
+                    return false;
+                }
+                lettore.spazi();
+                const char* valoreDa = lettore.posizione();
+                if (!lettore.valore()) {
+                    errore = "Valore non valido in un media";
+                    return false;
+                }
+
+                if (caldi.size() > 1) {
+                    caldi.append(',');
+                }
+                caldi.append('"').append(chiaveDa, chiaveA - chiaveDa).append("\":");
+
+                QString chiave = QString::fromUtf8(chiaveDa, chiaveA - chiaveDa);
+                if (!campiFreddi.contains(chiave)) {
+                    caldi.append(valoreDa, lettore.posizione() - valoreDa);
+                } else {
+                    caldi.append(*valoreDa == '[' ? "[]" : "\"\"");
+                }
+            } while (lettore.consuma(','));
+        }
+        if (!lettore.consuma('}')) {
+            errore = "Media non terminato";
+            return false;
+        }
+        caldi.append('}');
+
+        QJsonParseError parsing;
+        QJsonDocument documento = QJsonDocument::fromJson(caldi, &parsing);
+        if (parsing.error != QJsonParseError::NoError || !documento.isObject()) {
+            errore = "Errore di parsing JSON: " + parsing.errorString();
+            return false;
+        }
+        oggetti.push_back({documento.object(), inizio - dati, lettore.posizione() - inizio});
+    } while (lettore.consuma(','));
+
+    if (!lettore.consuma(']')) {
+        errore = "Array 'media' non terminato";
+        return false;
+    }
+    return true;
+}
+
+} // namespace
+
+FileCampiFreddi::FileCampiFreddi(const QString& filename)
+    : m_file(filename)
+{
+}
+
+bool FileCampiFreddi::apri()
+{
+    return m_file.open(QIODevice::ReadOnly);
+}
+
+QJsonObject FileCampiFreddi::leggi(qint64 inizio, qint64 lunghezza) const
+{
+    QByteArray testo;
+    {
+        QMutexLocker locker(&m_mutex);
+        if (!m_file.seek(inizio)) {
+            return QJsonObject();
+        }
+        testo = m_file.read(lunghezza);
+    }
+
+    QJsonParseError errore;
+    QJsonDocument documento = QJsonDocument::fromJson(testo, &errore);
+    if (errore.error != QJsonParseError::NoError || !documento.isObject()) {
+        return QJsonObject();
+    }
+    return documento.object();
+}
+
+bool ScansioneCollezione::scansiona(const char* dati, qint64 dimensione,
+                                    std::vector<OggettoMedia>& oggetti, QString& errore)
+{
+    Lettore lettore(dati, dati + dimensione);
+    if (dimensione >= 3 && std::memcmp(dati, "\xEF\xBB\xBF", 3) == 0) {
+        lettore.avanza(3);
+    }
+
+    if (!lettore.consuma('{')) {
+        errore = "Il documento non è un oggetto JSON";
+        return false;
+    }
+
+    bool trovatoMetadata = false;
+    bool trovatoMedia = false;
+    if (!lettore.guarda('}')) {
+        do {
+            const char* chiaveDa;
+            const char* chiaveA;
+            if (!lettore.stringa(chiaveDa, chiaveA) || !lettore.consuma(':')) {
+                errore = "Chiave non valida nel documento";
+                return false;
+            }
+
+            QByteArray chiave(chiaveDa, static_cast<int>(chiaveA - chiaveDa));
+            if (chiave == "media") {
+                trovatoMedia = true;
+                if (!scansionaArrayMedia(lettore, dati, oggetti, errore)) {
+                    return false;
+                }
+                continue;
+            }
+
+            trovatoMetadata = trovatoMetadata || chiave == "metadata";
+            if (!lettore.valore()) {
+                errore = "Valore non valido nel documento";
+                return false;
+            }
+        } while (lettore.consuma(','));
+    }
+
+    if (!lettore.consuma('}')) {
+        errore = "Documento non terminato";
+        return false;
+    }
+    if (!trovatoMetadata || !trovatoMedia) {
+        errore = "Chiavi 'metadata' o 'media' mancanti";
+        return false;
+    }
+    return true;
+}
+
+const QStringList& ScansioneCollezione::getCampiFreddi()
+{
+    // Autori e attori restano caldi: servono a ordinamento, completamenti, filtri e
+    // validazione per ogni media, e sono brevi. Solo la descrizione è lunga
+    static const QStringList campi = {"descrizione"};
+    return campi;
+}
@@ -0,0 +1,54 @@
+#ifndef CARICAMENTOPIGRO_H
+#define CARICAMENTOPIGRO_H
+
+#include "modello_logico/media.h"
+#include <QFile>
+#include <QJsonObject>
+#include <QMutex>
+#include <QString>
+#include <QStringList>
+#include <vector>
+
+/**
+ * @brief Sorgente dei campi freddi: rilegge un singolo media dal file
+ *
+ * Il file resta aperto in sola lettura; le letture sono serializzate
+ * perché più media possono caricare i propri campi da thread diversi.
+ */
+class FileCampiFreddi : public SorgenteCampiFreddi
+{
+public:
+    explicit FileCampiFreddi(const QString& filename);
+
+    bool apri();
+    QJsonObject leggi(qint64 inizio, qint64 lunghezza) const override;
+
+private:
+    mutable QMutex m_mutex;
+    mutable QFile m_file;
+};
+
+/**
+ * @brief Scansione del file della collezione senza costruire il documento completo
+ *
+ * Individua l'intervallo di byte di ogni oggetto dell'array "media" e ne
+ * interpreta solo i campi caldi; i valori dei campi freddi vengono saltati
+ * senza essere decodificati.
+ */
+class ScansioneCollezione
+{
+public:
+    struct OggettoMedia {
+        QJsonObject campiCaldi;
+        qint64 inizio;
+        qint64 lunghezza;
+    };
+
+    // false se il testo non ha la struttura attesa: in quel caso si usa il caricamento completo
+    static bool scansiona(const char* dati, qint64 dimensione,
+                          std::vector<OggettoMedia>& oggetti, QString& errore);
+
+    static const QStringList& getCampiFreddi();
+};
+
+#endif
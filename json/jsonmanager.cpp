@@ -1,9 +1,12 @@
 #include "jsonmanager.h"
+#include "caricamentopigro.h"
 #include "modello_logico/media.h"
 #include "modello_logico/libro.h"
 #include "modello_logico/film.h"
 #include "modello_logico/articolo.h"
+#include "modello_logico/traccia.h"
 #include <QFile>
+#include <QSaveFile>
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <QJsonArray>
@@ -12,6 +15,7 @@
 #include <QDir>
 #include <QTextStream>
 #include <QDebug>
+#include <algorithm>
 
 // Costanti statiche
 const QString JsonManager::JSON_VERSION = "1.0";
@@ -22,13 +26,32 @@ const QString JsonManager::MEDIA_ARRAY_KEY = "media";
 bool JsonManager::saveCollection(const std::vector<std::unique_ptr<Media>>& collection, 
                                 const QString& filename) const
 {
+    TRACCIA_INTERVALLO("json", "JsonManager::saveCollection");
     clearError();
     
     try {
-        QJsonObject rootObj = collectionToJson(collection);
-        QJsonDocument doc(rootObj);
+        QDir().mkpath(QFileInfo(filename).absolutePath());
         
-        return writeJsonToFile(doc, filename);
+        // File temporaneo rinominato solo alla fine: fino ad allora il file precedente
+        // resta intatto, e i campi freddi dei media possono ancora essere letti da lì
+        QSaveFile file(filename);
+        if (!file.open(QIODevice::WriteOnly)) {
+            setError("Impossibile aprire il file per la scrittura: " + filename);
+            return false;
+        }
+        
+        std::vector<PosizioneMedia> posizioni;
+        if (!scriviCollezione(collection, file, true, &posizioni)) {
+            file.cancelWriting();
+            return false;
+        }
+        if (!file.commit()) {
+            setError("Errore durante la scrittura del file: " + file.errorString());
+            return false;
+        }
+        
+        ripuntaCampiFreddi(filename, posizioni);
+        return true;
     } catch (const std::exception& e) {
         setError(QString("Errore durante il salvataggio: %1").arg(e.what()));
         return false;
@@ -37,6 +60,7 @@ bool JsonManager::saveCollection(const std::vector<std::unique_ptr<Media>>& coll
 
 std::vector<std::unique_ptr<Media>> JsonManager::loadCollection(const QString& filename) const
 {
+    TRACCIA_INTERVALLO("json", "JsonManager::loadCollection");
     clearError();
     
     std::vector<std::unique_ptr<Media>> collection;
@@ -46,6 +70,11 @@ std::vector<std::unique_ptr<Media>> JsonManager::loadCollection(const QString& f
         return collection;
     }
     
+    if (m_caricamentoPigro && QFileInfo(filename).size() >= m_sogliaCaricamentoPigro
+        && loadCollectionPigra(filename, collection)) {
+        return collection;
+    }
+    
     try {
         QJsonDocument doc = readJsonFromFile(filename);
         if (doc.isNull()) {
@@ -71,6 +100,80 @@ std::vector<std::unique_ptr<Media>> JsonManager::loadCollection(const QString& f
     return collection;
 }
 
+bool JsonManager::saveCollectionStream(const std::vector<std::unique_ptr<Media>>& collection,
+                                      QIODevice& uscita, bool prettyFormat) const
+{
+    TRACCIA_INTERVALLO("json", "JsonManager::saveCollectionStream");
+    clearError();
+    return scriviCollezione(collection, uscita, prettyFormat, nullptr);
+}
+
+bool JsonManager::scriviCollezione(const std::vector<std::unique_ptr<Media>>& collection, QIODevice& uscita,
+                                   bool prettyFormat, std::vector<PosizioneMedia>* posizioni) const
+{
+    // Ogni media è serializzato da solo e rientrato come lo farebbe QJsonDocument
+    // sul documento completo; le chiavi restano in ordine alfabetico
+    const QJsonDocument::JsonFormat format = prettyFormat ? QJsonDocument::Indented : QJsonDocument::Compact;
+    const QByteArray aCapo = prettyFormat ? "\n" : "";
+    const int DIMENSIONE_BLOCCO = 1 << 20;
+    
+    auto rientra = [&](QByteArray testo, const QByteArray& rientro) {
+        if (prettyFormat) {
+            testo.chop(1);
+            testo.replace("\n", "\n" + rientro);
+        }
+        return testo;
+    };
+    
+    QByteArray blocco = "{" + aCapo + (prettyFormat ? "    " : "") + "\"" + MEDIA_ARRAY_KEY.toUtf8() + "\":"
+                        + (prettyFormat ? " [" : "[") + aCapo;
+    bool primo = true;
+    qint64 scritti = 0;
+    for (const auto& media : collection) {
+        if (!media) {
+            continue;
+        }
+        if (!primo) {
+            blocco += "," + aCapo;
+        }
+        primo = false;
+        blocco += prettyFormat ? "        " : "";
+        
+        // L'oggetto del media va dalla '{' alla '}': lo stesso intervallo della scansione pigra
+        const qint64 inizio = scritti + blocco.size();
+        blocco += rientra(QJsonDocument(media->toJson()).toJson(format), "        ");
+        if (posizioni) {
+            posizioni->push_back({media.get(), inizio, scritti + blocco.size() - inizio});
+        }
+        
+        if (blocco.size() >= DIMENSIONE_BLOCCO) {
+            if (uscita.write(blocco) != blocco.size()) {
+                setError("Errore durante la scrittura del file");
+                return false;
+            }
+            scritti += blocco.size();
+            blocco.resize(0);
+        }
+    }
+    
+    blocco += aCapo + (prettyFormat ? "    ]," : "],") + aCapo
+              + (prettyFormat ? "    " : "") + "\"" + METADATA_KEY.toUtf8() + "\":" + (prettyFormat ? " " : "")
+              + rientra(QJsonDocument(createMetadata(collection.size())).toJson(format), "    ")
+              + aCapo + "}" + aCapo;
+    
+    if (uscita.write(blocco) != blocco.size()) {
+        setError("Errore durante la scrittura del file");
+        return false;
+    }
+    return true;
+}
+
+void JsonManager::setCaricamentoPigro(bool attivo, qint64 sogliaByte)
+{
+    m_caricamentoPigro = attivo;
+    m_sogliaCaricamentoPigro = sogliaByte;
+}
+
 bool JsonManager::exportToJson(const std::vector<std::unique_ptr<Media>>& collection, 
                               const QString& filename, bool prettyFormat) const
 {
@@ -80,14 +183,7 @@ bool JsonManager::exportToJson(const std::vector<std::unique_ptr<Media>>& collec
     QJsonDocument::JsonFormat format = prettyFormat ? 
         QJsonDocument::Indented : QJsonDocument::Compact;
     
-    QFile file(filename);
-    if (!file.open(QIODevice::WriteOnly)) {
-        setError("Impossibile aprire il file per la scrittura: " + filename);
-        return false;
-    }
-    
-    file.write(doc.toJson(format));
-    return true;
+    return writeJsonToFile(doc, filename, format);
 }
 
 bool JsonManager::exportToCSV(const std::vector<std::unique_ptr<Media>>& collection, 
@@ -108,7 +204,7 @@ bool JsonManager::exportToCSV(const std::vector<std::unique_ptr<Media>>& collect
     for (const auto& media : collection) {
         if (!media) continue;
         
-        QString infoSpecifiche = media->getDisplayInfo().replace('\n', "; ");
+        QString infoSpecifiche = media->getTestiVisualizzati().infoInLinea;
         out << QString("%1,%2,%3,\"%4\",\"%5\"\n")
                .arg(media->getTypeDisplayName())
                .arg(media->getTitolo())
@@ -179,13 +275,7 @@ QJsonObject JsonManager::collectionToJson(const std::vector<std::unique_ptr<Medi
     QJsonObject rootObj;
     
     // Metadata
-    QJsonObject metadata;
-    metadata["versione"] = JSON_VERSION;
-    metadata["data_creazione"] = QDateTime::currentDateTime().toString(Qt::ISODate);
-    metadata["numero_media"] = static_cast<int>(collection.size());
-    metadata["generato_da"] = "Biblioteca Manager";
-    
-    rootObj[METADATA_KEY] = metadata;
+    rootObj[METADATA_KEY] = createMetadata(collection.size());
     
     // Array dei media
     QJsonArray mediaArray;
@@ -200,8 +290,19 @@ QJsonObject JsonManager::collectionToJson(const std::vector<std::unique_ptr<Medi
     return rootObj;
 }
 
+QJsonObject JsonManager::createMetadata(size_t numeroMedia) const
+{
+    QJsonObject metadata;
+    metadata["versione"] = JSON_VERSION;
+    metadata["data_creazione"] = QDateTime::currentDateTime().toString(Qt::ISODate);
+    metadata["numero_media"] = static_cast<qint64>(numeroMedia);
+    metadata["generato_da"] = "Biblioteca Manager";
+    return metadata;
+}
+
 std::vector<std::unique_ptr<Media>> JsonManager::jsonToCollection(const QJsonObject& json) const
 {
+    TRACCIA_INTERVALLO("json", "JsonManager::jsonToCollection");
     std::vector<std::unique_ptr<Media>> collection;
     
     if (!json.contains(MEDIA_ARRAY_KEY)) {
@@ -220,9 +321,56 @@ std::vector<std::unique_ptr<Media>> JsonManager::jsonToCollection(const QJsonObj
         }
     }
     
+    TRACCIA_CONTATORE("json", "media caricati", collection.size());
     return collection;
 }
 
+bool JsonManager::loadCollectionPigra(const QString& filename,
+                                      std::vector<std::unique_ptr<Media>>& collection) const
+{
+    TRACCIA_INTERVALLO("json", "JsonManager::loadCollectionPigra");
+    auto sorgente = std::make_shared<FileCampiFreddi>(filename);
+    QFile file(filename);
+    if (!sorgente->apri() || !file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+    
+    // Il file mappato evita la copia completa in memoria; se la mappatura non
+    // è disponibile si ripiega sulla lettura
+    qint64 dimensione = file.size();
+    uchar* mappa = file.map(0, dimensione);
+    QByteArray contenuto;
+    const char* dati = reinterpret_cast<const char*>(mappa);
+    if (!mappa) {
+        contenuto = file.readAll();
+        dati = contenuto.constData();
+        dimensione = contenuto.size();
+    }
+    
+    std::vector<ScansioneCollezione::OggettoMedia> oggetti;
+    QString errore;
+    bool scansionato = ScansioneCollezione::scansiona(dati, dimensione, oggetti, errore);
+    if (mappa) {
+        file.unmap(mappa);
+    }
+    if (!scansionato) {
+        qWarning() << "Caricamento pigro non disponibile, uso il caricamento completo:" << errore;
+        return false;
+    }
+    
+    collection.reserve(oggetti.size());
+    for (const auto& oggetto : oggetti) {
+        auto media = createMediaFromJson(oggetto.campiCaldi);
+        if (media) {
+            media->setCampiFreddi(sorgente, oggetto.inizio, oggetto.lunghezza);
+            collection.push_back(std::move(media));
+        }
+    }
+    
+    TRACCIA_CONTATORE("json", "media caricati", collection.size());
+    return true;
+}
+
 std::unique_ptr<Media> JsonManager::createMediaFromJson(const QJsonObject& mediaJson) const
 {
     if (!validateMediaJson(mediaJson)) {
@@ -248,7 +396,8 @@ std::unique_ptr<Media> JsonManager::createMediaFromJson(const QJsonObject& media
     }
 }
 
-bool JsonManager::writeJsonToFile(const QJsonDocument& doc, const QString& filename) const
+bool JsonManager::writeJsonToFile(const QJsonDocument& doc, const QString& filename,
+                                  QJsonDocument::JsonFormat format) const
 {
     // Crea la directory se non esiste
     QFileInfo fileInfo(filename);
@@ -257,14 +406,15 @@ bool JsonManager::writeJsonToFile(const QJsonDocument& doc, const QString& filen
         dir.mkpath(".");
     }
     
-    QFile file(filename);
+    // Come in saveCollection: il file di una collezione caricata in modo pigro resta leggibile
+    QSaveFile file(filename);
     if (!file.open(QIODevice::WriteOnly)) {
         setError("Impossibile aprire il file per la scrittura: " + filename);
         return false;
     }
     
-    qint64 bytesWritten = file.write(doc.toJson());
-    bool success = bytesWritten != -1;
+    QByteArray testo = doc.toJson(format);
+    bool success = file.write(testo) == testo.size() && file.commit();
     
     if (!success) {
         setError("Errore durante la scrittura del file");
@@ -273,8 +423,33 @@ bool JsonManager::writeJsonToFile(const QJsonDocument& doc, const QString& filen
     return success;
 }
 
+void JsonManager::ripuntaCampiFreddi(const QString& filename, const std::vector<PosizioneMedia>& posizioni) const
+{
+    // I media con campi ancora da leggere puntano al file sostituito: dopo il rename il
+    // vecchio contenuto resta raggiungibile solo dal descrittore aperto, e va abbandonato
+    bool daRipuntare = std::any_of(posizioni.begin(), posizioni.end(), [](const PosizioneMedia& posizione) {
+        return posizione.media->haCampiFreddiDaCaricare();
+    });
+    if (!daRipuntare) {
+        return;
+    }
+    
+    auto sorgente = std::make_shared<FileCampiFreddi>(filename);
+    if (!sorgente->apri()) {
+        // I riferimenti precedenti restano validi finché il vecchio file è aperto
+        qWarning() << "Impossibile riaprire" << filename << "per i campi freddi";
+        return;
+    }
+    for (const PosizioneMedia& posizione : posizioni) {
+        if (posizione.media->haCampiFreddiDaCaricare()) {
+            posizione.media->setCampiFreddi(sorgente, posizione.inizio, posizione.lunghezza);
+        }
+    }
+}
+
 QJsonDocument JsonManager::readJsonFromFile(const QString& filename) const
 {
+    TRACCIA_INTERVALLO("json", "JsonManager::readJsonFromFile");
     QFile file(filename);
     if (!file.open(QIODevice::ReadOnly)) {
         setError("Impossibile aprire il file per la lettura: " + filename);
@@ -282,6 +457,7 @@ QJsonDocument JsonManager::readJsonFromFile(const QString& filename) const
     }
     
     QByteArray data = file.readAll();
+    TRACCIA_CONTATORE("json", "byte letti", data.size());
     
     QJsonParseError error;
     QJsonDocument doc = QJsonDocument::fromJson(data, &error);
@@ -9,6 +9,7 @@
 #include <memory>
 
 class Media;
+class QIODevice;
 
 /**
  * @brief Classe per gestire la serializzazione/deserializzazione JSON
@@ -22,11 +23,19 @@ public:
     JsonManager() = default;
     ~JsonManager() = default;
     
-    // Salvataggio e caricamento della collezione
+    // Salvataggio e caricamento della collezione. saveCollection scrive su un file temporaneo
+    // e lo rinomina; i media con campi freddi ancora da leggere passano al nuovo file
     bool saveCollection(const std::vector<std::unique_ptr<Media>>& collection, 
                        const QString& filename) const;
     std::vector<std::unique_ptr<Media>> loadCollection(const QString& filename) const;
     
+    // Stesso formato di saveCollection, scritto un media alla volta (memoria costante)
+    bool saveCollectionStream(const std::vector<std::unique_ptr<Media>>& collection,
+                              QIODevice& uscita, bool prettyFormat = true) const;
+    
+    // Oltre la soglia i campi freddi restano nel file fino al primo accesso
+    void setCaricamentoPigro(bool attivo, qint64 sogliaByte = SOGLIA_CARICAMENTO_PIGRO);
+    
     // Esportazione in diversi formati
     bool exportToJson(const std::vector<std::unique_ptr<Media>>& collection, 
                      const QString& filename, bool prettyFormat = true) const;
@@ -43,18 +52,35 @@ public:
     QString getLastError() const;
     void clearError() const;
 
+    static const qint64 SOGLIA_CARICAMENTO_PIGRO = 8 * 1024 * 1024;
+
 private:
+    // Intervallo di byte in cui è stato scritto un media
+    struct PosizioneMedia {
+        Media* media;
+        qint64 inizio;
+        qint64 lunghezza;
+    };
+    
     mutable QString m_lastError;
+    bool m_caricamentoPigro = true;
+    qint64 m_sogliaCaricamentoPigro = SOGLIA_CARICAMENTO_PIGRO;
     
     // Helper methods per serializzazione
     QJsonObject collectionToJson(const std::vector<std::unique_ptr<Media>>& collection) const;
+    QJsonObject createMetadata(size_t numeroMedia) const;
     std::vector<std::unique_ptr<Media>> jsonToCollection(const QJsonObject& json) const;
+    bool loadCollectionPigra(const QString& filename, std::vector<std::unique_ptr<Media>>& collection) const;
+    bool scriviCollezione(const std::vector<std::unique_ptr<Media>>& collection, QIODevice& uscita,
+                          bool prettyFormat, std::vector<PosizioneMedia>* posizioni) const;
+    void ripuntaCampiFreddi(const QString& filename, const std::vector<PosizioneMedia>& posizioni) const;
     
     // Factory method per creare media da JSON
     std::unique_ptr<Media> createMediaFromJson(const QJsonObject& mediaJson) const;
     
     // Utility per file I/O
-    bool writeJsonToFile(const QJsonDocument& doc, const QString& filename) const;
+    bool writeJsonToFile(const QJsonDocument& doc, const QString& filename,
+                         QJsonDocument::JsonFormat format = QJsonDocument::Indented) const;
     QJsonDocument readJsonFromFile(const QString& filename) const;
     
     // Validazione specifica
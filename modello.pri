@@ -0,0 +1,19 @@
+# Collegamento alla libreria del modello logico e della persistenza JSON (nucleo/nucleo.pro),
+# condivisa da applicazione, benchmark e riga di comando. La libreria va compilata prima:
+# biblioteca.pro lo fa da solo, i progetti compilati a parte richiedono nucleo già costruito.
+INCLUDEPATH += $$PWD \
+               $$PWD/modello_logico \
+               $$PWD/json
+
+DEPENDPATH += $$PWD/modello_logico \
+              $$PWD/json
+
+# Stessa opzione della libreria: qmake CONFIG+=traccia
+traccia: DEFINES += BIBLIOTECA_TRACCIA
+
+NUCLEO_DIR = $$shadowed($$PWD)/nucleo
+
+LIBS += -L$$NUCLEO_DIR -lbiblioteca_nucleo
+
+win32-msvc*: PRE_TARGETDEPS += $$NUCLEO_DIR/biblioteca_nucleo.lib
+else: PRE_TARGETDEPS += $$NUCLEO_DIR/libbiblioteca_nucleo.a
@@ -1,4 +1,5 @@
 #include "articolo.h"
+#include "rapportomemoria.h"
 #include <QJsonObject>
 #include <QJsonArray>
 #include <QRegularExpression>
@@ -8,7 +9,7 @@ Articolo::Articolo(const QString& titolo, int anno, const QString& descrizione,
                    const QString& volume, const QString& numero, 
                    const QString& pagine, Categoria categoria, TipoRivista tipo_rivista,
                    const QDate& data_pubblicazione, const QString& doi)
-    : Media(titolo, anno, descrizione), m_autori(autori), m_rivista(rivista),
+    : Media(titolo, anno, descrizione, TipoMedia::Articolo), m_autori(autori), m_rivista(rivista),
       m_volume(volume), m_numero(numero), m_pagine(pagine), m_categoria(categoria),
       m_tipo_rivista(tipo_rivista), m_data_pubblicazione(data_pubblicazione), m_doi(doi)
 {
@@ -18,7 +19,7 @@ Articolo::Articolo(const QString& titolo, int anno, const QString& descrizione,
 }
 
 Articolo::Articolo(const QJsonObject& json)
-    : Media("", 0, "")
+    : Media("", 0, "", TipoMedia::Articolo)
 {
     fromJson(json);
 }
@@ -80,52 +81,61 @@ QString Articolo::getDoi() const
 
 void Articolo::setAutori(const QStringList& autori)
 {
+    invalidaTestiVisualizzati();
     m_autori = autori;
 }
 
 void Articolo::setRivista(const QString& rivista)
 {
+    invalidaTestiVisualizzati();
     m_rivista = rivista;
 }
 
 void Articolo::setVolume(const QString& volume)
 {
+    invalidaTestiVisualizzati();
     m_volume = volume;
 }
 
 void Articolo::setNumero(const QString& numero)
 {
+    invalidaTestiVisualizzati();
     m_numero = numero;
 }
 
 void Articolo::setPagine(const QString& pagine)
 {
+    invalidaTestiVisualizzati();
     m_pagine = pagine;
 }
 
 void Articolo::setCategoria(Categoria categoria)
 {
+    invalidaTestiVisualizzati();
     m_categoria = categoria;
 }
 
 void Articolo::setTipoRivista(TipoRivista tipo_rivista)
 {
+    invalidaTestiVisualizzati();
     m_tipo_rivista = tipo_rivista;
 }
 
 void Articolo::setDataPubblicazione(const QDate& data)
 {
+    invalidaTestiVisualizzati();
     m_data_pubblicazione = data;
 }
 
 void Articolo::setDoi(const QString& doi)
 {
+    invalidaTestiVisualizzati();
     m_doi = doi;
 }
 
 std::unique_ptr<Media> Articolo::clone() const
 {
-    auto cloned = std::make_unique<Articolo>(m_titolo, m_anno, m_descrizione, m_autori, 
+    auto cloned = std::make_unique<Articolo>(m_titolo, m_anno, descrizioneDa(leggiCampiFreddi()), m_autori, 
                                             m_rivista, m_volume, m_numero, m_pagine, 
                                             m_categoria, m_tipo_rivista, m_data_pubblicazione, m_doi);
 
@@ -142,7 +152,7 @@ QJsonObject Articolo::toJson() const
     json["id"] = m_id;
     json["titolo"] = m_titolo;
     json["anno"] = m_anno;
-    json["descrizione"] = m_descrizione;
+    json["descrizione"] = descrizioneDa(leggiCampiFreddi());
     
     QJsonArray autoriArray;
     for (const QString& autore : m_autori) {
@@ -164,6 +174,8 @@ QJsonObject Articolo::toJson() const
 
 void Articolo::fromJson(const QJsonObject& json)
 {
+    scartaCampiFreddi();
+    invalidaTestiVisualizzati();
     m_id = json["id"].toString();
     m_titolo = json["titolo"].toString();
     m_anno = json["anno"].toInt();
@@ -188,12 +200,10 @@ void Articolo::fromJson(const QJsonObject& json)
 QString Articolo::getDisplayInfo() const
 {
     return QString("Autori: %1\nRivista: %2\nVolume: %3, Numero: %4\nPagine: %5\nCategoria: %6\nTipo: %7\nData: %8\nDOI: %9")
-           .arg(m_autori.join(", "))
-           .arg(m_rivista, m_volume, m_numero, m_pagine)
-           .arg(getCategoriaString())
-           .arg(getTipoRivistaString())
-           .arg(m_data_pubblicazione.toString("dd/MM/yyyy"))
-           .arg(m_doi.isEmpty() ? "N/A" : m_doi);
+           .arg(m_autori.join(", "), m_rivista, m_volume, m_numero, m_pagine,
+                getCategoriaString(), getTipoRivistaString(),
+                m_data_pubblicazione.toString("dd/MM/yyyy"),
+                m_doi.isEmpty() ? QString("N/A") : m_doi);
 }
 
 QString Articolo::getTypeDisplayName() const
@@ -220,6 +230,20 @@ bool Articolo::matchesCriteria(const QString& criteria, const QString& value) co
     return false;
 }
 
+QStringList Articolo::getValoriAttributo(const QString& criteria) const
+{
+    if (criteria == "autore") {
+        return m_autori;
+    } else if (criteria == "rivista") {
+        return QStringList{m_rivista};
+    } else if (criteria == "categoria") {
+        return QStringList{getCategoriaString()};
+    } else if (criteria == "doi") {
+        return QStringList{m_doi};
+    }
+    return QStringList();
+}
+
 QString Articolo::categoriaToString(Categoria categoria)
 {
     switch (categoria) {
@@ -304,10 +328,10 @@ bool Articolo::validateSpecificFields() const
            (m_doi.isEmpty() || isValidDoi(m_doi));
 }
 
-QString Articolo::getSearchableText() const
+QString Articolo::getSearchableText(const QJsonObject& freddi) const
 {
     return QString("%1 %2 %3 %4 %5 %6 %7")
-           .arg(m_titolo, m_descrizione)
+           .arg(m_titolo, descrizioneDa(freddi))
            .arg(m_autori.join(" "))
            .arg(m_rivista)
            .arg(getCategoriaString())
@@ -315,17 +339,48 @@ QString Articolo::getSearchableText() const
            .arg(m_doi);
 }
 
+std::vector<CampoRicercabile> Articolo::campiRicercabili(const QJsonObject& freddi) const
+{
+    std::vector<CampoRicercabile> campi = Media::campiRicercabili(freddi);
+    for (const QString& autore : m_autori) {
+        campi.push_back({CampoRicercabile::Persone, autore});
+    }
+    campi.push_back({CampoRicercabile::Altro, m_rivista});
+    campi.push_back({CampoRicercabile::Altro, getCategoriaString()});
+    campi.push_back({CampoRicercabile::Altro, getTipoRivistaString()});
+    campi.push_back({CampoRicercabile::Altro, m_doi});
+    return campi;
+}
+
+void Articolo::stimaMemoria(RapportoMemoria& rapporto) const
+{
+    Media::stimaMemoria(rapporto);
+    
+    const QString tipo = getTypeDisplayName();
+    // La data vive dentro l'oggetto: la si separa per mostrarne il peso
+    rapporto.aggiungiCampo(tipo, "oggetto", RapportoMemoria::Struttura,
+                           RapportoMemoria::byteAllocazione(sizeof(Articolo)) - static_cast<qint64>(sizeof(QDate)));
+    rapporto.aggiungiCampo(tipo, "data_pubblicazione", RapportoMemoria::Date, sizeof(QDate));
+    rapporto.aggiungiCampo(tipo, "autori", RapportoMemoria::Liste, RapportoMemoria::byteLista(m_autori));
+    rapporto.aggiungiCampo(tipo, "rivista", RapportoMemoria::Stringhe, RapportoMemoria::byteStringa(m_rivista));
+    rapporto.aggiungiCampo(tipo, "volume", RapportoMemoria::Stringhe, RapportoMemoria::byteStringa(m_volume));
+    rapporto.aggiungiCampo(tipo, "numero", RapportoMemoria::Stringhe, RapportoMemoria::byteStringa(m_numero));
+    rapporto.aggiungiCampo(tipo, "pagine", RapportoMemoria::Stringhe, RapportoMemoria::byteStringa(m_pagine));
+    rapporto.aggiungiCampo(tipo, "doi", RapportoMemoria::Stringhe, RapportoMemoria::byteStringa(m_doi));
+}
+
 bool Articolo::isValidDoi(const QString& doi) const
 {
     if (doi.isEmpty()) return true;
     
-    QRegularExpression doiPattern("^10\\.\\d{4,}/\\S+$");
+    // Compilate una volta sola; QRegularExpression può essere usata da più thread
+    static const QRegularExpression doiPattern("^10\\.\\d{4,}/\\S+$");
     return doiPattern.match(doi).hasMatch();
 }
 
 int Articolo::calculatePageCount() const
 {
-    QRegularExpression pageRange("(\\d+)-(\\d+)");
+    static const QRegularExpression pageRange("(\\d+)-(\\d+)");
     QRegularExpressionMatch match = pageRange.match(m_pagine);
     
     if (match.hasMatch()) {
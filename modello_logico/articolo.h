@@ -74,6 +74,8 @@ public:
     QString getDisplayInfo() const override;
     QString getTypeDisplayName() const override;
     bool matchesCriteria(const QString& criteria, const QString& value) const override;
+    QStringList getValoriAttributo(const QString& criteria) const override;
+    void stimaMemoria(RapportoMemoria& rapporto) const override;
     
     // Utility statiche
     static QString categoriaToString(Categoria categoria);
@@ -85,7 +87,8 @@ public:
 
 protected:
     bool validateSpecificFields() const override;
-    QString getSearchableText() const override;
+    QString getSearchableText(const QJsonObject& freddi) const override;
+    std::vector<CampoRicercabile> campiRicercabili(const QJsonObject& freddi) const override;
 
 private:
     QStringList m_autori;
@@ -0,0 +1,227 @@
+#include "cachefiltri.h"
+#include "programmafiltro.h"
+#include "media.h"
+#include <QStringList>
+#include <algorithm>
+#include <typeinfo>
+
+namespace {
+
+// Valore con la lunghezza in testa: nessun carattere dell'operando può confondere la chiave
+QString quotaValore(const QString& valore)
+{
+    return QString("%1:%2").arg(valore.size()).arg(valore);
+}
+
+void raccogliChiavi(const FiltroStrategy& filtro, FiltroComposto::Operatore operatore, QStringList& chiavi);
+
+QString chiaveNodo(const FiltroStrategy& filtro)
+{
+    if (auto composto = dynamic_cast<const FiltroComposto*>(&filtro)) {
+        if (composto->isEmpty()) {
+            return "*";
+        }
+
+        // AND e OR sono associativi, commutativi e idempotenti
+        QStringList chiavi;
+        raccogliChiavi(filtro, composto->getOperatore(), chiavi);
+        chiavi.sort();
+        chiavi.removeDuplicates();
+        if (chiavi.size() == 1) {
+            return chiavi.first();
+        }
+        QString simbolo = composto->getOperatore() == FiltroComposto::Or ? "|" : "&";
+        return simbolo + "(" + chiavi.join(",") + ")";
+    }
+
+    if (auto negato = dynamic_cast<const FiltroNegato*>(&filtro)) {
+        return negato->getFiltro() ? "!(" + chiaveNodo(*negato->getFiltro()) + ")" : "!()";
+    }
+
+    if (auto filtroTipo = dynamic_cast<const FiltroTipo*>(&filtro)) {
+        return "T" + quotaValore(filtroTipo->getTipo().toLower());
+    }
+
+    if (auto filtroAnno = dynamic_cast<const FiltroAnno*>(&filtro)) {
+        return QString("Y%1..%2").arg(filtroAnno->getAnnoMin()).arg(filtroAnno->getAnnoMax());
+    }
+
+    if (auto criterio = dynamic_cast<const FiltroCriterio*>(&filtro)) {
+        QString valore = criterio->getValore();
+        if (criterio->getModalita() != FiltroCriterio::Contiene) {
+            valore = FiltroCriterio::normalizzaValore(valore);
+        } else if (criterio->getCriterio() != "isbn" && criterio->getCriterio() != "doi") {
+            valore = valore.toLower();
+        }
+        return QString("C%1%2=%3").arg(static_cast<int>(criterio->getModalita()))
+                                  .arg(criterio->getCriterio(), quotaValore(valore));
+    }
+
+    if (auto testo = dynamic_cast<const FiltroTesto*>(&filtro)) {
+        return "S" + quotaValore(testo->getTesto().toLower());
+    }
+
+    // Filtri non noti: la descrizione, distinta per classe
+    return QString("?%1:%2").arg(QString(typeid(filtro).name()), quotaValore(filtro.getDescription()));
+}
+
+void raccogliChiavi(const FiltroStrategy& filtro, FiltroComposto::Operatore operatore, QStringList& chiavi)
+{
+    // I composti annidati con lo stesso operatore si appiattiscono nel padre
+    auto composto = dynamic_cast<const FiltroComposto*>(&filtro);
+    if (composto && !composto->isEmpty() && composto->getOperatore() == operatore) {
+        for (const auto& figlio : composto->getFiltri()) {
+            raccogliChiavi(*figlio, operatore, chiavi);
+        }
+        return;
+    }
+    chiavi << chiaveNodo(filtro);
+}
+
+} // namespace
+
+CacheFiltri::CacheFiltri(int capacita)
+    : m_capacita(qMax(1, capacita)), m_orologio(0), m_posizioniTotali(0)
+{
+}
+
+CacheFiltri::~CacheFiltri() = default;
+
+QString CacheFiltri::chiaveCanonica(const FiltroStrategy& filtro)
+{
+    return chiaveNodo(filtro);
+}
+
+const PosizioniMedia* CacheFiltri::cerca(const QString& chiave, quint64 generazione)
+{
+    auto it = m_voci.find(chiave);
+    if (it == m_voci.end()) {
+        return nullptr;
+    }
+    if (it->generazione != generazione) {
+        m_posizioniTotali -= it->posizioni.size();
+        m_voci.erase(it);
+        return nullptr;
+    }
+
+    it->ultimoUso = ++m_orologio;
+    return &it->posizioni;
+}
+
+void CacheFiltri::inserisci(const QString& chiave, std::shared_ptr<const ProgrammaFiltro> programma,
+                            PosizioniMedia posizioni, quint64 generazione)
+{
+    if (!programma || posizioni.size() > MAX_POSIZIONI) {
+        return;
+    }
+
+    auto esistente = m_voci.find(chiave);
+    if (esistente != m_voci.end()) {
+        m_posizioniTotali -= esistente->posizioni.size();
+        m_voci.erase(esistente);
+    }
+    while (!m_voci.isEmpty() &&
+           (m_voci.size() >= m_capacita || m_posizioniTotali + posizioni.size() > MAX_POSIZIONI)) {
+        eliminaMenoRecente();
+    }
+
+    m_posizioniTotali += posizioni.size();
+    VoceCache voce;
+    voce.programma = std::move(programma);
+    voce.posizioni = std::move(posizioni);
+    voce.generazione = generazione;
+    voce.ultimoUso = ++m_orologio;
+    m_voci.insert(chiave, voce);
+}
+
+void CacheFiltri::mediaAggiunto(size_t posizione, const Media& media, quint64 generazione)
+{
+    scartaObsolete(generazione);
+    uint32_t pos = static_cast<uint32_t>(posizione);
+
+    for (auto it = m_voci.begin(); it != m_voci.end(); ++it) {
+        PosizioniMedia& posizioni = it->posizioni;
+        // Di norma l'aggiunta è in coda e lo spostamento non tocca nulla
+        auto da = std::lower_bound(posizioni.begin(), posizioni.end(), pos);
+        for (auto p = da; p != posizioni.end(); ++p) {
+            ++*p;
+        }
+        if (it->programma->esegui(&media)) {
+            posizioni.insert(da, pos);
+            ++m_posizioniTotali;
+        }
+        it->generazione = generazione;
+    }
+}
+
+void CacheFiltri::mediaRimosso(size_t posizione, quint64 generazione)
+{
+    scartaObsolete(generazione);
+    uint32_t pos = static_cast<uint32_t>(posizione);
+
+    for (auto it = m_voci.begin(); it != m_voci.end(); ++it) {
+        PosizioniMedia& posizioni = it->posizioni;
+        auto da = std::lower_bound(posizioni.begin(), posizioni.end(), pos);
+        if (da != posizioni.end() && *da == pos) {
+            da = posizioni.erase(da);
+            --m_posizioniTotali;
+        }
+        for (auto p = da; p != posizioni.end(); ++p) {
+            --*p;
+        }
+        it->generazione = generazione;
+    }
+}
+
+void CacheFiltri::mediaAggiornato(size_t posizione, const Media& media, quint64 generazione)
+{
+    scartaObsolete(generazione);
+    uint32_t pos = static_cast<uint32_t>(posizione);
+
+    for (auto it = m_voci.begin(); it != m_voci.end(); ++it) {
+        PosizioniMedia& posizioni = it->posizioni;
+        auto da = std::lower_bound(posizioni.begin(), posizioni.end(), pos);
+        bool presente = da != posizioni.end() && *da == pos;
+        bool accettato = it->programma->esegui(&media);
+        if (accettato && !presente) {
+            posizioni.insert(da, pos);
+            ++m_posizioniTotali;
+        } else if (!accettato && presente) {
+            posizioni.erase(da);
+            --m_posizioniTotali;
+        }
+        it->generazione = generazione;
+    }
+}
+
+void CacheFiltri::svuota()
+{
+    m_voci.clear();
+    m_posizioniTotali = 0;
+}
+
+// Private methods
+void CacheFiltri::scartaObsolete(quint64 generazione)
+{
+    for (auto it = m_voci.begin(); it != m_voci.end();) {
+        if (it->generazione + 1 != generazione) {
+            m_posizioniTotali -= it->posizioni.size();
+            it = m_voci.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+void CacheFiltri::eliminaMenoRecente()
+{
+    // Cache piccola: scansione lineare, come in ParserFiltri
+    auto vecchia = m_voci.begin();
+    for (auto voce = m_voci.begin(); voce != m_voci.end(); ++voce) {
+        if (voce->ultimoUso < vecchia->ultimoUso) {
+            vecchia = voce;
+        }
+    }
+    m_posizioniTotali -= vecchia->posizioni.size();
+    m_voci.erase(vecchia);
+}
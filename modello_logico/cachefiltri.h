@@ -0,0 +1,68 @@
+#ifndef CACHEFILTRI_H
+#define CACHEFILTRI_H
+
+#include "filtrostrategy.h"
+#include "pianificatorefiltri.h"
+#include <QHash>
+#include <QString>
+#include <memory>
+
+class Media;
+class ProgrammaFiltro;
+
+/**
+ * @brief Cache LRU dei risultati dei filtri
+ *
+ * Le voci sono indicizzate dalla forma canonica dell'albero (figli di AND/OR
+ * ordinati e senza duplicati, operandi normalizzati), così filtri equivalenti
+ * costruiti in ordine diverso condividono il risultato. Ogni voce ricorda la
+ * generazione della collezione per cui è valida: Collezione la incrementa a
+ * ogni modifica e notifica la cache, che corregge le voci in place
+ * rivalutando il solo media modificato. Una voce rimasta indietro di più di
+ * una generazione non viene mai restituita.
+ */
+class CacheFiltri
+{
+public:
+    explicit CacheFiltri(int capacita = CAPACITA_DEFAULT);
+    ~CacheFiltri();
+
+    // nullptr se il filtro non è in cache per la generazione indicata
+    const PosizioniMedia* cerca(const QString& chiave, quint64 generazione);
+    void inserisci(const QString& chiave, std::shared_ptr<const ProgrammaFiltro> programma,
+                   PosizioniMedia posizioni, quint64 generazione);
+
+    // Notifiche dalla collezione, già con la generazione successiva alla modifica
+    void mediaAggiunto(size_t posizione, const Media& media, quint64 generazione);
+    void mediaRimosso(size_t posizione, quint64 generazione);
+    void mediaAggiornato(size_t posizione, const Media& media, quint64 generazione);
+
+    void svuota();
+    int dimensione() const { return m_voci.size(); }
+    size_t getPosizioniTotali() const { return m_posizioniTotali; }
+
+    static QString chiaveCanonica(const FiltroStrategy& filtro);
+
+    static const int CAPACITA_DEFAULT = 32;
+    // Limite complessivo sulle posizioni memorizzate (4 byte ciascuna)
+    static const size_t MAX_POSIZIONI = 4 * 1024 * 1024;
+
+private:
+    struct VoceCache {
+        std::shared_ptr<const ProgrammaFiltro> programma;
+        PosizioniMedia posizioni;
+        quint64 generazione;
+        quint64 ultimoUso;
+    };
+
+    // Scarta le voci che non erano aggiornate alla generazione precedente
+    void scartaObsolete(quint64 generazione);
+    void eliminaMenoRecente();
+
+    int m_capacita;
+    quint64 m_orologio;
+    size_t m_posizioniTotali;
+    QHash<QString, VoceCache> m_voci;
+};
+
+#endif
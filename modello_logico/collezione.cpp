@@ -3,13 +3,30 @@
 #include "libro.h"
 #include "film.h"
 #include "articolo.h"
+#include "statistichecollezione.h"
+#include "indicecollezione.h"
+#include "indicecompletamento.h"
+#include "indicetestuale.h"
+#include "testoricerca.h"
+#include "parserfiltri.h"
+#include "programmafiltro.h"
+#include "cachefiltri.h"
+#include "cursoremedia.h"
 #include <algorithm>
 #include <QDebug>
-#include <set>
 
 Collezione::Collezione(QObject* parent)
-    : QObject(parent), m_jsonManager(std::make_unique<JsonManager>())
+    : QObject(parent), m_jsonManager(std::make_unique<JsonManager>()),
+      m_indice(std::make_unique<IndiceCollezione>(m_media)),
+      m_indiceTestuale(std::make_unique<IndiceTestuale>(m_media)),
+      m_ordinamento(std::make_unique<OrdinamentoMedia>(m_media)),
+      m_completamenti(std::make_unique<CompletamentiCollezione>()),
+      m_parser(std::make_unique<ParserFiltri>()),
+      m_cacheFiltri(std::make_unique<CacheFiltri>()),
+      m_generazione(0),
+      m_esaminatiUltimoFiltro(0)
 {
+    m_indice->setIndiceTestuale(m_indiceTestuale.get());
 }
 
 Collezione::~Collezione() = default;
@@ -30,6 +47,14 @@ void Collezione::addMedia(std::unique_ptr<Media> media)
     QString id = media->getId();
     m_media.push_back(std::move(media));
     
+    // L'aggiunta in coda non sposta le posizioni: l'indice si aggiorna in place
+    m_statistiche.reset();
+    m_indice->mediaAggiunto(m_media.size() - 1);
+    m_indiceTestuale->mediaAggiunto(m_media.size() - 1);
+    m_ordinamento->mediaAggiunto(m_media.size() - 1);
+    m_completamenti->mediaAggiunto(*m_media.back());
+    m_cacheFiltri->mediaAggiunto(m_media.size() - 1, *m_media.back(), ++m_generazione);
+    
     emit mediaAdded(id);
 }
 
@@ -37,7 +62,11 @@ bool Collezione::removeMedia(const QString& id)
 {
     auto it = findMediaIterator(id);
     if (it != m_media.end()) {
+        size_t posizione = static_cast<size_t>(it - m_media.begin());
+        m_completamenti->mediaRimosso(**it);
         m_media.erase(it);
+        invalidaStrutture();
+        m_cacheFiltri->mediaRimosso(posizione, ++m_generazione);
         emit mediaRemoved(id);
         return true;
     }
@@ -56,7 +85,11 @@ bool Collezione::updateMedia(const QString& id, std::unique_ptr<Media> updatedMe
     
     auto it = findMediaIterator(id);
     if (it != m_media.end()) {
+        m_completamenti->mediaRimosso(**it);
+        m_completamenti->mediaAggiunto(*updatedMedia);
         *it = std::move(updatedMedia);
+        invalidaStrutture();
+        m_cacheFiltri->mediaAggiornato(static_cast<size_t>(it - m_media.begin()), **it, ++m_generazione);
         emit mediaUpdated(id);
         return true;
     }
@@ -103,6 +136,17 @@ std::vector<Media*> Collezione::searchMedia(const QString& searchText) const
         return result;
     }
     
+    if (TestoRicerca::soloParole(searchText)) {
+        // Ogni parola cercata è contenuta in un termine dell'indice: si verificano solo quei
+        // media, così le descrizioni compresse degli altri non vengono decompresse
+        for (uint32_t posizione : m_indiceTestuale->mediaConParole(searchText)) {
+            if (m_media[posizione]->matchesFilter(searchText)) {
+                result.push_back(m_media[posizione].get());
+            }
+        }
+        return result;
+    }
+    
     for (const auto& media : m_media) {
         if (media->matchesFilter(searchText)) {
             result.push_back(media.get());
@@ -112,23 +156,151 @@ std::vector<Media*> Collezione::searchMedia(const QString& searchText) const
     return result;
 }
 
-std::vector<Media*> Collezione::filterMedia(std::unique_ptr<FiltroStrategy> strategy) const
+std::vector<Media*> Collezione::searchMediaApprossimata(const QString& searchText, size_t massimo) const
 {
     std::vector<Media*> result;
     
+    // Tollera errori di battitura; i risultati sono ordinati per rilevanza
+    for (const auto& risultato : m_indiceTestuale->cercaApprossimata(searchText, massimo)) {
+        result.push_back(m_media[risultato.posizione].get());
+    }
+    
+    return result;
+}
+
+RisultatiRicerca Collezione::cercaApprossimata(const QString& searchText, size_t massimo) const
+{
+    std::vector<RisultatoRicerca> risultati;
+    for (const auto& risultato : m_indiceTestuale->cercaApprossimata(searchText, massimo)) {
+        risultati.push_back({m_media[risultato.posizione].get(), risultato.punteggio, risultato.posizione});
+    }
+    return RisultatiRicerca(std::move(risultati));
+}
+
+RisultatiRicerca Collezione::cercaPerRilevanza(const QString& searchText) const
+{
+    // Il punteggio BM25 dà l'ordine (0 se nessuna parola intera coincide)
+    auto punteggi = m_indiceTestuale->punteggiRilevanza(searchText);
+    std::sort(punteggi.begin(), punteggi.end(),
+              [](const IndiceTestuale::Risultato& a, const IndiceTestuale::Risultato& b) {
+                  return a.posizione < b.posizione;
+              });
+    
+    std::vector<uint32_t> candidati;
+    if (TestoRicerca::soloParole(searchText)) {
+        // Solo parole: i media vengono dal vocabolario dell'indice, ogni parola contenuta in
+        // un termine (in AND), senza leggere descrizioni compresse né campi freddi
+        candidati = m_indiceTestuale->mediaConParole(searchText);
+    } else {
+        // Punteggiatura e simboli ("c++", "2001 - odissea"): sottostringa sul testo completo
+        for (size_t i = 0; i < m_media.size(); ++i) {
+            if (m_media[i]->matchesFilter(searchText)) {
+                candidati.push_back(static_cast<uint32_t>(i));
+            }
+        }
+    }
+    
+    std::vector<RisultatoRicerca> risultati;
+    risultati.reserve(candidati.size());
+    auto punteggio = punteggi.cbegin();
+    for (uint32_t i : candidati) {
+        while (punteggio != punteggi.cend() && punteggio->posizione < i) {
+            ++punteggio;
+        }
+        double valore = (punteggio != punteggi.cend() && punteggio->posizione == i) ? punteggio->punteggio : 0.0;
+        risultati.push_back({m_media[i].get(), valore, i});
+    }
+    
+    return RisultatiRicerca(std::move(risultati));
+}
+
+std::vector<Media*> Collezione::filterMedia(std::unique_ptr<FiltroStrategy> strategy) const
+{
     if (!strategy) {
-        return result;
+        return std::vector<Media*>();
     }
     
-    for (const auto& media : m_media) {
-        if (strategy->matches(media.get())) {
-            result.push_back(media.get());
+    // Filtri equivalenti condividono la voce; la cache è già allineata all'ultima modifica
+    QString chiave = CacheFiltri::chiaveCanonica(*strategy);
+    const PosizioniMedia* inCache = m_cacheFiltri->cerca(chiave, m_generazione);
+    if (inCache) {
+        m_esaminatiUltimoFiltro = 0;
+        std::vector<Media*> result;
+        result.reserve(inCache->size());
+        for (uint32_t posizione : *inCache) {
+            result.push_back(m_media[posizione].get());
         }
+        return result;
     }
     
+    PianoFiltro piano = pianificaFiltro(*strategy);
+    
+    // Il piano viene abbassato a un programma piatto prima di scorrere i media
+    auto programma = std::make_shared<const ProgrammaFiltro>(*piano.filtro);
+    PosizioniMedia posizioni = piano.usaCandidati ? programma->seleziona(m_media, piano.candidati)
+                                                  : programma->seleziona(m_media);
+    m_esaminatiUltimoFiltro = piano.usaCandidati ? piano.candidati.size() : m_media.size();
+    
+    std::vector<Media*> result;
+    result.reserve(posizioni.size());
+    for (uint32_t posizione : posizioni) {
+        result.push_back(m_media[posizione].get());
+    }
+    m_cacheFiltri->inserisci(chiave, std::move(programma), std::move(posizioni), m_generazione);
     return result;
 }
 
+std::unique_ptr<CursoreMedia> Collezione::apriCursore(std::unique_ptr<FiltroStrategy> strategy) const
+{
+    return std::make_unique<CursoreMedia>(*this, std::move(strategy));
+}
+
+size_t Collezione::contaMedia(std::unique_ptr<FiltroStrategy> strategy) const
+{
+    if (!strategy) {
+        return m_media.size();
+    }
+    
+    const PosizioniMedia* inCache = m_cacheFiltri->cerca(CacheFiltri::chiaveCanonica(*strategy), m_generazione);
+    if (inCache) {
+        return inCache->size();
+    }
+    
+    PianoFiltro piano = pianificaFiltro(*strategy);
+    ProgrammaFiltro programma(*piano.filtro);
+    return piano.usaCandidati ? programma.conta(m_media, piano.candidati) : programma.conta(m_media);
+}
+
+PianoFiltro Collezione::pianificaFiltro(const FiltroStrategy& filtro) const
+{
+    PianificatoreFiltri pianificatore(getStatistiche(), m_indice.get());
+    return pianificatore.pianifica(filtro);
+}
+
+std::unique_ptr<FiltroStrategy> Collezione::compilaQuery(const QString& query, QString* errore) const
+{
+    return m_parser->compila(query, errore);
+}
+
+std::vector<Media*> Collezione::cercaConQuery(const QString& query, QString* errore) const
+{
+    auto filtro = compilaQuery(query, errore);
+    if (!filtro) {
+        return std::vector<Media*>();
+    }
+    return filterMedia(std::move(filtro));
+}
+
+void Collezione::ordina(std::vector<Media*>& media, const std::vector<CriterioOrdinamento>& criteri) const
+{
+    m_ordinamento->ordina(media, criteri);
+}
+
+QStringList Collezione::completa(const QString& campo, const QString& prefisso, int massimo) const
+{
+    return m_completamenti->completa(campo, prefisso, massimo);
+}
+
 size_t Collezione::size() const
 {
     return m_media.size();
@@ -141,12 +313,43 @@ bool Collezione::isEmpty() const
 
 size_t Collezione::countByType(const QString& type) const
 {
-    return static_cast<size_t>(
-        std::count_if(m_media.begin(), m_media.end(),
-                     [&type](const std::unique_ptr<Media>& media) {
-                         return media->getTypeDisplayName().toLower() == type.toLower();
-                     })
-    );
+    // Solo conteggio: il filtro per tipo si risolve sull'indice senza scorrere i media
+    return contaMedia(FiltroFactory::createTipoFiltro(type));
+}
+
+RapportoMemoria Collezione::getRapportoMemoria() const
+{
+    RapportoMemoria rapporto;
+    for (const auto& media : m_media) {
+        if (media) {
+            media->stimaMemoria(rapporto);
+        }
+    }
+    
+    rapporto.aggiungiContenitore("vettore dei media", RapportoMemoria::byteAllocazione(
+        static_cast<qint64>(m_media.capacity() * sizeof(std::unique_ptr<Media>))));
+    if (m_cacheFiltri) {
+        rapporto.aggiungiContenitore("cache dei filtri", RapportoMemoria::byteAllocazione(
+            static_cast<qint64>(m_cacheFiltri->getPosizioniTotali() * sizeof(uint32_t))));
+    }
+    
+    // Strutture derivate: contano solo le parti già costruite
+    rapporto.aggiungiContenitore("indici per tipo e attributo", m_indice->byteOccupati());
+    rapporto.aggiungiContenitore("indice testuale", m_indiceTestuale->byteOccupati());
+    rapporto.aggiungiContenitore("chiavi di ordinamento", m_ordinamento->byteOccupati());
+    rapporto.aggiungiContenitore("completamenti", m_completamenti->byteOccupati());
+    if (m_parser) {
+        rapporto.aggiungiContenitore("cache delle query", m_parser->byteOccupati());
+    }
+    return rapporto;
+}
+
+const StatisticheCollezione& Collezione::getStatistiche() const
+{
+    if (!m_statistiche) {
+        m_statistiche = std::make_unique<StatisticheCollezione>(m_media);
+    }
+    return *m_statistiche;
 }
 
 bool Collezione::saveToFile(const QString& filename) const
@@ -160,6 +363,10 @@ bool Collezione::loadFromFile(const QString& filename)
     if (!loadedMedia.empty()) {
         clear();
         m_media = std::move(loadedMedia);
+        invalidaStrutture();
+        m_completamenti->ricostruisci(m_media);
+        m_cacheFiltri->svuota();
+        ++m_generazione;
         
         // Aggiorna i contatori degli ID in base ai media caricati
         updateIdCountersFromCollection();
@@ -170,58 +377,35 @@ bool Collezione::loadFromFile(const QString& filename)
     return false;
 }
 
+QString Collezione::getLastError() const
+{
+    return m_jsonManager->getLastError();
+}
+
 void Collezione::clear()
 {
     m_media.clear();
+    invalidaStrutture();
+    m_completamenti->ricostruisci(m_media);
+    m_cacheFiltri->svuota();
+    ++m_generazione;
     emit collectionCleared();
 }
 
 bool Collezione::isValidCollection() const
 {
-    // Verifica che tutti i media siano validi e abbiano ID unici
-    std::set<QString> ids;
-    
-    for (const auto& media : m_media) {
-        if (!media || !media->isCompleteAndValid()) {
-            return false;
-        }
-        
-        if (ids.find(media->getId()) != ids.end()) {
-            return false;
-        }
-        
-        ids.insert(media->getId());
-    }
-    
-    return true;
+    // Tutti i media validi e con ID unici; gli avvisi non rendono invalida la collezione
+    return valida().isValido();
 }
 
 QStringList Collezione::getValidationErrors() const
 {
-    QStringList errors;
-    std::set<QString> ids;
-    
-    for (size_t i = 0; i < m_media.size(); ++i) {
-        const auto& media = m_media[i];
-        
-        if (!media) {
-            errors << QString("Media #%1: Puntatore nullo").arg(i);
-            continue;
-        }
-        
-        if (!media->isCompleteAndValid()) {
-            errors << QString("Media #%1 (%2): Dati non validi").arg(i).arg(media->getTitolo());
-        }
-        
-        const QString& id = media->getId();
-        if (ids.find(id) != ids.end()) {
-            errors << QString("Media #%1 (%2): ID duplicato").arg(i).arg(media->getTitolo());
-        } else {
-            ids.insert(id);
-        }
-    }
-    
-    return errors;
+    return valida().getMessaggi(ProblemaValidazione::Errore);
+}
+
+RapportoValidazione Collezione::valida(int numeroThread) const
+{
+    return ValidatoreCollezione(numeroThread).valida(m_media);
 }
 
 void Collezione::updateIdCountersFromCollection()
@@ -275,6 +459,14 @@ Collezione::Iterator Collezione::end() const
 }
 
 // Private methods
+void Collezione::invalidaStrutture()
+{
+    m_statistiche.reset();
+    m_indice->invalida();
+    m_indiceTestuale->invalida();
+    m_ordinamento->invalida();
+}
+
 bool Collezione::isIdUnique(const QString& id) const
 {
     return std::none_of(m_media.begin(), m_media.end(),
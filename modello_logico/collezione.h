@@ -3,12 +3,24 @@
 
 #include "media.h"
 #include "filtrostrategy.h"
+#include "pianificatorefiltri.h"
+#include "risultatiricerca.h"
+#include "ordinamentomedia.h"
+#include "rapportomemoria.h"
+#include "validatorecollezione.h"
 #include <QObject>
 #include <vector>
 #include <memory>
 #include <functional>
 
 class JsonManager;
+class StatisticheCollezione;
+class IndiceCollezione;
+class CompletamentiCollezione;
+class IndiceTestuale;
+class ParserFiltri;
+class CacheFiltri;
+class CursoreMedia;
 
 /**
  * @brief Classe per gestire la collezione di media
@@ -34,21 +46,54 @@ public:
     const std::vector<std::unique_ptr<Media>>& getAllMedia() const;
     std::vector<Media*> getMediaByType(const QString& type) const;
     std::vector<Media*> searchMedia(const QString& searchText) const;
+    std::vector<Media*> searchMediaApprossimata(const QString& searchText, size_t massimo = 0) const;
+    // Come searchMediaApprossimata, con i punteggi per servire i risultati a pagine
+    RisultatiRicerca cercaApprossimata(const QString& searchText, size_t massimo = 0) const;
+    RisultatiRicerca cercaPerRilevanza(const QString& searchText) const;
     std::vector<Media*> filterMedia(std::unique_ptr<FiltroStrategy> strategy) const;
+    // Media valutati dall'ultima filterMedia (0 se ha risposto la cache)
+    size_t getEsaminatiUltimoFiltro() const { return m_esaminatiUltimoFiltro; }
+    
+    // Accesso pigro: pagine su richiesta (filtro nullo = tutti i media) e solo conteggio
+    std::unique_ptr<CursoreMedia> apriCursore(std::unique_ptr<FiltroStrategy> strategy = nullptr) const;
+    size_t contaMedia(std::unique_ptr<FiltroStrategy> strategy) const;
+    
+    // Pianificazione dei filtri (ordine di valutazione e uso degli indici)
+    PianoFiltro pianificaFiltro(const FiltroStrategy& filtro) const;
+    
+    // Linguaggio di interrogazione testuale (vedi ParserFiltri), con cache delle query
+    std::unique_ptr<FiltroStrategy> compilaQuery(const QString& query, QString* errore = nullptr) const;
+    std::vector<Media*> cercaConQuery(const QString& query, QString* errore = nullptr) const;
+    
+    // Ordinamento stabile multi-chiave con collazione italiana (chiavi precalcolate)
+    void ordina(std::vector<Media*>& media, const std::vector<CriterioOrdinamento>& criteri) const;
+    
+    // Autocompletamento per campo ("titolo", "autore", "regista", "rivista")
+    QStringList completa(const QString& campo, const QString& prefisso, int massimo = 10) const;
     
     // Statistiche
     size_t size() const;
     bool isEmpty() const;
     size_t countByType(const QString& type) const;
+    const StatisticheCollezione& getStatistiche() const;
+    
+    // Stima della memoria dei media (per tipo e per campo) e dei contenitori
+    RapportoMemoria getRapportoMemoria() const;
+    
+    // Incrementata a ogni modifica: i risultati calcolati a una generazione diversa sono superati
+    quint64 getGenerazione() const { return m_generazione; }
     
     // Persistenza
     bool saveToFile(const QString& filename) const;
     bool loadFromFile(const QString& filename);
     void clear();
+    QString getLastError() const;
     
     // Validazione
     bool isValidCollection() const;
     QStringList getValidationErrors() const;
+    // Errori e avvisi di tutti i media, validati in parallelo (0: un thread per core)
+    RapportoValidazione valida(int numeroThread = 0) const;
     
     // Iterator pattern
     class Iterator {
@@ -77,7 +122,25 @@ private:
     std::vector<std::unique_ptr<Media>> m_media;
     std::unique_ptr<JsonManager> m_jsonManager;
     
+    // Strutture derivate, ricostruite su richiesta dopo le modifiche
+    std::unique_ptr<IndiceCollezione> m_indice;
+    std::unique_ptr<IndiceTestuale> m_indiceTestuale;
+    std::unique_ptr<OrdinamentoMedia> m_ordinamento;
+    mutable std::unique_ptr<StatisticheCollezione> m_statistiche;
+    
+    // Trie dei completamenti, aggiornati a ogni modifica
+    std::unique_ptr<CompletamentiCollezione> m_completamenti;
+    
+    // Le query compilate non dipendono dai media: la cache sopravvive alle modifiche
+    mutable std::unique_ptr<ParserFiltri> m_parser;
+    
+    // Risultati dei filtri, corretti in place a ogni modifica
+    mutable std::unique_ptr<CacheFiltri> m_cacheFiltri;
+    quint64 m_generazione;
+    mutable size_t m_esaminatiUltimoFiltro;
+    
     // Helper methods
+    void invalidaStrutture();
     bool isIdUnique(const QString& id) const;
     void updateIdCountersFromCollection();
     std::vector<std::unique_ptr<Media>>::iterator findMediaIterator(const QString& id);
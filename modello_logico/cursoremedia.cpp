@@ -0,0 +1,179 @@
+#include "cursoremedia.h"
+#include "collezione.h"
+#include "programmafiltro.h"
+#include "media.h"
+#include <QByteArray>
+#include <QStringList>
+#include <algorithm>
+
+CursoreMedia::CursoreMedia(const Collezione& collezione, std::unique_ptr<FiltroStrategy> filtro)
+    : m_collezione(collezione), m_filtro(std::move(filtro)), m_usaCandidati(false),
+      m_indiceCandidato(0), m_generazione(0), m_scansione(0), m_prossimoValido(false),
+      m_prossimo(0), m_finito(false), m_dopoUltimo(0), m_restituiti(0), m_esaminati(0)
+{
+    prepara();
+}
+
+CursoreMedia::~CursoreMedia() = default;
+
+std::vector<Media*> CursoreMedia::prossimaPagina(size_t dimensione)
+{
+    verificaGenerazione();
+
+    const auto& media = m_collezione.getAllMedia();
+    std::vector<Media*> pagina;
+    pagina.reserve(dimensione);
+
+    while (pagina.size() < dimensione && (m_prossimoValido || cercaProssimo())) {
+        Media* elemento = media[m_prossimo].get();
+        pagina.push_back(elemento);
+        m_dopoUltimo = static_cast<size_t>(m_prossimo) + 1;
+        m_ultimoId = elemento->getId();
+        m_prossimoValido = false;
+    }
+    m_restituiti += pagina.size();
+
+    // Un passo di anticipo: haAltri() resta esatto senza una pagina vuota finale
+    if (!pagina.empty() && !m_prossimoValido) {
+        cercaProssimo();
+    }
+    return pagina;
+}
+
+bool CursoreMedia::haAltri()
+{
+    verificaGenerazione();
+    return m_prossimoValido || cercaProssimo();
+}
+
+QString CursoreMedia::getPosizione() const
+{
+    QString stato = QString("%1|%2|%3").arg(m_generazione).arg(m_dopoUltimo).arg(m_ultimoId);
+    return QString::fromUtf8(stato.toUtf8().toBase64(QByteArray::Base64UrlEncoding | QByteArray::OmitTrailingEquals));
+}
+
+bool CursoreMedia::riprendiDa(const QString& posizione)
+{
+    QString stato = QString::fromUtf8(QByteArray::fromBase64(posizione.toUtf8(), QByteArray::Base64UrlEncoding));
+    QStringList parti = stato.split('|');
+    if (parti.size() != 3) {
+        return false;
+    }
+
+    bool okGenerazione = false;
+    bool okPosizione = false;
+    quint64 generazione = parti[0].toULongLong(&okGenerazione);
+    quint64 dopoUltimo = parti[1].toULongLong(&okPosizione);
+    if (!okGenerazione || !okPosizione) {
+        return false;
+    }
+
+    const QString& id = parti[2];
+    if (generazione != m_collezione.getGenerazione() && !id.isEmpty()) {
+        // Le posizioni sono cambiate: vale l'id dell'ultimo media restituito
+        const auto& media = m_collezione.getAllMedia();
+        auto it = std::find_if(media.begin(), media.end(), [&id](const std::unique_ptr<Media>& elemento) {
+            return elemento->getId() == id;
+        });
+        if (it == media.end()) {
+            return false;
+        }
+        dopoUltimo = static_cast<quint64>(it - media.begin()) + 1;
+    } else if (generazione != m_collezione.getGenerazione()) {
+        dopoUltimo = 0;
+    }
+
+    verificaGenerazione();
+    m_ultimoId = id;
+    posizionaScansione(static_cast<size_t>(dopoUltimo));
+    return true;
+}
+
+// Private methods
+void CursoreMedia::prepara()
+{
+    m_generazione = m_collezione.getGenerazione();
+    m_usaCandidati = false;
+    m_candidati.clear();
+
+    if (!m_filtro) {
+        m_programma = std::make_unique<ProgrammaFiltro>();
+        return;
+    }
+
+    PianoFiltro piano = m_collezione.pianificaFiltro(*m_filtro);
+    m_programma = std::make_unique<ProgrammaFiltro>(*piano.filtro);
+    m_usaCandidati = piano.usaCandidati;
+    m_candidati = std::move(piano.candidati);
+}
+
+void CursoreMedia::verificaGenerazione()
+{
+    if (m_generazione == m_collezione.getGenerazione()) {
+        return;
+    }
+
+    // Ripianifica (i candidati degli indici sono cambiati) e riaggancia la
+    // scansione all'ultimo media restituito; se è stato rimosso si resta
+    // sulla posizione precedente, con al più un salto o un duplicato
+    size_t ripresa = m_dopoUltimo;
+    if (!m_ultimoId.isEmpty()) {
+        const auto& media = m_collezione.getAllMedia();
+        for (size_t i = 0; i < media.size(); ++i) {
+            if (media[i]->getId() == m_ultimoId) {
+                ripresa = i + 1;
+                break;
+            }
+        }
+    }
+
+    prepara();
+    posizionaScansione(ripresa);
+}
+
+void CursoreMedia::posizionaScansione(size_t posizione)
+{
+    m_dopoUltimo = posizione;
+    m_scansione = posizione;
+    m_prossimoValido = false;
+    m_finito = false;
+    if (m_usaCandidati) {
+        m_indiceCandidato = static_cast<size_t>(
+            std::lower_bound(m_candidati.begin(), m_candidati.end(), static_cast<uint32_t>(posizione))
+            - m_candidati.begin());
+    }
+}
+
+bool CursoreMedia::cercaProssimo()
+{
+    if (m_finito) {
+        return false;
+    }
+
+    const auto& media = m_collezione.getAllMedia();
+    while (true) {
+        size_t posizione;
+        if (m_usaCandidati) {
+            if (m_indiceCandidato >= m_candidati.size()) {
+                break;
+            }
+            posizione = m_candidati[m_indiceCandidato++];
+        } else {
+            if (m_scansione >= media.size()) {
+                break;
+            }
+            posizione = m_scansione;
+        }
+        m_scansione = posizione + 1;
+        ++m_esaminati;
+
+        if (m_programma->esegui(media[posizione].get())) {
+            m_prossimo = static_cast<uint32_t>(posizione);
+            m_prossimoValido = true;
+            return true;
+        }
+    }
+
+    m_finito = true;
+    return false;
+}
@@ -0,0 +1,74 @@
+#ifndef CURSOREMEDIA_H
+#define CURSOREMEDIA_H
+
+#include "filtrostrategy.h"
+#include "pianificatorefiltri.h"
+#include <QString>
+#include <QtGlobal>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+class Collezione;
+class Media;
+class ProgrammaFiltro;
+
+/**
+ * @brief Cursore pigro sui media accettati da un filtro
+ *
+ * Restituisce i risultati a pagine, nell'ordine della collezione, e scorre i
+ * media (o i candidati scelti dal pianificatore) solo finché la pagina non è
+ * piena, più un passo di anticipo per sapere se ne restano altri.
+ *
+ * getPosizione() produce un token opaco da cui riprendere con riprendiDa(),
+ * anche da un altro cursore con lo stesso filtro. Se nel frattempo la
+ * collezione è cambiata, la ripresa si aggancia all'ultimo media restituito
+ * tramite il suo id; lo stesso vale per un cursore aperto durante una modifica.
+ */
+class CursoreMedia
+{
+public:
+    // Senza filtro il cursore scorre tutta la collezione
+    CursoreMedia(const Collezione& collezione, std::unique_ptr<FiltroStrategy> filtro = nullptr);
+    ~CursoreMedia();
+
+    CursoreMedia(const CursoreMedia&) = delete;
+    CursoreMedia& operator=(const CursoreMedia&) = delete;
+
+    std::vector<Media*> prossimaPagina(size_t dimensione);
+    bool haAltri();
+    size_t getRestituiti() const { return m_restituiti; }
+    // Media valutati dal filtro finora, compreso quello trovato in anticipo
+    size_t getEsaminati() const { return m_esaminati; }
+
+    QString getPosizione() const;
+    // false se il token non è valido o l'ultimo media restituito non esiste più
+    bool riprendiDa(const QString& posizione);
+
+private:
+    void prepara();
+    void verificaGenerazione();
+    void posizionaScansione(size_t posizione);
+    bool cercaProssimo();
+
+    const Collezione& m_collezione;
+    std::unique_ptr<FiltroStrategy> m_filtro;
+    std::unique_ptr<ProgrammaFiltro> m_programma;
+    bool m_usaCandidati;
+    PosizioniMedia m_candidati;
+    size_t m_indiceCandidato;
+    quint64 m_generazione;
+
+    // Prossima posizione da esaminare e risultato già trovato in anticipo
+    size_t m_scansione;
+    bool m_prossimoValido;
+    uint32_t m_prossimo;
+    bool m_finito;
+
+    size_t m_dopoUltimo;
+    QString m_ultimoId;
+    size_t m_restituiti;
+    size_t m_esaminati;
+};
+
+#endif
@@ -0,0 +1,146 @@
+#include "distanzamodifica.h"
+#include <algorithm>
+#include <cstdlib>
+
+DistanzaModifica::DistanzaModifica(const QString& modello)
+    : m_modello(modello)
+{
+    m_ascii.fill(0);
+    if (m_modello.size() > MAX_BIT_PARALLELO) {
+        return;
+    }
+
+    // Maschere di occorrenza: bit i acceso se il modello ha il carattere in posizione i
+    for (qsizetype i = 0; i < m_modello.size(); ++i) {
+        ushort c = m_modello.at(i).unicode();
+        uint64_t bit = uint64_t(1) << i;
+        if (c < m_ascii.size()) {
+            m_ascii[c] |= bit;
+            continue;
+        }
+
+        auto it = std::find_if(m_altri.begin(), m_altri.end(),
+                               [c](const std::pair<ushort, uint64_t>& voce) { return voce.first == c; });
+        if (it != m_altri.end()) {
+            it->second |= bit;
+        } else {
+            m_altri.emplace_back(c, bit);
+        }
+    }
+}
+
+int DistanzaModifica::calcola(const QString& a, const QString& b, int massimo)
+{
+    return DistanzaModifica(a).calcola(b, massimo);
+}
+
+int DistanzaModifica::calcola(const QString& testo, int massimo) const
+{
+    int m = static_cast<int>(m_modello.size());
+    int n = static_cast<int>(testo.size());
+
+    if (std::abs(m - n) > massimo) {
+        return massimo + 1;
+    }
+    if (m == 0 || n == 0) {
+        return std::max(m, n);
+    }
+
+    if (m <= MAX_BIT_PARALLELO) {
+        return calcolaBitParallelo(testo, massimo);
+    }
+    return calcolaDinamica(testo, massimo);
+}
+
+uint64_t DistanzaModifica::maschera(QChar carattere) const
+{
+    ushort c = carattere.unicode();
+    if (c < m_ascii.size()) {
+        return m_ascii[c];
+    }
+    for (const auto& voce : m_altri) {
+        if (voce.first == c) {
+            return voce.second;
+        }
+    }
+    return 0;
+}
+
+int DistanzaModifica::calcolaBitParallelo(const QString& testo, int massimo) const
+{
+    const int m = static_cast<int>(m_modello.size());
+    const int n = static_cast<int>(testo.size());
+    const uint64_t tutti = (m == 64) ? ~uint64_t(0) : ((uint64_t(1) << m) - 1);
+    const uint64_t ultimo = uint64_t(1) << (m - 1);
+
+    // VP/VN: differenze verticali positive/negative della colonna corrente
+    uint64_t vp = tutti;
+    uint64_t vn = 0;
+    uint64_t d0 = 0;
+    uint64_t pmPrecedente = 0;
+    int distanza = m;
+
+    for (int j = 0; j < n; ++j) {
+        uint64_t pm = maschera(testo.at(j));
+
+        // Trasposizioni di caratteri adiacenti (estensione di Hyyrö)
+        uint64_t tr = (((~d0) & pm) << 1) & pmPrecedente;
+        d0 = ((((pm & vp) + vp) ^ vp) | pm | vn | tr) & tutti;
+
+        uint64_t hp = vn | ~(d0 | vp);
+        uint64_t hn = d0 & vp;
+        if (hp & ultimo) {
+            ++distanza;
+        } else if (hn & ultimo) {
+            --distanza;
+        }
+
+        uint64_t x = (hp << 1) | 1;
+        vn = x & d0;
+        vp = ((hn << 1) | ~(x | d0)) & tutti;
+        pmPrecedente = pm;
+
+        // Ogni carattere rimanente può ridurre la distanza al più di uno
+        if (distanza - (n - j - 1) > massimo) {
+            return massimo + 1;
+        }
+    }
+
+    return distanza <= massimo ? distanza : massimo + 1;
+}
+
+int DistanzaModifica::calcolaDinamica(const QString& testo, int massimo) const
+{
+    const int m = static_cast<int>(m_modello.size());
+    const int n = static_cast<int>(testo.size());
+
+    std::vector<int> precedente2(n + 1), precedente(n + 1), corrente(n + 1);
+    for (int j = 0; j <= n; ++j) {
+        precedente[j] = j;
+    }
+
+    for (int i = 1; i <= m; ++i) {
+        corrente[0] = i;
+        int minimoRiga = corrente[0];
+        QChar a = m_modello.at(i - 1);
+
+        for (int j = 1; j <= n; ++j) {
+            QChar b = testo.at(j - 1);
+            int costo = (a == b) ? 0 : 1;
+            int valore = std::min({precedente[j] + 1, corrente[j - 1] + 1, precedente[j - 1] + costo});
+            if (i > 1 && j > 1 && a == testo.at(j - 2) && m_modello.at(i - 2) == b) {
+                valore = std::min(valore, precedente2[j - 2] + 1);
+            }
+            corrente[j] = valore;
+            minimoRiga = std::min(minimoRiga, valore);
+        }
+
+        if (minimoRiga > massimo) {
+            return massimo + 1;
+        }
+        std::swap(precedente2, precedente);
+        std::swap(precedente, corrente);
+    }
+
+    return precedente[n] <= massimo ? precedente[n] : massimo + 1;
+}
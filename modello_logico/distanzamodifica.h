@@ -0,0 +1,45 @@
+#ifndef DISTANZAMODIFICA_H
+#define DISTANZAMODIFICA_H
+
+#include <QString>
+#include <array>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Distanza di Damerau-Levenshtein limitata (variante OSA)
+ *
+ * Il modello viene preparato una volta e confrontato con molti candidati.
+ * Per modelli fino a 64 caratteri usa l'algoritmo bit-parallelo di Hyyrö:
+ * ogni carattere del testo aggiorna un'intera colonna della matrice con
+ * poche operazioni su una parola a 64 bit. I modelli più lunghi ricadono
+ * sulla programmazione dinamica classica.
+ *
+ * Entrambe le varianti si fermano appena la distanza supera il limite e in
+ * quel caso restituiscono massimo + 1.
+ */
+class DistanzaModifica
+{
+public:
+    explicit DistanzaModifica(const QString& modello);
+
+    int calcola(const QString& testo, int massimo) const;
+
+    const QString& getModello() const { return m_modello; }
+
+    static int calcola(const QString& a, const QString& b, int massimo);
+
+private:
+    uint64_t maschera(QChar carattere) const;
+    int calcolaBitParallelo(const QString& testo, int massimo) const;
+    int calcolaDinamica(const QString& testo, int massimo) const;
+
+    static const int MAX_BIT_PARALLELO = 64;
+
+    QString m_modello;
+    std::array<uint64_t, 128> m_ascii;
+    std::vector<std::pair<ushort, uint64_t>> m_altri;
+};
+
+#endif
@@ -1,11 +1,12 @@
 #include "film.h"
+#include "rapportomemoria.h"
 #include <QJsonObject>
 #include <QJsonArray>
 
 Film::Film(const QString& titolo, int anno, const QString& descrizione,
            const QString& regista, const QStringList& attori, int durata,
            Genere genere, Classificazione classificazione, const QString& casa_produzione)
-    : Media(titolo, anno, descrizione), m_regista(regista), m_attori(attori),
+    : Media(titolo, anno, descrizione, TipoMedia::Film), m_regista(regista), m_attori(attori),
       m_durata(durata), m_genere(genere), m_classificazione(classificazione),
       m_casa_produzione(casa_produzione)
 {
@@ -15,7 +16,7 @@ Film::Film(const QString& titolo, int anno, const QString& descrizione,
 }
 
 Film::Film(const QJsonObject& json)
-    : Media("", 0, "")
+    : Media("", 0, "", TipoMedia::Film)
 {
     fromJson(json);
 }
@@ -62,37 +63,43 @@ QString Film::getCasaProduzione() const
 
 void Film::setRegista(const QString& regista)
 {
+    invalidaTestiVisualizzati();
     m_regista = regista;
 }
 
 void Film::setAttori(const QStringList& attori)
 {
+    invalidaTestiVisualizzati();
     m_attori = attori;
 }
 
 void Film::setDurata(int durata)
 {
+    invalidaTestiVisualizzati();
     m_durata = durata;
 }
 
 void Film::setGenere(Genere genere)
 {
+    invalidaTestiVisualizzati();
     m_genere = genere;
 }
 
 void Film::setClassificazione(Classificazione classificazione)
 {
+    invalidaTestiVisualizzati();
     m_classificazione = classificazione;
 }
 
 void Film::setCasaProduzione(const QString& casa_produzione)
 {
+    invalidaTestiVisualizzati();
     m_casa_produzione = casa_produzione;
 }
 
 std::unique_ptr<Media> Film::clone() const
 {
-    auto cloned = std::make_unique<Film>(m_titolo, m_anno, m_descrizione, m_regista, 
+    auto cloned = std::make_unique<Film>(m_titolo, m_anno, descrizioneDa(leggiCampiFreddi()), m_regista, 
                                         m_attori, m_durata, m_genere, m_classificazione, 
                                         m_casa_produzione);
     
@@ -109,7 +116,7 @@ QJsonObject Film::toJson() const
     json["id"] = m_id;
     json["titolo"] = m_titolo;
     json["anno"] = m_anno;
-    json["descrizione"] = m_descrizione;
+    json["descrizione"] = descrizioneDa(leggiCampiFreddi());
     json["regista"] = m_regista;
     
     QJsonArray attoriArray;
@@ -128,6 +135,8 @@ QJsonObject Film::toJson() const
 
 void Film::fromJson(const QJsonObject& json)
 {
+    scartaCampiFreddi();
+    invalidaTestiVisualizzati();
     m_id = json["id"].toString();
     m_titolo = json["titolo"].toString();
     m_anno = json["anno"].toInt();
@@ -148,13 +157,10 @@ void Film::fromJson(const QJsonObject& json)
 
 QString Film::getDisplayInfo() const
 {
+    // Un solo arg() a più argomenti: la stringa viene scorsa una volta
     return QString("Regista: %1\nAttori: %2\nDurata: %3\nGenere: %4\nClassificazione: %5\nCasa di Produzione: %6")
-           .arg(m_regista)
-           .arg(m_attori.join(", "))
-           .arg(getDurataFormatted())
-           .arg(getGenereString())
-           .arg(getClassificazioneString())
-           .arg(m_casa_produzione);
+           .arg(m_regista, m_attori.join(", "), getDurataFormatted(), getGenereString(),
+                getClassificazioneString(), m_casa_produzione);
 }
 
 QString Film::getTypeDisplayName() const
@@ -181,6 +187,20 @@ bool Film::matchesCriteria(const QString& criteria, const QString& value) const
     return false;
 }
 
+QStringList Film::getValoriAttributo(const QString& criteria) const
+{
+    if (criteria == "regista") {
+        return QStringList{m_regista};
+    } else if (criteria == "attore") {
+        return m_attori;
+    } else if (criteria == "genere") {
+        return QStringList{getGenereString()};
+    } else if (criteria == "casa_produzione") {
+        return QStringList{m_casa_produzione};
+    }
+    return QStringList();
+}
+
 QString Film::getDurataFormatted() const
 {
     int ore = m_durata / 60;
@@ -273,10 +293,33 @@ bool Film::validateSpecificFields() const
            !m_attori.isEmpty();
 }
 
-QString Film::getSearchableText() const
+QString Film::getSearchableText(const QJsonObject& freddi) const
 {
     return QString("%1 %2 %3 %4 %5 %6")
-           .arg(m_titolo, m_descrizione, m_regista)
+           .arg(m_titolo, descrizioneDa(freddi), m_regista)
            .arg(m_attori.join(" "))
            .arg(getGenereString(), m_casa_produzione);
+}
+
+std::vector<CampoRicercabile> Film::campiRicercabili(const QJsonObject& freddi) const
+{
+    std::vector<CampoRicercabile> campi = Media::campiRicercabili(freddi);
+    campi.push_back({CampoRicercabile::Persone, m_regista});
+    for (const QString& attore : m_attori) {
+        campi.push_back({CampoRicercabile::Persone, attore});
+    }
+    campi.push_back({CampoRicercabile::Altro, getGenereString()});
+    campi.push_back({CampoRicercabile::Altro, m_casa_produzione});
+    return campi;
+}
+
+void Film::stimaMemoria(RapportoMemoria& rapporto) const
+{
+    Media::stimaMemoria(rapporto);
+    
+    const QString tipo = getTypeDisplayName();
+    rapporto.aggiungiCampo(tipo, "oggetto", RapportoMemoria::Struttura, RapportoMemoria::byteAllocazione(sizeof(Film)));
+    rapporto.aggiungiCampo(tipo, "regista", RapportoMemoria::Stringhe, RapportoMemoria::byteStringa(m_regista));
+    rapporto.aggiungiCampo(tipo, "attori", RapportoMemoria::Liste, RapportoMemoria::byteLista(m_attori));
+    rapporto.aggiungiCampo(tipo, "casa_produzione", RapportoMemoria::Stringhe, RapportoMemoria::byteStringa(m_casa_produzione));
 }
\ No newline at end of file
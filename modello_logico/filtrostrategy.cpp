@@ -1,5 +1,13 @@
 #include "filtrostrategy.h"
 #include "media.h"
+#include "statistichecollezione.h"
+#include <QStringList>
+
+// FiltroStrategy - stima di default ricavata dal campione della collezione
+double FiltroStrategy::stimaSelettivita(const StatisticheCollezione& statistiche) const
+{
+    return statistiche.selettivitaCampione(*this);
+}
 
 // FiltroTipo - solo implementazioni dei metodi non-inline
 bool FiltroTipo::matches(const Media* media) const
@@ -18,6 +26,12 @@ std::unique_ptr<FiltroStrategy> FiltroTipo::clone() const
     return std::make_unique<FiltroTipo>(m_tipo);
 }
 
+double FiltroTipo::stimaSelettivita(const StatisticheCollezione& statistiche) const
+{
+    if (statistiche.getTotale() == 0) return 1.0;
+    return static_cast<double>(statistiche.contaPerTipo(m_tipo)) / statistiche.getTotale();
+}
+
 // FiltroAnno - solo implementazioni dei metodi non-inline
 bool FiltroAnno::matches(const Media* media) const
 {
@@ -39,21 +53,72 @@ std::unique_ptr<FiltroStrategy> FiltroAnno::clone() const
     return std::make_unique<FiltroAnno>(m_annoMin, m_annoMax);
 }
 
+double FiltroAnno::stimaSelettivita(const StatisticheCollezione& statistiche) const
+{
+    return statistiche.frazioneAnni(m_annoMin, m_annoMax);
+}
+
 // FiltroCriterio - solo implementazioni dei metodi non-inline
 bool FiltroCriterio::matches(const Media* media) const
 {
     if (!media) return false;
-    return media->matchesCriteria(m_criterio, m_valore);
+    if (m_modalita == Contiene) {
+        return media->matchesCriteria(m_criterio, m_valore);
+    }
+    
+    QString cercato = normalizzaValore(m_valore);
+    for (const QString& valore : media->getValoriAttributo(m_criterio)) {
+        QString normalizzato = normalizzaValore(valore);
+        if (m_modalita == Esatto ? normalizzato == cercato : normalizzato.startsWith(cercato)) {
+            return true;
+        }
+    }
+    return false;
 }
 
 QString FiltroCriterio::getDescription() const
 {
-    return QString("%1: %2").arg(m_criterio).arg(m_valore);
+    switch (m_modalita) {
+        case Esatto: return QString("%1 = %2").arg(m_criterio).arg(m_valore);
+        case Prefisso: return QString("%1: %2*").arg(m_criterio).arg(m_valore);
+        default: return QString("%1: %2").arg(m_criterio).arg(m_valore);
+    }
 }
 
 std::unique_ptr<FiltroStrategy> FiltroCriterio::clone() const
 {
-    return std::make_unique<FiltroCriterio>(m_criterio, m_valore);
+    return std::make_unique<FiltroCriterio>(m_criterio, m_valore, m_modalita);
+}
+
+double FiltroCriterio::stimaCosto() const
+{
+    // Confronto case-insensitive su stringhe; i campi multi-valore scorrono una lista
+    if (m_criterio == "attore" || m_criterio == "autore") {
+        return 16.0;
+    }
+    return 8.0;
+}
+
+QString FiltroCriterio::normalizzaValore(const QString& valore)
+{
+    return valore.trimmed().toLower();
+}
+
+// FiltroTesto - solo implementazioni dei metodi non-inline
+bool FiltroTesto::matches(const Media* media) const
+{
+    if (!media) return false;
+    return media->matchesFilter(m_testo);
+}
+
+QString FiltroTesto::getDescription() const
+{
+    return QString("Testo: \"%1\"").arg(m_testo);
+}
+
+std::unique_ptr<FiltroStrategy> FiltroTesto::clone() const
+{
+    return std::make_unique<FiltroTesto>(m_testo);
 }
 
 // FiltroComposto - solo metodi complessi, quelli semplici sono inline nel .h
@@ -68,6 +133,15 @@ bool FiltroComposto::matches(const Media* media) const
 {
     if (!media || m_filtri.empty()) return true;
     
+    if (m_operatore == Or) {
+        for (const auto& filtro : m_filtri) {
+            if (filtro->matches(media)) {
+                return true;
+            }
+        }
+        return false;
+    }
+    
     for (const auto& filtro : m_filtri) {
         if (!filtro->matches(media)) {
             return false;
@@ -87,18 +161,44 @@ QString FiltroComposto::getDescription() const
         descrizioni << filtro->getDescription();
     }
     
+    if (m_operatore == Or) {
+        return "(" + descrizioni.join(" OR ") + ")";
+    }
     return descrizioni.join(" AND ");
 }
 
 std::unique_ptr<FiltroStrategy> FiltroComposto::clone() const
 {
-    auto copia = std::make_unique<FiltroComposto>();
+    auto copia = std::make_unique<FiltroComposto>(m_operatore);
     for (const auto& filtro : m_filtri) {
         copia->addFiltro(filtro->clone());
     }
     return copia;
 }
 
+double FiltroComposto::stimaSelettivita(const StatisticheCollezione& statistiche) const
+{
+    if (m_filtri.empty()) return 1.0;
+    
+    // Assume indipendenza tra i filtri figli
+    double risultato = 1.0;
+    for (const auto& filtro : m_filtri) {
+        double s = filtro->stimaSelettivita(statistiche);
+        risultato *= (m_operatore == Or) ? (1.0 - s) : s;
+    }
+    return (m_operatore == Or) ? 1.0 - risultato : risultato;
+}
+
+double FiltroComposto::stimaCosto() const
+{
+    // Limite superiore: nel caso peggiore vengono valutati tutti i figli
+    double costo = 0.0;
+    for (const auto& filtro : m_filtri) {
+        costo += filtro->stimaCosto();
+    }
+    return costo;
+}
+
 // FiltroNegato - solo implementazioni dei metodi non-inline
 bool FiltroNegato::matches(const Media* media) const
 {
@@ -118,6 +218,17 @@ std::unique_ptr<FiltroStrategy> FiltroNegato::clone() const
     return std::make_unique<FiltroNegato>(m_filtro->clone());
 }
 
+double FiltroNegato::stimaSelettivita(const StatisticheCollezione& statistiche) const
+{
+    if (!m_filtro) return 0.0;
+    return 1.0 - m_filtro->stimaSelettivita(statistiche);
+}
+
+double FiltroNegato::stimaCosto() const
+{
+    return m_filtro ? m_filtro->stimaCosto() : 0.0;
+}
+
 // FiltroFactory - metodi statici
 std::unique_ptr<FiltroStrategy> FiltroFactory::createTipoFiltro(const QString& tipo)
 {
@@ -129,17 +240,34 @@ std::unique_ptr<FiltroStrategy> FiltroFactory::createAnnoFiltro(int annoMin, int
     return std::make_unique<FiltroAnno>(annoMin, annoMax);
 }
 
-std::unique_ptr<FiltroStrategy> FiltroFactory::createAutoreFiltro(const QString& autore)
+std::unique_ptr<FiltroStrategy> FiltroFactory::createAutoreFiltro(const QString& autore,
+                                                                  FiltroCriterio::Modalita modalita)
 {
-    return std::make_unique<FiltroCriterio>("autore", autore);
+    return std::make_unique<FiltroCriterio>("autore", autore, modalita);
 }
 
-std::unique_ptr<FiltroStrategy> FiltroFactory::createRegistaFiltro(const QString& regista)
+std::unique_ptr<FiltroStrategy> FiltroFactory::createRegistaFiltro(const QString& regista,
+                                                                   FiltroCriterio::Modalita modalita)
 {
-    return std::make_unique<FiltroCriterio>("regista", regista);
+    return std::make_unique<FiltroCriterio>("regista", regista, modalita);
 }
 
-std::unique_ptr<FiltroStrategy> FiltroFactory::createRivistaFiltro(const QString& rivista)
+std::unique_ptr<FiltroStrategy> FiltroFactory::createRivistaFiltro(const QString& rivista,
+                                                                   FiltroCriterio::Modalita modalita)
 {
-    return std::make_unique<FiltroCriterio>("rivista", rivista);
+    return std::make_unique<FiltroCriterio>("rivista", rivista, modalita);
+}
+
+FiltroCriterio::Modalita FiltroFactory::modalitaDaTesto(QString& testo)
+{
+    testo = testo.trimmed();
+    if (testo.length() > 1 && testo.startsWith('=')) {
+        testo = testo.mid(1).trimmed();
+        return FiltroCriterio::Esatto;
+    }
+    if (testo.length() > 1 && testo.endsWith('*')) {
+        testo.chop(1);
+        return FiltroCriterio::Prefisso;
+    }
+    return FiltroCriterio::Contiene;
 }
\ No newline at end of file
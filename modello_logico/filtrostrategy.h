@@ -6,6 +6,7 @@
 #include <vector>
 
 class Media;
+class StatisticheCollezione;
 
 /**
  * @brief Pattern Strategy per i filtri di ricerca
@@ -17,6 +18,10 @@ public:
     virtual bool matches(const Media* media) const = 0;
     virtual QString getDescription() const = 0;
     virtual std::unique_ptr<FiltroStrategy> clone() const = 0;
+    
+    // Stime usate dal pianificatore: frazione di media accettati e costo relativo per media
+    virtual double stimaSelettivita(const StatisticheCollezione& statistiche) const;
+    virtual double stimaCosto() const { return 1.0; }
 };
 
 /* Filtro per tipo di media*/
@@ -27,6 +32,10 @@ public:
     bool matches(const Media* media) const override;
     QString getDescription() const override;
     std::unique_ptr<FiltroStrategy> clone() const override;
+    double stimaSelettivita(const StatisticheCollezione& statistiche) const override;
+    double stimaCosto() const override { return 2.0; }
+    
+    QString getTipo() const { return m_tipo; }
 
 private:
     QString m_tipo;
@@ -40,6 +49,10 @@ public:
     bool matches(const Media* media) const override;
     QString getDescription() const override;
     std::unique_ptr<FiltroStrategy> clone() const override;
+    double stimaSelettivita(const StatisticheCollezione& statistiche) const override;
+    
+    int getAnnoMin() const { return m_annoMin; }
+    int getAnnoMax() const { return m_annoMax; }
 
 private:
     int m_annoMin;
@@ -50,32 +63,74 @@ private:
 class FiltroCriterio : public FiltroStrategy
 {
 public:
-    FiltroCriterio(const QString& criterio, const QString& valore) 
-        : m_criterio(criterio), m_valore(valore) {}
+    // Contiene: sottostringa (comportamento storico); Esatto e Prefisso sono risolvibili dagli indici
+    enum Modalita {
+        Contiene,
+        Esatto,
+        Prefisso
+    };
+    
+    FiltroCriterio(const QString& criterio, const QString& valore, Modalita modalita = Contiene) 
+        : m_criterio(criterio), m_valore(valore), m_modalita(modalita) {}
     bool matches(const Media* media) const override;
     QString getDescription() const override;
     std::unique_ptr<FiltroStrategy> clone() const override;
+    double stimaCosto() const override;
+    
+    QString getCriterio() const { return m_criterio; }
+    QString getValore() const { return m_valore; }
+    Modalita getModalita() const { return m_modalita; }
+    
+    // Forma confrontabile dei valori, condivisa con gli indici per attributo
+    static QString normalizzaValore(const QString& valore);
 
 private:
     QString m_criterio;
     QString m_valore;
+    Modalita m_modalita;
 };
 
-/* Filtro composto che combina più filtri*/
+/* Filtro sul testo libero, con la stessa semantica della casella di ricerca*/
+class FiltroTesto : public FiltroStrategy
+{
+public:
+    explicit FiltroTesto(const QString& testo) : m_testo(testo) {}
+    bool matches(const Media* media) const override;
+    QString getDescription() const override;
+    std::unique_ptr<FiltroStrategy> clone() const override;
+    double stimaCosto() const override { return 32.0; }
+    
+    QString getTesto() const { return m_testo; }
+
+private:
+    QString m_testo;
+};
+
+/* Filtro composto che combina più filtri in AND oppure in OR*/
 class FiltroComposto : public FiltroStrategy
 {
 public:
-    FiltroComposto() = default;
+    enum Operatore {
+        And,
+        Or
+    };
+    
+    explicit FiltroComposto(Operatore operatore = And) : m_operatore(operatore) {}
     void addFiltro(std::unique_ptr<FiltroStrategy> filtro);
     bool matches(const Media* media) const override;
     QString getDescription() const override;
     std::unique_ptr<FiltroStrategy> clone() const override;
+    double stimaSelettivita(const StatisticheCollezione& statistiche) const override;
+    double stimaCosto() const override;
     
+    Operatore getOperatore() const { return m_operatore; }
+    const std::vector<std::unique_ptr<FiltroStrategy>>& getFiltri() const { return m_filtri; }
     size_t size() const { return m_filtri.size(); }
     bool isEmpty() const { return m_filtri.empty(); }
     void clear() { m_filtri.clear(); }
 
 private:
+    Operatore m_operatore;
     std::vector<std::unique_ptr<FiltroStrategy>> m_filtri;
 };
 
@@ -88,6 +143,10 @@ public:
     bool matches(const Media* media) const override;
     QString getDescription() const override;
     std::unique_ptr<FiltroStrategy> clone() const override;
+    double stimaSelettivita(const StatisticheCollezione& statistiche) const override;
+    double stimaCosto() const override;
+    
+    const FiltroStrategy* getFiltro() const { return m_filtro.get(); }
 
 private:
     std::unique_ptr<FiltroStrategy> m_filtro;
@@ -99,9 +158,15 @@ class FiltroFactory
 public:
     static std::unique_ptr<FiltroStrategy> createTipoFiltro(const QString& tipo);
     static std::unique_ptr<FiltroStrategy> createAnnoFiltro(int annoMin, int annoMax);
-    static std::unique_ptr<FiltroStrategy> createAutoreFiltro(const QString& autore);
-    static std::unique_ptr<FiltroStrategy> createRegistaFiltro(const QString& regista);
-    static std::unique_ptr<FiltroStrategy> createRivistaFiltro(const QString& rivista);
+    static std::unique_ptr<FiltroStrategy> createAutoreFiltro(const QString& autore,
+        FiltroCriterio::Modalita modalita = FiltroCriterio::Contiene);
+    static std::unique_ptr<FiltroStrategy> createRegistaFiltro(const QString& regista,
+        FiltroCriterio::Modalita modalita = FiltroCriterio::Contiene);
+    static std::unique_ptr<FiltroStrategy> createRivistaFiltro(const QString& rivista,
+        FiltroCriterio::Modalita modalita = FiltroCriterio::Contiene);
+    
+    // Interpreta "=valore" come ricerca esatta e "valore*" come prefisso
+    static FiltroCriterio::Modalita modalitaDaTesto(QString& testo);
 };
 
 #endif
\ No newline at end of file
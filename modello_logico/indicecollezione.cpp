@@ -0,0 +1,225 @@
+#include "indicecollezione.h"
+#include "media.h"
+#include "indicetestuale.h"
+#include "testoricerca.h"
+#include "rapportomemoria.h"
+#include <algorithm>
+
+IndiceCollezione::IndiceCollezione(const std::vector<std::unique_ptr<Media>>& media)
+    : m_media(media), m_indiceTestuale(nullptr), m_tipiValido(false), m_attributiValido(false)
+{
+}
+
+const QStringList& IndiceCollezione::getAttributiIndicizzati()
+{
+    static const QStringList attributi = {
+        "autore", "regista", "rivista", "attore", "editore", "isbn"
+    };
+    return attributi;
+}
+
+void IndiceCollezione::mediaAggiunto(size_t posizione)
+{
+    if (posizione >= m_media.size() || !m_media[posizione]) {
+        return;
+    }
+
+    if (m_tipiValido) {
+        QString tipo = m_media[posizione]->getTypeDisplayName().toLower();
+        m_perTipo[tipo].push_back(static_cast<uint32_t>(posizione));
+    }
+    if (m_attributiValido) {
+        indicizzaAttributi(posizione);
+    }
+}
+
+void IndiceCollezione::invalida()
+{
+    m_tipiValido = false;
+    m_perTipo.clear();
+    m_attributiValido = false;
+    m_perAttributo.clear();
+}
+
+void IndiceCollezione::setIndiceTestuale(const IndiceTestuale* indiceTestuale)
+{
+    m_indiceTestuale = indiceTestuale;
+}
+
+bool IndiceCollezione::puoRisolvere(const FiltroStrategy& filtro, size_t& stimaCandidati) const
+{
+    if (auto filtroTipo = dynamic_cast<const FiltroTipo*>(&filtro)) {
+        assicuraIndiceTipi();
+        auto it = m_perTipo.constFind(filtroTipo->getTipo().toLower());
+        stimaCandidati = (it != m_perTipo.constEnd()) ? it->size() : 0;
+        return true;
+    }
+    if (auto filtroTesto = dynamic_cast<const FiltroTesto*>(&filtro)) {
+        // Con punteggiatura o simboli la sottostringa può attraversare più termini
+        if (!m_indiceTestuale || !TestoRicerca::soloParole(filtroTesto->getTesto())) {
+            return false;
+        }
+        stimaCandidati = m_indiceTestuale->mediaConParole(filtroTesto->getTesto()).size();
+        return true;
+    }
+
+    QString chiave;
+    bool prefisso = false;
+    const IndiceAttributo* indice = indiceAttributo(filtro, chiave, prefisso);
+    if (!indice) {
+        return false;
+    }
+
+    stimaCandidati = 0;
+    if (!prefisso) {
+        auto it = indice->find(chiave);
+        if (it != indice->end()) {
+            stimaCandidati = it->second.size();
+        }
+        return true;
+    }
+
+    // Limite superiore: un media con più valori nello stesso intervallo conta più volte
+    for (auto it = indice->lower_bound(chiave);
+         it != indice->end() && it->first.startsWith(chiave); ++it) {
+        stimaCandidati += it->second.size();
+    }
+    return true;
+}
+
+PosizioniMedia IndiceCollezione::candidati(const FiltroStrategy& filtro) const
+{
+    if (auto filtroTipo = dynamic_cast<const FiltroTipo*>(&filtro)) {
+        assicuraIndiceTipi();
+        return m_perTipo.value(filtroTipo->getTipo().toLower());
+    }
+    if (auto filtroTesto = dynamic_cast<const FiltroTesto*>(&filtro)) {
+        return m_indiceTestuale ? m_indiceTestuale->mediaConParole(filtroTesto->getTesto()) : PosizioniMedia();
+    }
+
+    QString chiave;
+    bool prefisso = false;
+    const IndiceAttributo* indice = indiceAttributo(filtro, chiave, prefisso);
+    if (!indice) {
+        return PosizioniMedia();
+    }
+
+    if (!prefisso) {
+        auto it = indice->find(chiave);
+        return it != indice->end() ? it->second : PosizioniMedia();
+    }
+
+    PosizioniMedia risultato;
+    size_t liste = 0;
+    for (auto it = indice->lower_bound(chiave);
+         it != indice->end() && it->first.startsWith(chiave); ++it) {
+        risultato.insert(risultato.end(), it->second.begin(), it->second.end());
+        ++liste;
+    }
+    if (liste > 1) {
+        std::sort(risultato.begin(), risultato.end());
+        risultato.erase(std::unique(risultato.begin(), risultato.end()), risultato.end());
+    }
+    return risultato;
+}
+
+qint64 IndiceCollezione::byteOccupati() const
+{
+    auto bytePosizioni = [](const PosizioniMedia& posizioni) {
+        return RapportoMemoria::byteAllocazione(posizioni.capacity() * sizeof(uint32_t));
+    };
+
+    qint64 byte = RapportoMemoria::byteHash(m_perTipo.size(), sizeof(QString) + sizeof(PosizioniMedia));
+    for (auto it = m_perTipo.cbegin(); it != m_perTipo.cend(); ++it) {
+        byte += RapportoMemoria::byteStringa(it.key()) + bytePosizioni(it.value());
+    }
+
+    byte += RapportoMemoria::byteHash(m_perAttributo.size(), sizeof(QString) + sizeof(IndiceAttributo));
+    for (auto it = m_perAttributo.cbegin(); it != m_perAttributo.cend(); ++it) {
+        byte += RapportoMemoria::byteStringa(it.key());
+        for (const auto& voce : it.value()) {
+            byte += RapportoMemoria::byteNodoMappa(sizeof(QString) + sizeof(PosizioniMedia))
+                    + RapportoMemoria::byteStringa(voce.first) + bytePosizioni(voce.second);
+        }
+    }
+    return byte;
+}
+
+const IndiceCollezione::IndiceAttributo* IndiceCollezione::indiceAttributo(
+    const FiltroStrategy& filtro, QString& chiave, bool& prefisso) const
+{
+    auto criterio = dynamic_cast<const FiltroCriterio*>(&filtro);
+    if (!criterio || criterio->getModalita() == FiltroCriterio::Contiene) {
+        // La ricerca per sottostringa non è risolvibile da un indice ordinato
+        return nullptr;
+    }
+    if (!getAttributiIndicizzati().contains(criterio->getCriterio())) {
+        return nullptr;
+    }
+
+    chiave = FiltroCriterio::normalizzaValore(criterio->getValore());
+    prefisso = criterio->getModalita() == FiltroCriterio::Prefisso;
+    if (prefisso && chiave.isEmpty()) {
+        // Un prefisso vuoto accetta tutto: l'indice non aiuta
+        return nullptr;
+    }
+
+    assicuraIndiciAttributi();
+    auto it = m_perAttributo.constFind(criterio->getCriterio());
+    return it != m_perAttributo.constEnd() ? &it.value() : nullptr;
+}
+
+void IndiceCollezione::assicuraIndiceTipi() const
+{
+    if (m_tipiValido) {
+        return;
+    }
+
+    m_perTipo.clear();
+    for (size_t i = 0; i < m_media.size(); ++i) {
+        if (m_media[i]) {
+            m_perTipo[m_media[i]->getTypeDisplayName().toLower()].push_back(static_cast<uint32_t>(i));
+        }
+    }
+    m_tipiValido = true;
+}
+
+void IndiceCollezione::assicuraIndiciAttributi() const
+{
+    if (m_attributiValido) {
+        return;
+    }
+
+    m_perAttributo.clear();
+    for (const QString& attributo : getAttributiIndicizzati()) {
+        m_perAttributo.insert(attributo, IndiceAttributo());
+    }
+    for (size_t i = 0; i < m_media.size(); ++i) {
+        indicizzaAttributi(i);
+    }
+    m_attributiValido = true;
+}
+
+void IndiceCollezione::indicizzaAttributi(size_t posizione) const
+{
+    const Media* media = m_media[posizione].get();
+    if (!media) {
+        return;
+    }
+
+    uint32_t pos = static_cast<uint32_t>(posizione);
+    for (const QString& attributo : getAttributiIndicizzati()) {
+        IndiceAttributo& indice = m_perAttributo[attributo];
+        for (const QString& valore : media->getValoriAttributo(attributo)) {
+            QString chiave = FiltroCriterio::normalizzaValore(valore);
+            if (chiave.isEmpty()) {
+                continue;
+            }
+            // Le posizioni arrivano in ordine crescente: basta evitare i duplicati in coda
+            PosizioniMedia& posizioni = indice[chiave];
+            if (posizioni.empty() || posizioni.back() != pos) {
+                posizioni.push_back(pos);
+            }
+        }
+    }
+}
@@ -0,0 +1,69 @@
+#ifndef INDICECOLLEZIONE_H
+#define INDICECOLLEZIONE_H
+
+#include "pianificatorefiltri.h"
+#include <QHash>
+#include <QString>
+#include <QStringList>
+#include <map>
+#include <memory>
+#include <vector>
+
+class Media;
+class IndiceTestuale;
+
+/**
+ * @brief Indici secondari della collezione, costruiti su richiesta
+ *
+ * Gli indici memorizzano posizioni nel vettore dei media: le aggiunte in coda
+ * li aggiornano direttamente, le altre modifiche li invalidano e vengono
+ * ricostruiti al primo utilizzo successivo.
+ *
+ * I filtri di testo fatti di sole parole si risolvono con il vocabolario
+ * dell'indice testuale, se impostato: i media scartati non vengono letti,
+ * né le loro descrizioni compresse o ancora nel file. Le ricerche con
+ * punteggiatura restano per sottostringa su ogni media.
+ */
+class IndiceCollezione : public SorgenteIndici
+{
+public:
+    explicit IndiceCollezione(const std::vector<std::unique_ptr<Media>>& media);
+
+    // Sincronizzazione con la collezione
+    void mediaAggiunto(size_t posizione);
+    void invalida();
+    void setIndiceTestuale(const IndiceTestuale* indiceTestuale);
+
+    // SorgenteIndici
+    bool puoRisolvere(const FiltroStrategy& filtro, size_t& stimaCandidati) const override;
+    PosizioniMedia candidati(const FiltroStrategy& filtro) const override;
+
+    // Attributi di FiltroCriterio coperti dagli indici per valore
+    static const QStringList& getAttributiIndicizzati();
+
+    // Stima della memoria degli indici costruiti (vedi RapportoMemoria)
+    qint64 byteOccupati() const;
+
+private:
+    // Valori normalizzati ordinati: la ricerca per prefisso è un intervallo contiguo
+    using IndiceAttributo = std::map<QString, PosizioniMedia>;
+
+    void assicuraIndiceTipi() const;
+    void assicuraIndiciAttributi() const;
+    void indicizzaAttributi(size_t posizione) const;
+    const IndiceAttributo* indiceAttributo(const FiltroStrategy& filtro, QString& chiave,
+                                           bool& prefisso) const;
+
+    const std::vector<std::unique_ptr<Media>>& m_media;
+    const IndiceTestuale* m_indiceTestuale;
+
+    // Partizione per tipo di media
+    mutable bool m_tipiValido;
+    mutable QHash<QString, PosizioniMedia> m_perTipo;
+
+    // Indici per attributo (autore, regista, ...), anche multi-valore
+    mutable bool m_attributiValido;
+    mutable QHash<QString, IndiceAttributo> m_perAttributo;
+};
+
+#endif
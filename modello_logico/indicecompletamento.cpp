@@ -0,0 +1,327 @@
+#include "indicecompletamento.h"
+#include "media.h"
+#include "rapportomemoria.h"
+#include <algorithm>
+
+// IndiceCompletamento
+IndiceCompletamento::IndiceCompletamento()
+{
+    clear();
+}
+
+void IndiceCompletamento::clear()
+{
+    m_nodi.clear();
+    m_nodi.emplace_back();
+    m_archi.clear();
+    m_migliori.clear();
+    m_termini.clear();
+    m_perChiave.clear();
+}
+
+void IndiceCompletamento::aggiungi(const QString& valore)
+{
+    QString chiave = valore.trimmed().toLower();
+    if (chiave.isEmpty()) {
+        return;
+    }
+
+    uint32_t id;
+    auto it = m_perChiave.constFind(chiave);
+    if (it != m_perChiave.constEnd()) {
+        id = it.value();
+    } else {
+        id = static_cast<uint32_t>(m_termini.size());
+        m_termini.push_back({valore.trimmed(), 0});
+        m_perChiave.insert(chiave, id);
+    }
+    const bool nuovoPresente = m_termini[id].occorrenze++ == 0;
+
+    // Il peso cresce: ogni nodo del percorso può solo guadagnare questo termine
+    uint32_t nodo = 0;
+    for (QChar carattere : chiave) {
+        nodo = figlioOCrea(nodo, carattere);
+        Nodo& corrente = m_nodi[nodo];
+        if (nuovoPresente) {
+            ++corrente.termini;
+        }
+        if (corrente.migliori == NESSUNO || corrente.daRicalcolare) {
+            continue;
+        }
+
+        uint32_t* inizio = m_migliori.data() + corrente.migliori;
+        uint32_t* fine = inizio + corrente.numeroMigliori;
+        if (std::find(inizio, fine, id) == fine) {
+            if (corrente.numeroMigliori < MAX_SUGGERIMENTI) {
+                *fine++ = id;
+                ++corrente.numeroMigliori;
+            } else if (precede(id, *(fine - 1))) {
+                *(fine - 1) = id;
+            } else {
+                continue;
+            }
+        }
+        std::sort(inizio, fine, [this](uint32_t a, uint32_t b) { return precede(a, b); });
+    }
+    m_nodi[nodo].termine = static_cast<int32_t>(id);
+}
+
+void IndiceCompletamento::rimuovi(const QString& valore)
+{
+    QString chiave = valore.trimmed().toLower();
+    auto it = m_perChiave.constFind(chiave);
+    if (it == m_perChiave.constEnd() || m_termini[it.value()].occorrenze == 0) {
+        return;
+    }
+
+    uint32_t id = it.value();
+    const bool assente = --m_termini[id].occorrenze == 0;
+
+    // Il termine può scendere sotto un candidato escluso: ricalcolo pigro
+    uint32_t nodo = 0;
+    for (QChar carattere : chiave) {
+        nodo = figlio(nodo, carattere);
+        if (nodo == NESSUNO) {
+            return;
+        }
+        Nodo& corrente = m_nodi[nodo];
+        if (assente) {
+            --corrente.termini;
+        }
+        if (corrente.migliori == NESSUNO) {
+            continue;
+        }
+        const uint32_t* inizio = m_migliori.data() + corrente.migliori;
+        const uint32_t* fine = inizio + corrente.numeroMigliori;
+        if (std::find(inizio, fine, id) != fine) {
+            corrente.daRicalcolare = true;
+        }
+    }
+}
+
+QStringList IndiceCompletamento::completa(const QString& prefisso, int massimo) const
+{
+    QStringList risultato;
+    QString chiave = prefisso.trimmed().toLower();
+    if (chiave.isEmpty() || massimo <= 0) {
+        return risultato;
+    }
+
+    uint32_t nodo = 0;
+    for (QChar carattere : chiave) {
+        nodo = figlio(nodo, carattere);
+        if (nodo == NESSUNO) {
+            return risultato;
+        }
+    }
+
+    const Nodo& trovato = m_nodi[nodo];
+    if (massimo <= MAX_SUGGERIMENTI && (trovato.migliori != NESSUNO || trovato.termini >= SOGLIA_MIGLIORI)) {
+        if (trovato.migliori == NESSUNO || trovato.daRicalcolare) {
+            ricalcola(nodo);
+        }
+        int quanti = std::min(static_cast<int>(trovato.numeroMigliori), massimo);
+        for (int i = 0; i < quanti; ++i) {
+            risultato << m_termini[m_migliori[trovato.migliori + i]].forma;
+        }
+        return risultato;
+    }
+
+    // Sottoalberi piccoli o richieste più ampie della cache: visita del sottoalbero
+    std::vector<uint32_t> termini;
+    raccogli(nodo, termini);
+    size_t limite = std::min(termini.size(), static_cast<size_t>(massimo));
+    std::partial_sort(termini.begin(), termini.begin() + limite, termini.end(),
+                      [this](uint32_t a, uint32_t b) { return precede(a, b); });
+    for (size_t i = 0; i < limite; ++i) {
+        risultato << m_termini[termini[i]].forma;
+    }
+    return risultato;
+}
+
+qint64 IndiceCompletamento::byteOccupati() const
+{
+    qint64 byte = RapportoMemoria::byteAllocazione(m_nodi.capacity() * sizeof(Nodo))
+                  + RapportoMemoria::byteAllocazione(m_archi.capacity() * sizeof(Arco))
+                  + RapportoMemoria::byteAllocazione(m_migliori.capacity() * sizeof(uint32_t));
+
+    byte += RapportoMemoria::byteAllocazione(m_termini.capacity() * sizeof(Termine));
+    for (const Termine& termine : m_termini) {
+        byte += RapportoMemoria::byteStringa(termine.forma);
+    }
+
+    byte += RapportoMemoria::byteHash(m_perChiave.size(), sizeof(QString) + sizeof(uint32_t));
+    for (auto it = m_perChiave.cbegin(); it != m_perChiave.cend(); ++it) {
+        byte += RapportoMemoria::byteStringa(it.key());
+    }
+    return byte;
+}
+
+uint32_t IndiceCompletamento::figlio(uint32_t nodo, QChar carattere) const
+{
+    const Nodo& padre = m_nodi[nodo];
+    auto inizio = m_archi.begin() + padre.primoArco;
+    auto fine = inizio + padre.numeroArchi;
+    auto it = std::lower_bound(inizio, fine, carattere,
+                               [](const Arco& arco, QChar c) { return arco.carattere < c; });
+    return (it != fine && it->carattere == carattere) ? it->nodo : NESSUNO;
+}
+
+uint32_t IndiceCompletamento::figlioOCrea(uint32_t nodo, QChar carattere)
+{
+    auto inizio = m_archi.begin() + m_nodi[nodo].primoArco;
+    auto fine = inizio + m_nodi[nodo].numeroArchi;
+    auto it = std::lower_bound(inizio, fine, carattere,
+                               [](const Arco& arco, QChar c) { return arco.carattere < c; });
+    if (it != fine && it->carattere == carattere) {
+        return it->nodo;
+    }
+    const uint32_t posizione = static_cast<uint32_t>(it - inizio);
+
+    // La capacità è la potenza di due successiva: con un numero di archi pari a una
+    // potenza di due l'intervallo è pieno e passa in coda con capacità doppia.
+    // Quello vecchio resta inutilizzato, al più quanto gli archi in uso
+    const uint32_t numero = m_nodi[nodo].numeroArchi;
+    if ((numero & (numero - 1)) == 0) {
+        const uint32_t primo = static_cast<uint32_t>(m_archi.size());
+        m_archi.resize(primo + std::max(numero * 2, 1u));
+        std::copy_n(m_archi.begin() + m_nodi[nodo].primoArco, numero, m_archi.begin() + primo);
+        m_nodi[nodo].primoArco = primo;
+    }
+
+    const uint32_t nuovo = static_cast<uint32_t>(m_nodi.size());
+    Arco* archi = m_archi.data() + m_nodi[nodo].primoArco;
+    std::copy_backward(archi + posizione, archi + numero, archi + numero + 1);
+    archi[posizione] = {carattere, nuovo};
+    ++m_nodi[nodo].numeroArchi;
+    m_nodi.emplace_back();
+    return nuovo;
+}
+
+bool IndiceCompletamento::precede(uint32_t a, uint32_t b) const
+{
+    if (m_termini[a].occorrenze != m_termini[b].occorrenze) {
+        return m_termini[a].occorrenze > m_termini[b].occorrenze;
+    }
+    return m_termini[a].forma.compare(m_termini[b].forma, Qt::CaseInsensitive) < 0;
+}
+
+void IndiceCompletamento::raccogli(uint32_t nodo, std::vector<uint32_t>& termini) const
+{
+    const Nodo& corrente = m_nodi[nodo];
+    if (corrente.termine >= 0 && m_termini[corrente.termine].occorrenze > 0) {
+        termini.push_back(static_cast<uint32_t>(corrente.termine));
+    }
+    for (uint32_t i = 0; i < corrente.numeroArchi; ++i) {
+        uint32_t figlio = m_archi[corrente.primoArco + i].nodo;
+        // Sottoalberi rimasti senza termini presenti
+        if (m_nodi[figlio].termini > 0) {
+            raccogli(figlio, termini);
+        }
+    }
+}
+
+void IndiceCompletamento::ricalcola(uint32_t nodo) const
+{
+    std::vector<uint32_t> termini;
+    raccogli(nodo, termini);
+    size_t limite = std::min(termini.size(), static_cast<size_t>(MAX_SUGGERIMENTI));
+    std::partial_sort(termini.begin(), termini.begin() + limite, termini.end(),
+                      [this](uint32_t a, uint32_t b) { return precede(a, b); });
+
+    Nodo& corrente = m_nodi[nodo];
+    if (corrente.migliori == NESSUNO) {
+        corrente.migliori = static_cast<uint32_t>(m_migliori.size());
+        m_migliori.resize(m_migliori.size() + MAX_SUGGERIMENTI);
+    }
+    std::copy_n(termini.begin(), limite, m_migliori.begin() + corrente.migliori);
+    corrente.numeroMigliori = static_cast<uint8_t>(limite);
+    corrente.daRicalcolare = false;
+}
+
+// CompletamentiCollezione
+const QStringList& CompletamentiCollezione::getCampi()
+{
+    static const QStringList campi = {"titolo", "autore", "regista", "rivista"};
+    return campi;
+}
+
+QStringList CompletamentiCollezione::valoriCampo(const Media& media, const QString& campo)
+{
+    if (campo == "titolo") {
+        return QStringList{media.getTitolo()};
+    }
+    return media.getValoriAttributo(campo);
+}
+
+void CompletamentiCollezione::mediaAggiunto(const Media& media)
+{
+    // Con una ricostruzione in sospeso il media verrà letto dalla collezione
+    if (!m_daRicostruire) {
+        indicizza(media);
+    }
+}
+
+void CompletamentiCollezione::mediaRimosso(const Media& media)
+{
+    if (m_daRicostruire) {
+        return;
+    }
+    for (const QString& campo : getCampi()) {
+        IndiceCompletamento& indice = m_perCampo[campo];
+        for (const QString& valore : valoriCampo(media, campo)) {
+            indice.rimuovi(valore);
+        }
+    }
+}
+
+void CompletamentiCollezione::ricostruisci(const std::vector<std::unique_ptr<Media>>& media)
+{
+    m_perCampo.clear();
+    m_daRicostruire = &media;
+}
+
+QStringList CompletamentiCollezione::completa(const QString& campo, const QString& prefisso,
+                                              int massimo) const
+{
+    assicuraCostruito();
+    auto it = m_perCampo.constFind(campo);
+    if (it == m_perCampo.constEnd()) {
+        return QStringList();
+    }
+    return it.value().completa(prefisso, massimo);
+}
+
+qint64 CompletamentiCollezione::byteOccupati() const
+{
+    qint64 byte = RapportoMemoria::byteHash(m_perCampo.size(), sizeof(QString) + sizeof(IndiceCompletamento));
+    for (const IndiceCompletamento& indice : m_perCampo) {
+        byte += indice.byteOccupati();
+    }
+    return byte;
+}
+
+void CompletamentiCollezione::indicizza(const Media& media) const
+{
+    for (const QString& campo : getCampi()) {
+        IndiceCompletamento& indice = m_perCampo[campo];
+        for (const QString& valore : valoriCampo(media, campo)) {
+            indice.aggiungi(valore);
+        }
+    }
+}
+
+void CompletamentiCollezione::assicuraCostruito() const
+{
+    if (!m_daRicostruire) {
+        return;
+    }
+
+    const auto& media = *m_daRicostruire;
+    m_daRicostruire = nullptr;
+    for (const auto& elemento : media) {
+        if (elemento) {
+            indicizza(*elemento);
+        }
+    }
+}
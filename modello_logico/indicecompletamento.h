@@ -0,0 +1,111 @@
+#ifndef INDICECOMPLETAMENTO_H
+#define INDICECOMPLETAMENTO_H
+
+#include <QHash>
+#include <QString>
+#include <QStringList>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+class Media;
+
+/**
+ * @brief Trie dei prefissi per l'autocompletamento
+ *
+ * Nodi, archi e cache dei migliori termini stanno in tre vettori condivisi:
+ * ogni nodo indica l'inizio e la lunghezza del proprio intervallo di archi,
+ * ordinati per carattere, con capacità pari alla potenza di due successiva
+ * (un intervallo pieno viene spostato in coda). I nodi con almeno
+ * SOGLIA_MIGLIORI termini nel sottoalbero conservano i migliori (per numero
+ * di occorrenze) in un blocco di MAX_SUGGERIMENTI posizioni, così una
+ * richiesta costa solo la discesa sul prefisso; gli altri visitano il
+ * proprio piccolo sottoalbero. Le aggiunte aggiornano i blocchi lungo il
+ * percorso, le rimozioni li marcano da ricalcolare alla prima richiesta.
+ */
+class IndiceCompletamento
+{
+public:
+    IndiceCompletamento();
+
+    void aggiungi(const QString& valore);
+    void rimuovi(const QString& valore);
+    void clear();
+
+    QStringList completa(const QString& prefisso, int massimo = MAX_SUGGERIMENTI) const;
+    size_t numeroTermini() const { return m_perChiave.size(); }
+    qint64 byteOccupati() const;
+
+    static const int MAX_SUGGERIMENTI = 10;
+
+private:
+    static const uint32_t NESSUNO = UINT32_MAX;
+    static const uint32_t SOGLIA_MIGLIORI = 32;
+
+    struct Termine {
+        QString forma;
+        int occorrenze;
+    };
+
+    struct Arco {
+        QChar carattere;
+        uint32_t nodo;
+    };
+
+    struct Nodo {
+        uint32_t primoArco = 0;             // in m_archi
+        uint32_t numeroArchi = 0;
+        int32_t termine = -1;
+        uint32_t termini = 0;               // termini presenti nel sottoalbero
+        uint32_t migliori = NESSUNO;        // blocco in m_migliori
+        uint8_t numeroMigliori = 0;
+        bool daRicalcolare = false;
+    };
+
+    uint32_t figlio(uint32_t nodo, QChar carattere) const;
+    uint32_t figlioOCrea(uint32_t nodo, QChar carattere);
+    bool precede(uint32_t a, uint32_t b) const;
+    void raccogli(uint32_t nodo, std::vector<uint32_t>& termini) const;
+    void ricalcola(uint32_t nodo) const;
+
+    mutable std::vector<Nodo> m_nodi;
+    std::vector<Arco> m_archi;
+    mutable std::vector<uint32_t> m_migliori;
+    std::vector<Termine> m_termini;
+    QHash<QString, uint32_t> m_perChiave;
+};
+
+/**
+ * @brief Completamenti per i campi di ricerca della collezione
+ *
+ * Mantiene un trie per ciascun campo (titolo, autore, regista, rivista),
+ * aggiornato dalla collezione a ogni modifica dei media.
+ */
+class CompletamentiCollezione
+{
+public:
+    void mediaAggiunto(const Media& media);
+    void mediaRimosso(const Media& media);
+    
+    // Differita al primo completamento: dopo un caricamento pigro non forza la lettura dei campi freddi
+    void ricostruisci(const std::vector<std::unique_ptr<Media>>& media);
+
+    QStringList completa(const QString& campo, const QString& prefisso,
+                         int massimo = IndiceCompletamento::MAX_SUGGERIMENTI) const;
+
+    static const QStringList& getCampi();
+
+    // Stima della memoria dei trie (vedi RapportoMemoria); zero finché non sono costruiti
+    qint64 byteOccupati() const;
+
+private:
+    static QStringList valoriCampo(const Media& media, const QString& campo);
+    void indicizza(const Media& media) const;
+    void assicuraCostruito() const;
+
+    // Media da cui ricostruire gli indici, nullptr se sono già aggiornati
+    mutable const std::vector<std::unique_ptr<Media>>* m_daRicostruire = nullptr;
+    mutable QHash<QString, IndiceCompletamento> m_perCampo;
+};
+
+#endif
@@ -0,0 +1,435 @@
+#include "indicetestuale.h"
+#include "distanzamodifica.h"
+#include "media.h"
+#include "rapportomemoria.h"
+#include "testoricerca.h"
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+
+IndiceTestuale::IndiceTestuale(const std::vector<std::unique_ptr<Media>>& media)
+    : m_media(media), m_valido(false)
+{
+    m_lunghezzeTotali.fill(0);
+}
+
+void IndiceTestuale::mediaAggiunto(size_t posizione)
+{
+    if (m_valido && posizione < m_media.size()) {
+        indicizza(posizione);
+    }
+}
+
+void IndiceTestuale::invalida()
+{
+    m_valido = false;
+    m_perTermine.clear();
+    m_termini.clear();
+    m_occorrenze.clear();
+    m_documentiPerTermine.clear();
+    m_perTrigramma.clear();
+    m_lunghezze.clear();
+    m_lunghezzeTotali.fill(0);
+    m_contatori.clear();
+}
+
+int IndiceTestuale::distanzaMassima(int lunghezza)
+{
+    if (lunghezza <= 3) return 0;
+    if (lunghezza <= 6) return 1;
+    return 2;
+}
+
+std::vector<IndiceTestuale::Risultato> IndiceTestuale::cercaApprossimata(const QString& testo,
+                                                                         size_t massimo) const
+{
+    std::vector<Risultato> risultati;
+    QStringList parole = TestoRicerca::tokenizza(testo);
+    if (parole.isEmpty()) {
+        return risultati;
+    }
+
+    assicuraIndice();
+
+    // Tutte le parole devono trovare corrispondenza (AND); l'ultima anche come prefisso
+    QHash<uint32_t, double> punteggi;
+    for (qsizetype i = 0; i < parole.size(); ++i) {
+        bool ultima = (i == parole.size() - 1);
+        QHash<uint32_t, double> parziali;
+
+        for (const TermineSimile& simile : terminiSimili(parole.at(i), ultima)) {
+            for (const Occorrenza& occorrenza : m_occorrenze[simile.termine]) {
+                if (i > 0 && !punteggi.contains(occorrenza.posizione)) {
+                    continue;
+                }
+                double valore = simile.somiglianza * pesoCampo(occorrenza.campo);
+                double& migliore = parziali[occorrenza.posizione];
+                migliore = std::max(migliore, valore);
+            }
+        }
+
+        if (i == 0) {
+            punteggi = std::move(parziali);
+        } else {
+            QHash<uint32_t, double> intersezione;
+            for (auto it = parziali.constBegin(); it != parziali.constEnd(); ++it) {
+                intersezione.insert(it.key(), punteggi.value(it.key()) + it.value());
+            }
+            punteggi = std::move(intersezione);
+        }
+
+        if (punteggi.isEmpty()) {
+            return risultati;
+        }
+    }
+
+    risultati.reserve(punteggi.size());
+    for (auto it = punteggi.constBegin(); it != punteggi.constEnd(); ++it) {
+        risultati.push_back({it.key(), it.value()});
+    }
+
+    auto ordine = [](const Risultato& a, const Risultato& b) {
+        if (a.punteggio != b.punteggio) return a.punteggio > b.punteggio;
+        return a.posizione < b.posizione;
+    };
+    if (massimo > 0 && massimo < risultati.size()) {
+        std::partial_sort(risultati.begin(), risultati.begin() + massimo, risultati.end(), ordine);
+        risultati.resize(massimo);
+    } else {
+        std::sort(risultati.begin(), risultati.end(), ordine);
+    }
+    return risultati;
+}
+
+std::vector<IndiceTestuale::Risultato> IndiceTestuale::punteggiRilevanza(const QString& testo) const
+{
+    std::vector<Risultato> risultati;
+    QStringList parole = TestoRicerca::tokenizza(testo);
+    if (parole.isEmpty()) {
+        return risultati;
+    }
+
+    assicuraIndice();
+
+    const size_t tipi = CampoRicercabile::NUMERO_TIPI;
+    const double documenti = static_cast<double>(m_media.size());
+    if (documenti == 0) {
+        return risultati;
+    }
+
+    std::array<double, CampoRicercabile::NUMERO_TIPI> medie;
+    for (size_t campo = 0; campo < tipi; ++campo) {
+        medie[campo] = std::max(1.0, m_lunghezzeTotali[campo] / documenti);
+    }
+
+    parole.removeDuplicates();
+    QHash<uint32_t, double> punteggi;
+
+    for (const QString& parola : parole) {
+        auto it = m_perTermine.constFind(parola);
+        if (it == m_perTermine.constEnd()) {
+            continue;
+        }
+
+        uint32_t termine = it.value();
+        double df = m_documentiPerTermine[termine];
+        double idf = std::log(1.0 + (documenti - df + 0.5) / (df + 0.5));
+
+        // Le occorrenze dello stesso media sono contigue (una per campo):
+        // la frequenza pesata per campo si accumula prima della saturazione
+        const auto& occorrenze = m_occorrenze[termine];
+        for (size_t i = 0; i < occorrenze.size();) {
+            uint32_t posizione = occorrenze[i].posizione;
+            double frequenzaPesata = 0.0;
+            for (; i < occorrenze.size() && occorrenze[i].posizione == posizione; ++i) {
+                uint8_t campo = occorrenze[i].campo;
+                double lunghezza = m_lunghezze[size_t(posizione) * tipi + campo];
+                double normalizzazione = 1.0 - BM25_B + BM25_B * lunghezza / medie[campo];
+                frequenzaPesata += pesoCampo(campo) * occorrenze[i].frequenza / normalizzazione;
+            }
+            punteggi[posizione] += idf * frequenzaPesata * (BM25_K1 + 1.0) / (BM25_K1 + frequenzaPesata);
+        }
+    }
+
+    risultati.reserve(punteggi.size());
+    for (auto it = punteggi.constBegin(); it != punteggi.constEnd(); ++it) {
+        risultati.push_back({it.key(), it.value()});
+    }
+    return risultati;
+}
+
+std::vector<uint32_t> IndiceTestuale::mediaConParole(const QString& testo) const
+{
+    std::vector<uint32_t> risultato;
+    QStringList parole = TestoRicerca::tokenizza(testo);
+    if (parole.isEmpty()) {
+        return risultato;
+    }
+
+    assicuraIndice();
+    parole.removeDuplicates();
+
+    for (qsizetype i = 0; i < parole.size(); ++i) {
+        std::vector<uint32_t> media;
+        for (uint32_t termine : terminiContenenti(parole.at(i))) {
+            for (const Occorrenza& occorrenza : m_occorrenze[termine]) {
+                media.push_back(occorrenza.posizione);
+            }
+        }
+        std::sort(media.begin(), media.end());
+        media.erase(std::unique(media.begin(), media.end()), media.end());
+
+        // Tutte le parole devono comparire (AND)
+        if (i == 0) {
+            risultato = std::move(media);
+        } else {
+            std::vector<uint32_t> intersezione;
+            std::set_intersection(risultato.begin(), risultato.end(), media.begin(), media.end(),
+                                  std::back_inserter(intersezione));
+            risultato = std::move(intersezione);
+        }
+        if (risultato.empty()) {
+            break;
+        }
+    }
+    return risultato;
+}
+
+qint64 IndiceTestuale::byteOccupati() const
+{
+    // Le chiavi di m_perTermine condividono i dati con m_termini: il testo si conta una volta
+    qint64 byte = RapportoMemoria::byteHash(m_perTermine.size(), sizeof(QString) + sizeof(uint32_t));
+    byte += RapportoMemoria::byteAllocazione(m_termini.capacity() * sizeof(QString));
+    for (const QString& termine : m_termini) {
+        byte += RapportoMemoria::byteStringa(termine);
+    }
+
+    byte += RapportoMemoria::byteAllocazione(m_occorrenze.capacity() * sizeof(std::vector<Occorrenza>));
+    for (const auto& occorrenze : m_occorrenze) {
+        byte += RapportoMemoria::byteAllocazione(occorrenze.capacity() * sizeof(Occorrenza));
+    }
+    byte += RapportoMemoria::byteAllocazione(m_documentiPerTermine.capacity() * sizeof(uint32_t));
+
+    byte += RapportoMemoria::byteHash(m_perTrigramma.size(), sizeof(uint64_t) + sizeof(std::vector<uint32_t>));
+    for (const auto& termini : m_perTrigramma) {
+        byte += RapportoMemoria::byteAllocazione(termini.capacity() * sizeof(uint32_t));
+    }
+
+    byte += RapportoMemoria::byteAllocazione(m_lunghezze.capacity() * sizeof(uint16_t));
+    byte += RapportoMemoria::byteAllocazione(m_contatori.capacity() * sizeof(uint16_t));
+    return byte;
+}
+
+std::vector<uint32_t> IndiceTestuale::terminiContenenti(const QString& parola) const
+{
+    std::vector<uint32_t> termini;
+
+    if (parola.size() < 3) {
+        // Nessun trigramma interno: si scorre il vocabolario, molto più piccolo dei media
+        for (size_t termine = 0; termine < m_termini.size(); ++termine) {
+            if (m_termini[termine].contains(parola)) {
+                termini.push_back(static_cast<uint32_t>(termine));
+            }
+        }
+        return termini;
+    }
+
+    // Ogni termine che contiene la parola ne contiene i trigrammi interni: si verificano
+    // solo i termini del trigramma più raro
+    const std::vector<uint32_t>* piuRaro = nullptr;
+    for (qsizetype i = 0; i + 2 < parola.size(); ++i) {
+        uint64_t chiave = (uint64_t(parola.at(i).unicode()) << 32)
+                        | (uint64_t(parola.at(i + 1).unicode()) << 16)
+                        | uint64_t(parola.at(i + 2).unicode());
+        auto it = m_perTrigramma.constFind(chiave);
+        if (it == m_perTrigramma.constEnd()) {
+            return termini;
+        }
+        if (!piuRaro || it.value().size() < piuRaro->size()) {
+            piuRaro = &it.value();
+        }
+    }
+
+    for (uint32_t termine : *piuRaro) {
+        if (m_termini[termine].contains(parola)) {
+            termini.push_back(termine);
+        }
+    }
+    return termini;
+}
+
+std::vector<IndiceTestuale::TermineSimile> IndiceTestuale::terminiSimili(const QString& parola,
+                                                                        bool comePrefisso) const
+{
+    std::vector<TermineSimile> simili;
+    const int lunghezza = static_cast<int>(parola.size());
+    const int limite = distanzaMassima(lunghezza);
+
+    auto esatto = m_perTermine.constFind(parola);
+    if (esatto != m_perTermine.constEnd() && !comePrefisso && limite == 0) {
+        simili.push_back({esatto.value(), 1.0});
+        return simili;
+    }
+
+    // Conteggio dei trigrammi condivisi per ogni termine del vocabolario. Per un prefisso
+    // il trigramma di bordo destro ("ol " in "tol") resta fuori da conteggio e soglia:
+    // "tolkien" non lo contiene, e con limite 0 verrebbe scartato
+    std::vector<uint64_t> propri;
+    trigrammi(parola, propri, !comePrefisso);
+
+    std::vector<uint32_t> toccati;
+    for (uint64_t trigramma : propri) {
+        auto it = m_perTrigramma.constFind(trigramma);
+        if (it == m_perTrigramma.constEnd()) {
+            continue;
+        }
+        for (uint32_t termine : it.value()) {
+            if (m_contatori[termine]++ == 0) {
+                toccati.push_back(termine);
+            }
+        }
+    }
+
+    // Ogni modifica (trasposizioni comprese) altera al più quattro trigrammi
+    const int soglia = std::max(1, static_cast<int>(propri.size()) - 4 * limite);
+    DistanzaModifica distanza(parola);
+
+    for (uint32_t termine : toccati) {
+        int condivisi = m_contatori[termine];
+        m_contatori[termine] = 0;
+        if (condivisi < soglia) {
+            continue;
+        }
+
+        const QString& candidato = m_termini[termine];
+        if (candidato == parola) {
+            simili.push_back({termine, 1.0});
+        } else if (comePrefisso && candidato.startsWith(parola)) {
+            simili.push_back({termine, 0.8});
+        } else {
+            int d = distanza.calcola(candidato, limite);
+            if (d <= limite) {
+                simili.push_back({termine, 1.0 - 0.3 * d});
+            }
+        }
+    }
+    return simili;
+}
+
+double IndiceTestuale::pesoCampo(uint8_t campo)
+{
+    switch (campo) {
+        case CampoRicercabile::Titolo: return 3.0;
+        case CampoRicercabile::Persone: return 2.0;
+        case CampoRicercabile::Descrizione: return 0.5;
+        default: return 1.0;
+    }
+}
+
+void IndiceTestuale::trigrammi(const QString& termine, std::vector<uint64_t>& risultato, bool bordoDestro)
+{
+    // Bordo a sinistra di due spazi e a destra di uno: anche le parole corte hanno trigrammi
+    QString bordato = QString("  ") + termine;
+    if (bordoDestro) {
+        bordato += QChar(' ');
+    }
+    risultato.clear();
+    for (qsizetype i = 0; i + 2 < bordato.size(); ++i) {
+        uint64_t chiave = (uint64_t(bordato.at(i).unicode()) << 32)
+                        | (uint64_t(bordato.at(i + 1).unicode()) << 16)
+                        | uint64_t(bordato.at(i + 2).unicode());
+        risultato.push_back(chiave);
+    }
+    std::sort(risultato.begin(), risultato.end());
+    risultato.erase(std::unique(risultato.begin(), risultato.end()), risultato.end());
+}
+
+void IndiceTestuale::assicuraIndice() const
+{
+    if (m_valido) {
+        return;
+    }
+
+    m_perTermine.clear();
+    m_termini.clear();
+    m_occorrenze.clear();
+    m_documentiPerTermine.clear();
+    m_perTrigramma.clear();
+    m_lunghezze.clear();
+    m_lunghezzeTotali.fill(0);
+    m_contatori.clear();
+
+    for (size_t i = 0; i < m_media.size(); ++i) {
+        indicizza(i);
+    }
+    m_valido = true;
+}
+
+uint32_t IndiceTestuale::idTermine(const QString& termine) const
+{
+    auto it = m_perTermine.constFind(termine);
+    if (it != m_perTermine.constEnd()) {
+        return it.value();
+    }
+
+    uint32_t id = static_cast<uint32_t>(m_termini.size());
+    m_perTermine.insert(termine, id);
+    m_termini.push_back(termine);
+    m_occorrenze.emplace_back();
+    m_documentiPerTermine.push_back(0);
+    m_contatori.push_back(0);
+
+    std::vector<uint64_t> propri;
+    trigrammi(termine, propri);
+    for (uint64_t trigramma : propri) {
+        m_perTrigramma[trigramma].push_back(id);
+    }
+    return id;
+}
+
+void IndiceTestuale::indicizza(size_t posizione) const
+{
+    const Media* media = m_media[posizione].get();
+    if (!media) {
+        return;
+    }
+
+    const size_t tipi = CampoRicercabile::NUMERO_TIPI;
+    if (m_lunghezze.size() < (posizione + 1) * tipi) {
+        m_lunghezze.resize((posizione + 1) * tipi, 0);
+    }
+
+    // Coppie (termine, campo) del media, una per parola
+    std::vector<std::pair<uint32_t, uint8_t>> coppie;
+    for (const CampoRicercabile& campo : media->getCampiRicercabili()) {
+        QStringList parole = TestoRicerca::tokenizza(campo.testo);
+        for (const QString& parola : parole) {
+            coppie.emplace_back(idTermine(parola), static_cast<uint8_t>(campo.tipo));
+        }
+
+        uint16_t& lunghezza = m_lunghezze[posizione * tipi + campo.tipo];
+        size_t nuova = std::min<size_t>(size_t(lunghezza) + parole.size(), UINT16_MAX);
+        m_lunghezzeTotali[campo.tipo] += nuova - lunghezza;
+        lunghezza = static_cast<uint16_t>(nuova);
+    }
+    std::sort(coppie.begin(), coppie.end());
+
+    // Le coppie uguali sono adiacenti: ogni gruppo diventa un'occorrenza con frequenza
+    uint32_t pos = static_cast<uint32_t>(posizione);
+    uint32_t ultimoTermine = UINT32_MAX;
+    for (size_t i = 0; i < coppie.size();) {
+        size_t fine = i;
+        while (fine < coppie.size() && coppie[fine] == coppie[i]) {
+            ++fine;
+        }
+
+        uint32_t termine = coppie[i].first;
+        uint16_t frequenza = static_cast<uint16_t>(std::min<size_t>(fine - i, UINT16_MAX));
+        m_occorrenze[termine].push_back({pos, coppie[i].second, frequenza});
+        if (termine != ultimoTermine) {
+            ++m_documentiPerTermine[termine];
+            ultimoTermine = termine;
+        }
+        i = fine;
+    }
+}
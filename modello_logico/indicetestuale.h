@@ -0,0 +1,98 @@
+#ifndef INDICETESTUALE_H
+#define INDICETESTUALE_H
+
+#include "media.h"
+#include <QHash>
+#include <QString>
+#include <QStringList>
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+/**
+ * @brief Indice invertito sui campi ricercabili dei media
+ *
+ * Vocabolario dei termini normalizzati, liste di occorrenze per termine e
+ * indice dei trigrammi del vocabolario. La ricerca approssimata genera i
+ * termini candidati dai trigrammi condivisi con la parola cercata e li
+ * verifica con la distanza di modifica limitata. La ricerca per rilevanza
+ * assegna a ogni media un punteggio BM25F, con i campi pesati per tipo.
+ *
+ * Come IndiceCollezione, viene costruito al primo utilizzo, aggiornato
+ * sulle aggiunte in coda e invalidato dalle altre modifiche.
+ */
+class IndiceTestuale
+{
+public:
+    struct Risultato {
+        uint32_t posizione;
+        double punteggio;
+    };
+
+    explicit IndiceTestuale(const std::vector<std::unique_ptr<Media>>& media);
+
+    // Sincronizzazione con la collezione
+    void mediaAggiunto(size_t posizione);
+    void invalida();
+
+    // Risultati ordinati per punteggio decrescente; massimo = 0 significa tutti
+    std::vector<Risultato> cercaApprossimata(const QString& testo, size_t massimo = 0) const;
+
+    // Punteggi BM25F dei media che contengono almeno una parola, non ordinati
+    std::vector<Risultato> punteggiRilevanza(const QString& testo) const;
+
+    // Posizioni (crescenti) dei media in cui ogni parola è contenuta in un termine,
+    // anche a metà: "ardin" trova "giardino". Solo vocabolario e occorrenze, nessun testo
+    std::vector<uint32_t> mediaConParole(const QString& testo) const;
+
+    // Errori tollerati in funzione della lunghezza della parola cercata
+    static int distanzaMassima(int lunghezza);
+
+    // Stima della memoria di vocabolario, occorrenze e trigrammi (vedi RapportoMemoria)
+    qint64 byteOccupati() const;
+
+private:
+    struct Occorrenza {
+        uint32_t posizione;
+        uint8_t campo;
+        uint16_t frequenza;
+    };
+
+    struct TermineSimile {
+        uint32_t termine;
+        double somiglianza;
+    };
+
+    void assicuraIndice() const;
+    void indicizza(size_t posizione) const;
+    uint32_t idTermine(const QString& termine) const;
+    std::vector<TermineSimile> terminiSimili(const QString& parola, bool comePrefisso) const;
+    std::vector<uint32_t> terminiContenenti(const QString& parola) const;
+
+    // Senza bordo destro per i prefissi: il trigramma finale non compare nei completamenti
+    static void trigrammi(const QString& termine, std::vector<uint64_t>& risultato, bool bordoDestro = true);
+    static double pesoCampo(uint8_t campo);
+
+    // Parametri BM25: saturazione della frequenza e normalizzazione per lunghezza
+    static constexpr double BM25_K1 = 1.2;
+    static constexpr double BM25_B = 0.75;
+
+    const std::vector<std::unique_ptr<Media>>& m_media;
+
+    mutable bool m_valido;
+    mutable QHash<QString, uint32_t> m_perTermine;
+    mutable std::vector<QString> m_termini;
+    mutable std::vector<std::vector<Occorrenza>> m_occorrenze;
+    mutable std::vector<uint32_t> m_documentiPerTermine;
+    mutable QHash<uint64_t, std::vector<uint32_t>> m_perTrigramma;
+
+    // Lunghezza in parole di ogni campo di ogni media, e totali per le medie
+    mutable std::vector<uint16_t> m_lunghezze;
+    mutable std::array<uint64_t, CampoRicercabile::NUMERO_TIPI> m_lunghezzeTotali;
+
+    // Contatori per termine riusati tra le ricerche (azzerati solo dove toccati)
+    mutable std::vector<uint16_t> m_contatori;
+};
+
+#endif
@@ -1,11 +1,11 @@
 #include "libro.h"
+#include "rapportomemoria.h"
 #include <QJsonObject>
-#include <QRegularExpression>
 
 Libro::Libro(const QString& titolo, int anno, const QString& descrizione,
              const QString& autore, const QString& editore, int pagine, 
              const QString& isbn, Genere genere)
-    : Media(titolo, anno, descrizione), m_autore(autore), m_editore(editore),
+    : Media(titolo, anno, descrizione, TipoMedia::Libro), m_autore(autore), m_editore(editore),
       m_pagine(pagine), m_isbn(isbn), m_genere(genere)
 {
     if (m_id.isEmpty()) {
@@ -14,7 +14,7 @@ Libro::Libro(const QString& titolo, int anno, const QString& descrizione,
 }
 
 Libro::Libro(const QJsonObject& json)
-    : Media("", 0, "")
+    : Media("", 0, "", TipoMedia::Libro)
 {
     fromJson(json);
 }
@@ -51,32 +51,37 @@ QString Libro::getGenereString() const
 
 void Libro::setAutore(const QString& autore)
 {
+    invalidaTestiVisualizzati();
     m_autore = autore;
 }
 
 void Libro::setEditore(const QString& editore)
 {
+    invalidaTestiVisualizzati();
     m_editore = editore;
 }
 
 void Libro::setPagine(int pagine)
 {
+    invalidaTestiVisualizzati();
     m_pagine = pagine;
 }
 
 void Libro::setIsbn(const QString& isbn)
 {
+    invalidaTestiVisualizzati();
     m_isbn = isbn;
 }
 
 void Libro::setGenere(Genere genere)
 {
+    invalidaTestiVisualizzati();
     m_genere = genere;
 }
 
 std::unique_ptr<Media> Libro::clone() const
 {
-    auto cloned = std::make_unique<Libro>(m_titolo, m_anno, m_descrizione, m_autore, 
+    auto cloned = std::make_unique<Libro>(m_titolo, m_anno, descrizioneDa(leggiCampiFreddi()), m_autore, 
                                          m_editore, m_pagine, m_isbn, m_genere);
     
     // Mantiene l'ID originale per il clone
@@ -92,7 +97,7 @@ QJsonObject Libro::toJson() const
     json["id"] = m_id;
     json["titolo"] = m_titolo;
     json["anno"] = m_anno;
-    json["descrizione"] = m_descrizione;
+    json["descrizione"] = descrizioneDa(leggiCampiFreddi());
     json["autore"] = m_autore;
     json["editore"] = m_editore;
     json["pagine"] = m_pagine;
@@ -103,6 +108,8 @@ QJsonObject Libro::toJson() const
 
 void Libro::fromJson(const QJsonObject& json)
 {
+    scartaCampiFreddi();
+    invalidaTestiVisualizzati();
     m_id = json["id"].toString();
     m_titolo = json["titolo"].toString();
     m_anno = json["anno"].toInt();
@@ -117,9 +124,7 @@ void Libro::fromJson(const QJsonObject& json)
 QString Libro::getDisplayInfo() const
 {
     return QString("Autore: %1\nEditore: %2\nPagine: %3\nGenere: %4\nISBN: %5")
-           .arg(m_autore, m_editore)
-           .arg(m_pagine)
-           .arg(getGenereString(), m_isbn);
+           .arg(m_autore, m_editore, QString::number(m_pagine), getGenereString(), m_isbn);
 }
 
 QString Libro::getTypeDisplayName() const
@@ -141,6 +146,20 @@ bool Libro::matchesCriteria(const QString& criteria, const QString& value) const
     return false;
 }
 
+QStringList Libro::getValoriAttributo(const QString& criteria) const
+{
+    if (criteria == "autore") {
+        return QStringList{m_autore};
+    } else if (criteria == "editore") {
+        return QStringList{m_editore};
+    } else if (criteria == "genere") {
+        return QStringList{getGenereString()};
+    } else if (criteria == "isbn") {
+        return QStringList{m_isbn};
+    }
+    return QStringList();
+}
+
 QString Libro::genereToString(Genere genere)
 {
     switch (genere) {
@@ -185,21 +204,88 @@ bool Libro::validateSpecificFields() const
            (m_isbn.isEmpty() || isValidIsbn(m_isbn));
 }
 
-QString Libro::getSearchableText() const
+QString Libro::getSearchableText(const QJsonObject& freddi) const
 {
     return QString("%1 %2 %3 %4 %5 %6")
-           .arg(m_titolo, m_descrizione, m_autore, m_editore, getGenereString(), m_isbn);
+           .arg(m_titolo, descrizioneDa(freddi), m_autore, m_editore, getGenereString(), m_isbn);
+}
+
+std::vector<CampoRicercabile> Libro::campiRicercabili(const QJsonObject& freddi) const
+{
+    std::vector<CampoRicercabile> campi = Media::campiRicercabili(freddi);
+    campi.push_back({CampoRicercabile::Persone, m_autore});
+    campi.push_back({CampoRicercabile::Altro, m_editore});
+    campi.push_back({CampoRicercabile::Altro, getGenereString()});
+    campi.push_back({CampoRicercabile::Altro, m_isbn});
+    return campi;
+}
+
+void Libro::stimaMemoria(RapportoMemoria& rapporto) const
+{
+    Media::stimaMemoria(rapporto);
+    
+    const QString tipo = getTypeDisplayName();
+    rapporto.aggiungiCampo(tipo, "oggetto", RapportoMemoria::Struttura, RapportoMemoria::byteAllocazione(sizeof(Libro)));
+    rapporto.aggiungiCampo(tipo, "autore", RapportoMemoria::Stringhe, RapportoMemoria::byteStringa(m_autore));
+    rapporto.aggiungiCampo(tipo, "editore", RapportoMemoria::Stringhe, RapportoMemoria::byteStringa(m_editore));
+    rapporto.aggiungiCampo(tipo, "isbn", RapportoMemoria::Stringhe, RapportoMemoria::byteStringa(m_isbn));
 }
 
 bool Libro::isValidIsbn(const QString& isbn) const
 {
     if (isbn.isEmpty()) return true;
     
-    QRegularExpression isbn10("^\\d{9}[\\dX]$");
-    QRegularExpression isbn13("^\\d{13}$");
+    // Solo il formato: la cifra di controllo viene segnalata dal ValidatoreCollezione
+    return !normalizzaIsbn(isbn).isEmpty();
+}
+
+QString Libro::normalizzaIsbn(const QString& isbn)
+{
+    // Scansione diretta al posto di tre espressioni regolari costruite a ogni chiamata
+    QString cifre;
+    cifre.reserve(13);
+    for (const QChar c : isbn) {
+        if (c.isSpace() || c == '-') {
+            continue;
+        }
+        if ((c.unicode() >= '0' && c.unicode() <= '9') || c == 'X') {
+            if (cifre.size() == 13) {
+                return QString();
+            }
+            cifre += c;
+        } else {
+            return QString();
+        }
+    }
     
-    QString cleanIsbn = isbn;
-    cleanIsbn.remove(QRegularExpression("[\\s-]"));
+    // La X (10) è ammessa solo come cifra di controllo di un ISBN-10
+    int x = cifre.indexOf('X');
+    if (cifre.size() == 10 && (x < 0 || x == 9)) {
+        return cifre;
+    }
+    if (cifre.size() == 13 && x < 0) {
+        return cifre;
+    }
+    return QString();
+}
+
+bool Libro::isbnChecksumValido(const QString& isbn)
+{
+    const QString cifre = normalizzaIsbn(isbn);
     
-    return isbn10.match(cleanIsbn).hasMatch() || isbn13.match(cleanIsbn).hasMatch();
+    int somma = 0;
+    if (cifre.size() == 10) {
+        for (int i = 0; i < 10; ++i) {
+            int valore = cifre[i] == 'X' ? 10 : cifre[i].unicode() - '0';
+            somma += (10 - i) * valore;
+        }
+        return somma % 11 == 0;
+    }
+    if (cifre.size() == 13) {
+        for (int i = 0; i < 13; ++i) {
+            somma += (i % 2 == 0 ? 1 : 3) * (cifre[i].unicode() - '0');
+        }
+        return somma % 10 == 0;
+    }
+    return false;
 }
\ No newline at end of file
@@ -49,15 +49,23 @@ public:
     QString getDisplayInfo() const override;
     QString getTypeDisplayName() const override;
     bool matchesCriteria(const QString& criteria, const QString& value) const override;
+    QStringList getValoriAttributo(const QString& criteria) const override;
+    void stimaMemoria(RapportoMemoria& rapporto) const override;
     
     // Utility statiche
     static QString genereToString(Genere genere);
     static Genere stringToGenere(const QString& str);
     static QStringList getAllGeneri();
+    
+    // Cifre di un ISBN-10 o ISBN-13 senza spazi e trattini; vuota se il formato non è valido
+    static QString normalizzaIsbn(const QString& isbn);
+    // Verifica della cifra di controllo (modulo 11 per ISBN-10, modulo 10 per ISBN-13)
+    static bool isbnChecksumValido(const QString& isbn);
 
 protected:
     bool validateSpecificFields() const override;
-    QString getSearchableText() const override;
+    QString getSearchableText(const QJsonObject& freddi) const override;
+    std::vector<CampoRicercabile> campiRicercabili(const QJsonObject& freddi) const override;
 
 private:
     QString m_autore;
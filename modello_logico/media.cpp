@@ -1,14 +1,16 @@
 #include "media.h"
+#include "rapportomemoria.h"
 #include <QUuid>
 #include <QDateTime>
+#include <QDebug>
 
 // Contatori statici per ogni tipo di media
 static int s_libroCounter = 1;
 static int s_filmCounter = 1;
 static int s_articoloCounter = 1;
 
-Media::Media(const QString& titolo, int anno, const QString& descrizione)
-    : m_id(""), m_titolo(titolo), m_anno(anno), m_descrizione(descrizione)
+Media::Media(const QString& titolo, int anno, const QString& descrizione, TipoMedia tipo)
+    : m_id(""), m_titolo(titolo), m_anno(anno), m_descrizione(descrizione), m_tipo(tipo)
 {
     // L'ID verrà impostato dalle classi derivate
 }
@@ -25,7 +27,8 @@ int Media::getAnno() const
 
 QString Media::getDescrizione() const
 {
-    return m_descrizione;
+    caricaCampiFreddi();
+    return m_descrizione.testo();
 }
 
 QString Media::getId() const
@@ -35,16 +38,20 @@ QString Media::getId() const
 
 void Media::setTitolo(const QString& titolo)
 {
+    invalidaTestiVisualizzati();
     m_titolo = titolo;
 }
 
 void Media::setAnno(int anno)
 {
+    invalidaTestiVisualizzati();
     m_anno = anno;
 }
 
 void Media::setDescrizione(const QString& descrizione)
 {
+    invalidaTestiVisualizzati();
+    caricaCampiFreddi();
     m_descrizione = descrizione;
 }
 
@@ -70,11 +77,135 @@ bool Media::matchesFilter(const QString& searchText) const
     }
     
     QString searchLower = searchText.toLower();
-    QString searchableText = getSearchableText().toLower();
+    QString searchableText = getSearchableText(leggiCampiFreddi()).toLower();
     
     return searchableText.contains(searchLower);
 }
 
+std::vector<CampoRicercabile> Media::getCampiRicercabili() const
+{
+    return campiRicercabili(leggiCampiFreddi());
+}
+
+std::vector<CampoRicercabile> Media::campiRicercabili(const QJsonObject& freddi) const
+{
+    return {
+        {CampoRicercabile::Titolo, m_titolo},
+        {CampoRicercabile::Descrizione, descrizioneDa(freddi)}
+    };
+}
+
+const Media::TestiVisualizzati& Media::getTestiVisualizzati() const
+{
+    if (m_testiVisualizzati) {
+        return *m_testiVisualizzati;
+    }
+    
+    // Della descrizione resta solo l'inizio troncato; getDisplayInfo carica ciò che mostra
+    auto testi = std::make_unique<TestiVisualizzati>();
+    testi->titoloBreve = tronca(m_titolo, LUNGHEZZA_TITOLO_BREVE);
+    testi->descrizioneBreve = tronca(descrizioneDa(leggiCampiFreddi()), LUNGHEZZA_DESCRIZIONE_BREVE);
+    testi->info = getDisplayInfo();
+    
+    QStringList righe = testi->info.split('\n');
+    if (righe.size() > RIGHE_INFO_BREVE) {
+        testi->infoBreve = righe.mid(0, RIGHE_INFO_BREVE).join('\n') + "...";
+    } else {
+        testi->infoBreve = testi->info;
+    }
+    testi->infoInLinea = righe.join("; ");
+    
+    m_testiVisualizzati = std::move(testi);
+    return *m_testiVisualizzati;
+}
+
+QString Media::tronca(const QString& testo, int lunghezzaMassima)
+{
+    if (testo.length() <= lunghezzaMassima) {
+        return testo;
+    }
+    return testo.left(lunghezzaMassima - 3) + "...";
+}
+
+void Media::stimaMemoria(RapportoMemoria& rapporto) const
+{
+    // Solo i campi residenti: i campi freddi non ancora letti non vengono caricati
+    const QString tipo = getTypeDisplayName();
+    rapporto.aggiungiMedia(tipo);
+    rapporto.aggiungiCampo(tipo, "id", RapportoMemoria::Stringhe, RapportoMemoria::byteStringa(m_id));
+    rapporto.aggiungiCampo(tipo, "titolo", RapportoMemoria::Stringhe, RapportoMemoria::byteStringa(m_titolo));
+    if (m_descrizione.isCompresso()) {
+        rapporto.aggiungiCampo(tipo, "descrizione (compressa)", RapportoMemoria::Compressi, m_descrizione.byteOccupati());
+    } else {
+        rapporto.aggiungiCampo(tipo, "descrizione", RapportoMemoria::Stringhe, m_descrizione.byteOccupati());
+    }
+    if (m_campiFreddi) {
+        rapporto.aggiungiCampo(tipo, "riferimento campi freddi", RapportoMemoria::Struttura,
+                               RapportoMemoria::byteAllocazione(sizeof(RiferimentoCampiFreddi)));
+    }
+    if (m_testiVisualizzati) {
+        const TestiVisualizzati& testi = *m_testiVisualizzati;
+        rapporto.aggiungiCampo(tipo, "testi visualizzati", RapportoMemoria::Stringhe,
+                               RapportoMemoria::byteAllocazione(sizeof(TestiVisualizzati))
+                               + RapportoMemoria::byteStringa(testi.titoloBreve)
+                               + RapportoMemoria::byteStringa(testi.descrizioneBreve)
+                               + RapportoMemoria::byteStringa(testi.info)
+                               + RapportoMemoria::byteStringa(testi.infoBreve)
+                               + RapportoMemoria::byteStringa(testi.infoInLinea));
+    }
+}
+
+void Media::setCampiFreddi(std::shared_ptr<const SorgenteCampiFreddi> sorgente, qint64 inizio, qint64 lunghezza)
+{
+    if (!sorgente) {
+        m_campiFreddi.reset();
+        return;
+    }
+    m_campiFreddi.reset(new RiferimentoCampiFreddi{std::move(sorgente), inizio, lunghezza});
+}
+
+void Media::caricaCampiFreddi() const
+{
+    if (!m_campiFreddi) {
+        return;
+    }
+    
+    // Il riferimento si stacca prima di applicare i campi, così applicaCampiFreddi non rientra qui
+    QJsonObject json = leggiCampiFreddi();
+    m_campiFreddi.reset();
+    if (json.isEmpty()) {
+        return;
+    }
+    
+    // I media non sono mai creati const: il caricamento completa il loro stato logico
+    const_cast<Media*>(this)->applicaCampiFreddi(json);
+}
+
+QJsonObject Media::leggiCampiFreddi() const
+{
+    if (!m_campiFreddi) {
+        return QJsonObject();
+    }
+    
+    QJsonObject json = m_campiFreddi->sorgente->leggi(m_campiFreddi->inizio, m_campiFreddi->lunghezza);
+    if (json["id"].toString() != m_id) {
+        qWarning() << "Campi non più disponibili per" << m_id << "- il file è stato modificato";
+        return QJsonObject();
+    }
+    return json;
+}
+
+QString Media::descrizioneDa(const QJsonObject& freddi) const
+{
+    return freddi.isEmpty() ? m_descrizione.testo() : freddi["descrizione"].toString();
+}
+
+void Media::applicaCampiFreddi(const QJsonObject& json)
+{
+    invalidaTestiVisualizzati();
+    m_descrizione = json["descrizione"].toString();
+}
+
 QString Media::generateSimpleId(const QString& type)
 {
     if (type.toLower() == "libro") {
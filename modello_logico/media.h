@@ -2,11 +2,54 @@
 #define MEDIA_H
 
 #include <QString>
+#include <QStringList>
 #include <QJsonObject>
 #include <QDate>
+#include "testocompresso.h"
 #include <memory>
 #include <vector>
 
+class RapportoMemoria;
+
+/**
+ * @brief Campo testuale esposto agli indici di ricerca
+ *
+ * Il tipo raggruppa i campi omogenei dei diversi media, così gli indici
+ * possono pesarli senza conoscere le classi concrete.
+ */
+struct CampoRicercabile
+{
+    enum Tipo {
+        Titolo,
+        Persone,
+        Descrizione,
+        Altro
+    };
+    
+    static const int NUMERO_TIPI = 4;
+    
+    Tipo tipo;
+    QString testo;
+};
+
+/**
+ * @brief Sorgente dei campi caricati su richiesta
+ *
+ * Nel caricamento pigro i media nascono con i soli campi "caldi"; i campi
+ * "freddi" (la descrizione) restano nel file e vengono letti
+ * dall'intervallo di byte registrato per ciascun media. Solo modifica e
+ * visualizzazione li conservano; indici, filtri e scansioni li rileggono
+ * senza trattenerli.
+ */
+class SorgenteCampiFreddi
+{
+public:
+    virtual ~SorgenteCampiFreddi() = default;
+    
+    // Oggetto JSON completo del media salvato nell'intervallo indicato
+    virtual QJsonObject leggi(qint64 inizio, qint64 lunghezza) const = 0;
+};
+
 /**
  * @brief Classe base astratta per tutti i tipi di media
  * 
@@ -16,7 +59,31 @@
 class Media
 {
 public:
-    Media(const QString& titolo, int anno, const QString& descrizione);
+    // Tipo concreto, leggibile senza dispatch virtuale (es. dai filtri compilati)
+    enum class TipoMedia {
+        Libro,
+        Film,
+        Articolo
+    };
+    
+    /**
+     * @brief Stringhe mostrate dalle card e dalle esportazioni
+     *
+     * Calcolate al primo accesso e conservate fino alla prossima modifica del media.
+     */
+    struct TestiVisualizzati {
+        QString titoloBreve;
+        QString descrizioneBreve;
+        QString info;              // getDisplayInfo(), una voce per riga
+        QString infoBreve;         // prime RIGHE_INFO_BREVE righe di info
+        QString infoInLinea;       // info su una riga, voci separate da "; "
+    };
+    
+    static const int LUNGHEZZA_TITOLO_BREVE = 25;
+    static const int LUNGHEZZA_DESCRIZIONE_BREVE = 80;
+    static const int RIGHE_INFO_BREVE = 2;
+    
+    Media(const QString& titolo, int anno, const QString& descrizione, TipoMedia tipo);
     virtual ~Media() = default;
     
     Media(const Media&) = delete;
@@ -27,6 +94,7 @@ public:
     int getAnno() const;
     QString getDescrizione() const;
     QString getId() const;
+    TipoMedia getTipoMedia() const { return m_tipo; }
     
     void setTitolo(const QString& titolo);
     void setAnno(int anno);
@@ -41,12 +109,28 @@ public:
     virtual QString getTypeDisplayName() const = 0;
     virtual bool matchesCriteria(const QString& criteria, const QString& value) const = 0;
     
+    const TestiVisualizzati& getTestiVisualizzati() const;
+    
+    // Tronca il testo a lunghezzaMassima caratteri, puntini compresi
+    static QString tronca(const QString& testo, int lunghezzaMassima);
+    
+    // Valori grezzi di un attributo filtrabile (più valori per i campi multipli)
+    virtual QStringList getValoriAttributo(const QString& criteria) const = 0;
+    
     // Template Method per la validazione
     bool isValid() const;
     bool isCompleteAndValid() const;
     
     // Metodi per la ricerca e filtri
     bool matchesFilter(const QString& searchText) const;
+    std::vector<CampoRicercabile> getCampiRicercabili() const;
+    
+    // Aggiunge al rapporto i byte occupati da questo media, campo per campo
+    virtual void stimaMemoria(RapportoMemoria& rapporto) const;
+    
+    // Caricamento pigro: i campi freddi vengono letti dalla sorgente al primo accesso
+    void setCampiFreddi(std::shared_ptr<const SorgenteCampiFreddi> sorgente, qint64 inizio, qint64 lunghezza);
+    bool haCampiFreddiDaCaricare() const { return m_campiFreddi != nullptr; }
     
     // Gestione ID semplici con contatori
     static QString generateSimpleId(const QString& type);
@@ -56,13 +140,41 @@ public:
 protected:
     // Template method steps
     virtual bool validateSpecificFields() const = 0;
-    virtual QString getSearchableText() const = 0;
+    
+    // freddi è il risultato di leggiCampiFreddi: vuoto se i campi sono già in memoria
+    virtual QString getSearchableText(const QJsonObject& freddi) const = 0;
+    virtual std::vector<CampoRicercabile> campiRicercabili(const QJsonObject& freddi) const;
+    
+    // Da chiamare prima di un uso dei campi freddi che deve conservarli (modifica, visualizzazione);
+    // le sottoclassi estendono applicaCampiFreddi
+    void caricaCampiFreddi() const;
+    void scartaCampiFreddi() { m_campiFreddi.reset(); }
+    virtual void applicaCampiFreddi(const QJsonObject& json);
+    
+    // Lettura senza conservarli, per chi scorre tutta la collezione: oggetto vuoto se
+    // i campi sono già in memoria, e allora valgono gli attributi
+    QJsonObject leggiCampiFreddi() const;
+    QString descrizioneDa(const QJsonObject& freddi) const;
+    
+    // Da chiamare in ogni metodo che modifica un campo mostrato
+    void invalidaTestiVisualizzati() { m_testiVisualizzati.reset(); }
     
     // Attributi comuni protetti
     QString m_id;
     QString m_titolo;
     int m_anno;
-    QString m_descrizione;
+    TestoCompresso m_descrizione;   // compressa oltre la soglia di TestoCompresso
+
+private:
+    struct RiferimentoCampiFreddi {
+        std::shared_ptr<const SorgenteCampiFreddi> sorgente;
+        qint64 inizio;
+        qint64 lunghezza;
+    };
+    
+    TipoMedia m_tipo;
+    mutable std::unique_ptr<RiferimentoCampiFreddi> m_campiFreddi;
+    mutable std::unique_ptr<TestiVisualizzati> m_testiVisualizzati;
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,193 @@
+#include "ordinamentomedia.h"
+#include "media.h"
+#include "libro.h"
+#include "film.h"
+#include "articolo.h"
+#include "rapportomemoria.h"
+#include <QLocale>
+#include <QStringList>
+#include <algorithm>
+#include <limits>
+
+namespace {
+
+const uint32_t NON_IN_COLLEZIONE = std::numeric_limits<uint32_t>::max();
+
+// Dati privati di una QCollatorSortKey: contatore e chiave binaria di un campo breve
+const qint64 BYTE_STIMATI_CHIAVE = 64;
+
+struct Elemento {
+    Media* media;
+    uint32_t posizione;
+};
+
+} // namespace
+
+OrdinamentoMedia::OrdinamentoMedia(const std::vector<std::unique_ptr<Media>>& media)
+    : m_media(media), m_collatore(QLocale(QLocale::Italian, QLocale::Italy)), m_posizioniValide(false)
+{
+    // Maiuscole ignorate e numeri per valore: "Vol. 2" precede "Vol. 10"
+    m_collatore.setCaseSensitivity(Qt::CaseInsensitive);
+    m_collatore.setNumericMode(true);
+
+    // I tipi sono tre: basta il rango del nome visualizzato, calcolato una volta
+    const QStringList nomi = {"Libro", "Film", "Articolo"};
+    QStringList ordinati = nomi;
+    std::sort(ordinati.begin(), ordinati.end(), [this](const QString& a, const QString& b) {
+        return m_collatore.compare(a, b) < 0;
+    });
+    for (int i = 0; i < nomi.size(); ++i) {
+        m_rangoTipo[i] = static_cast<int>(ordinati.indexOf(nomi[i]));
+    }
+}
+
+void OrdinamentoMedia::mediaAggiunto(size_t posizione)
+{
+    if (posizione >= m_media.size() || !m_media[posizione]) {
+        return;
+    }
+
+    const Media& media = *m_media[posizione];
+    for (auto campo : {CriterioOrdinamento::Titolo, CriterioOrdinamento::Persona}) {
+        ChiaviCampo& campoChiavi = chiaviCampo(campo);
+        if (campoChiavi.valido) {
+            campoChiavi.chiavi.push_back(m_collatore.sortKey(testoCampo(media, campo)));
+        }
+    }
+    if (m_posizioniValide) {
+        m_posizioni.insert(&media, static_cast<uint32_t>(posizione));
+    }
+}
+
+void OrdinamentoMedia::invalida()
+{
+    m_titoli = ChiaviCampo();
+    m_persone = ChiaviCampo();
+    m_posizioniValide = false;
+    m_posizioni.clear();
+}
+
+void OrdinamentoMedia::ordina(std::vector<Media*>& media, const std::vector<CriterioOrdinamento>& criteri) const
+{
+    if (criteri.empty() || media.size() < 2) {
+        return;
+    }
+
+    assicuraPosizioni();
+    for (const CriterioOrdinamento& criterio : criteri) {
+        assicuraChiavi(criterio.campo);
+    }
+
+    std::vector<Elemento> elementi;
+    elementi.reserve(media.size());
+    for (Media* elemento : media) {
+        elementi.push_back({elemento, m_posizioni.value(elemento, NON_IN_COLLEZIONE)});
+    }
+
+    std::stable_sort(elementi.begin(), elementi.end(), [&](const Elemento& a, const Elemento& b) {
+        // Media estranei alla collezione (senza chiavi) in fondo
+        if (a.posizione == NON_IN_COLLEZIONE || b.posizione == NON_IN_COLLEZIONE) {
+            return a.posizione != NON_IN_COLLEZIONE && b.posizione == NON_IN_COLLEZIONE;
+        }
+        for (const CriterioOrdinamento& criterio : criteri) {
+            int confronto = confronta(a.posizione, b.posizione, criterio.campo);
+            if (confronto != 0) {
+                return criterio.crescente ? confronto < 0 : confronto > 0;
+            }
+        }
+        return false;
+    });
+
+    for (size_t i = 0; i < elementi.size(); ++i) {
+        media[i] = elementi[i].media;
+    }
+}
+
+QString OrdinamentoMedia::personaPrincipale(const Media& media)
+{
+    switch (media.getTipoMedia()) {
+        case Media::TipoMedia::Libro:
+            return static_cast<const Libro&>(media).getAutore();
+        case Media::TipoMedia::Film:
+            return static_cast<const Film&>(media).getRegista();
+        case Media::TipoMedia::Articolo: {
+            QStringList autori = static_cast<const Articolo&>(media).getAutori();
+            return autori.isEmpty() ? QString() : autori.first();
+        }
+    }
+    return QString();
+}
+
+qint64 OrdinamentoMedia::byteOccupati() const
+{
+    qint64 byte = 0;
+    for (const ChiaviCampo* campo : {&m_titoli, &m_persone}) {
+        byte += RapportoMemoria::byteAllocazione(campo->chiavi.capacity() * sizeof(QCollatorSortKey));
+        byte += static_cast<qint64>(campo->chiavi.size()) * RapportoMemoria::byteAllocazione(BYTE_STIMATI_CHIAVE);
+    }
+    byte += RapportoMemoria::byteHash(m_posizioni.size(), sizeof(const Media*) + sizeof(uint32_t));
+    return byte;
+}
+
+// Private methods
+QString OrdinamentoMedia::testoCampo(const Media& media, CriterioOrdinamento::Campo campo)
+{
+    return campo == CriterioOrdinamento::Titolo ? media.getTitolo() : personaPrincipale(media);
+}
+
+OrdinamentoMedia::ChiaviCampo& OrdinamentoMedia::chiaviCampo(CriterioOrdinamento::Campo campo) const
+{
+    return campo == CriterioOrdinamento::Titolo ? m_titoli : m_persone;
+}
+
+void OrdinamentoMedia::assicuraChiavi(CriterioOrdinamento::Campo campo) const
+{
+    if (campo != CriterioOrdinamento::Titolo && campo != CriterioOrdinamento::Persona) {
+        return;
+    }
+
+    ChiaviCampo& campoChiavi = chiaviCampo(campo);
+    if (campoChiavi.valido) {
+        return;
+    }
+
+    campoChiavi.chiavi.clear();
+    campoChiavi.chiavi.reserve(m_media.size());
+    for (const auto& media : m_media) {
+        campoChiavi.chiavi.push_back(m_collatore.sortKey(media ? testoCampo(*media, campo) : QString()));
+    }
+    campoChiavi.valido = true;
+}
+
+void OrdinamentoMedia::assicuraPosizioni() const
+{
+    if (m_posizioniValide) {
+        return;
+    }
+
+    m_posizioni.clear();
+    m_posizioni.reserve(static_cast<qsizetype>(m_media.size()));
+    for (size_t i = 0; i < m_media.size(); ++i) {
+        m_posizioni.insert(m_media[i].get(), static_cast<uint32_t>(i));
+    }
+    m_posizioniValide = true;
+}
+
+int OrdinamentoMedia::confronta(uint32_t a, uint32_t b, CriterioOrdinamento::Campo campo) const
+{
+    switch (campo) {
+        case CriterioOrdinamento::Titolo:
+            return m_titoli.chiavi[a].compare(m_titoli.chiavi[b]);
+        case CriterioOrdinamento::Persona:
+            return m_persone.chiavi[a].compare(m_persone.chiavi[b]);
+        case CriterioOrdinamento::Anno: {
+            int annoA = m_media[a]->getAnno();
+            int annoB = m_media[b]->getAnno();
+            return annoA < annoB ? -1 : (annoA > annoB ? 1 : 0);
+        }
+        case CriterioOrdinamento::Tipo:
+            return m_rangoTipo[static_cast<int>(m_media[a]->getTipoMedia())]
+                 - m_rangoTipo[static_cast<int>(m_media[b]->getTipoMedia())];
+    }
+    return 0;
+}
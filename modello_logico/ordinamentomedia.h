@@ -0,0 +1,78 @@
+#ifndef ORDINAMENTOMEDIA_H
+#define ORDINAMENTOMEDIA_H
+
+#include <QCollator>
+#include <QCollatorSortKey>
+#include <QHash>
+#include <QString>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+class Media;
+
+/**
+ * @brief Un livello di un ordinamento multi-chiave
+ */
+struct CriterioOrdinamento
+{
+    enum Campo {
+        Titolo,
+        Anno,
+        Persona,    // autore del libro, regista del film, primo autore dell'articolo
+        Tipo
+    };
+
+    Campo campo;
+    bool crescente;
+};
+
+/**
+ * @brief Ordinamento stabile dei media con collazione italiana
+ *
+ * Le chiavi di collazione (QCollator::sortKey) sono calcolate una volta per
+ * media e per campo, al primo ordinamento che le richiede, e riusate finché la
+ * collezione non cambia: riordinare confronta solo chiavi binarie compatte,
+ * senza ripetere il confronto dipendente dalla lingua per ogni coppia.
+ * Come gli altri indici segue le posizioni dei media nella collezione: le
+ * aggiunte in coda si accodano, le altre modifiche invalidano tutto.
+ */
+class OrdinamentoMedia
+{
+public:
+    explicit OrdinamentoMedia(const std::vector<std::unique_ptr<Media>>& media);
+
+    void mediaAggiunto(size_t posizione);
+    void invalida();
+
+    // A parità su tutti i criteri resta l'ordine di ingresso
+    void ordina(std::vector<Media*>& media, const std::vector<CriterioOrdinamento>& criteri) const;
+
+    static QString personaPrincipale(const Media& media);
+
+    // Stima della memoria di chiavi e posizioni (vedi RapportoMemoria)
+    qint64 byteOccupati() const;
+
+private:
+    struct ChiaviCampo {
+        bool valido = false;
+        std::vector<QCollatorSortKey> chiavi;
+    };
+
+    static QString testoCampo(const Media& media, CriterioOrdinamento::Campo campo);
+    ChiaviCampo& chiaviCampo(CriterioOrdinamento::Campo campo) const;
+    void assicuraChiavi(CriterioOrdinamento::Campo campo) const;
+    void assicuraPosizioni() const;
+    int confronta(uint32_t a, uint32_t b, CriterioOrdinamento::Campo campo) const;
+
+    const std::vector<std::unique_ptr<Media>>& m_media;
+    QCollator m_collatore;
+    int m_rangoTipo[3];
+
+    mutable ChiaviCampo m_titoli;
+    mutable ChiaviCampo m_persone;
+    mutable bool m_posizioniValide;
+    mutable QHash<const Media*, uint32_t> m_posizioni;
+};
+
+#endif
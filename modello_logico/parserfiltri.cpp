@@ -0,0 +1,430 @@
+#include "parserfiltri.h"
+#include "rapportomemoria.h"
+#include <QtGlobal>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+
+struct Token {
+    enum Tipo {
+        Parola,
+        Frase,
+        ApertaParentesi,
+        ChiusaParentesi,
+        Meno,
+        Or,
+        And,
+        Not
+    };
+
+    Tipo tipo;
+    QString testo;
+    bool quotato = false;
+};
+
+// Gli errori di sintassi risalgono come eccezioni fino a ParserFiltri::analizza
+class ErroreSintassi : public std::runtime_error
+{
+public:
+    explicit ErroreSintassi(const QString& messaggio)
+        : std::runtime_error(messaggio.toStdString()), m_messaggio(messaggio) {}
+    QString messaggio() const { return m_messaggio; }
+
+private:
+    QString m_messaggio;
+};
+
+QString leggiVirgolette(const QString& query, qsizetype& pos)
+{
+    // pos punta alle virgolette di apertura
+    qsizetype fine = query.indexOf('"', pos + 1);
+    if (fine < 0) {
+        throw ErroreSintassi("virgolette non chiuse");
+    }
+    QString contenuto = query.mid(pos + 1, fine - pos - 1);
+    pos = fine + 1;
+    return contenuto;
+}
+
+std::vector<Token> analisiLessicale(const QString& query)
+{
+    std::vector<Token> token;
+    const qsizetype n = query.size();
+    qsizetype pos = 0;
+
+    while (pos < n) {
+        QChar c = query.at(pos);
+        if (c.isSpace()) {
+            ++pos;
+        } else if (c == '(') {
+            token.push_back({Token::ApertaParentesi, "("});
+            ++pos;
+        } else if (c == ')') {
+            token.push_back({Token::ChiusaParentesi, ")"});
+            ++pos;
+        } else if (c == '-' && pos + 1 < n && !query.at(pos + 1).isSpace()) {
+            token.push_back({Token::Meno, "-"});
+            ++pos;
+        } else if (c == '"') {
+            token.push_back({Token::Frase, leggiVirgolette(query, pos)});
+        } else {
+            qsizetype inizio = pos;
+            while (pos < n && !query.at(pos).isSpace() && query.at(pos) != '(' && query.at(pos) != ')') {
+                if (query.at(pos) == ':') {
+                    // campo:"valore" oppure campo:="valore"
+                    qsizetype valore = pos + 1;
+                    if (valore < n && query.at(valore) == '=') ++valore;
+                    if (valore < n && query.at(valore) == '"') {
+                        QString prefisso = query.mid(inizio, valore - inizio);
+                        pos = valore;
+                        Token parola{Token::Parola, prefisso + leggiVirgolette(query, pos)};
+                        parola.quotato = true;
+                        token.push_back(parola);
+                        inizio = -1;
+                        break;
+                    }
+                }
+                ++pos;
+            }
+            if (inizio < 0) {
+                continue;
+            }
+
+            QString parola = query.mid(inizio, pos - inizio);
+            if (parola == "OR" || parola == "|") {
+                token.push_back({Token::Or, parola});
+            } else if (parola == "AND" || parola == "&") {
+                token.push_back({Token::And, parola});
+            } else if (parola == "NOT") {
+                token.push_back({Token::Not, parola});
+            } else {
+                token.push_back({Token::Parola, parola});
+            }
+        }
+    }
+    return token;
+}
+
+// Parser a discesa ricorsiva:
+//   or      := and ("OR" and)*
+//   and     := unario (["AND"] unario)*
+//   unario  := ("-" | "NOT") unario | primario
+//   primario:= "(" or ")" | parola | frase
+class Analizzatore
+{
+public:
+    explicit Analizzatore(std::vector<Token> token) : m_token(std::move(token)), m_pos(0) {}
+
+    std::unique_ptr<FiltroStrategy> analizza()
+    {
+        if (m_token.empty()) {
+            throw ErroreSintassi("query vuota");
+        }
+        auto risultato = disgiunzione();
+        if (m_pos < m_token.size()) {
+            throw ErroreSintassi(QString("simbolo inatteso '%1'").arg(m_token[m_pos].testo));
+        }
+        return risultato;
+    }
+
+private:
+    bool finito() const { return m_pos >= m_token.size(); }
+    const Token& corrente() const { return m_token[m_pos]; }
+
+    std::unique_ptr<FiltroStrategy> disgiunzione()
+    {
+        auto composto = std::make_unique<FiltroComposto>(FiltroComposto::Or);
+        composto->addFiltro(congiunzione());
+        while (!finito() && corrente().tipo == Token::Or) {
+            ++m_pos;
+            composto->addFiltro(congiunzione());
+        }
+        return composto;
+    }
+
+    std::unique_ptr<FiltroStrategy> congiunzione()
+    {
+        auto composto = std::make_unique<FiltroComposto>(FiltroComposto::And);
+        composto->addFiltro(unario());
+        while (!finito() && corrente().tipo != Token::Or && corrente().tipo != Token::ChiusaParentesi) {
+            if (corrente().tipo == Token::And) {
+                ++m_pos;
+            }
+            composto->addFiltro(unario());
+        }
+        return composto;
+    }
+
+    std::unique_ptr<FiltroStrategy> unario()
+    {
+        if (finito()) {
+            throw ErroreSintassi("espressione incompleta");
+        }
+        if (corrente().tipo == Token::Meno || corrente().tipo == Token::Not) {
+            ++m_pos;
+            return std::make_unique<FiltroNegato>(unario());
+        }
+        return primario();
+    }
+
+    std::unique_ptr<FiltroStrategy> primario()
+    {
+        const Token token = corrente();
+        ++m_pos;
+
+        switch (token.tipo) {
+            case Token::ApertaParentesi: {
+                auto interno = disgiunzione();
+                if (finito() || corrente().tipo != Token::ChiusaParentesi) {
+                    throw ErroreSintassi("parentesi non chiusa");
+                }
+                ++m_pos;
+                return interno;
+            }
+            case Token::Frase:
+                return std::make_unique<FiltroTesto>(token.testo);
+            case Token::Parola:
+                return termine(token);
+            default:
+                throw ErroreSintassi(QString("simbolo inatteso '%1'").arg(token.testo));
+        }
+    }
+
+    std::unique_ptr<FiltroStrategy> termine(const Token& token)
+    {
+        qsizetype dueP = token.testo.indexOf(':');
+        if (dueP <= 0) {
+            return std::make_unique<FiltroTesto>(token.testo);
+        }
+
+        QString campo = token.testo.left(dueP).toLower();
+        QString valore = token.testo.mid(dueP + 1);
+        if (valore.isEmpty()) {
+            throw ErroreSintassi(QString("valore mancante per '%1'").arg(campo));
+        }
+
+        if (campo == "tipo") {
+            return filtroTipo(valore);
+        }
+        if (campo == "anno") {
+            return filtroAnno(valore);
+        }
+        if (!ParserFiltri::getCampiCriterio().contains(campo)) {
+            throw ErroreSintassi(QString("campo sconosciuto '%1'").arg(campo));
+        }
+
+        FiltroCriterio::Modalita modalita = FiltroCriterio::Contiene;
+        if (valore.startsWith('=')) {
+            valore = valore.mid(1);
+            modalita = FiltroCriterio::Esatto;
+        } else if (!token.quotato && valore.length() > 1 && valore.endsWith('*')) {
+            valore.chop(1);
+            modalita = FiltroCriterio::Prefisso;
+        }
+        return std::make_unique<FiltroCriterio>(campo, valore, modalita);
+    }
+
+    static std::unique_ptr<FiltroStrategy> filtroTipo(const QString& valore)
+    {
+        static const QStringList tipi = {"libro", "film", "articolo"};
+        QString tipo = valore.toLower();
+        if (!tipi.contains(tipo)) {
+            throw ErroreSintassi(QString("tipo sconosciuto '%1'").arg(valore));
+        }
+        return std::make_unique<FiltroTipo>(tipo);
+    }
+
+    static std::unique_ptr<FiltroStrategy> filtroAnno(const QString& valore)
+    {
+        int annoMin = 0;
+        int annoMax = 9999;
+        qsizetype separatore = valore.indexOf("..");
+
+        bool ok = true;
+        if (separatore < 0) {
+            annoMin = annoMax = valore.toInt(&ok);
+        } else {
+            QString sinistra = valore.left(separatore);
+            QString destra = valore.mid(separatore + 2);
+            if (sinistra.isEmpty() && destra.isEmpty()) ok = false;
+            if (ok && !sinistra.isEmpty()) annoMin = sinistra.toInt(&ok);
+            if (ok && !destra.isEmpty()) annoMax = destra.toInt(&ok);
+        }
+
+        if (!ok || annoMin > annoMax) {
+            throw ErroreSintassi(QString("intervallo di anni non valido '%1'").arg(valore));
+        }
+        return std::make_unique<FiltroAnno>(annoMin, annoMax);
+    }
+
+    std::vector<Token> m_token;
+    size_t m_pos;
+};
+
+// Nodi di un albero di filtri, per la stima della memoria della cache
+qint64 contaNodi(const FiltroStrategy& filtro)
+{
+    qint64 nodi = 1;
+    if (auto composto = dynamic_cast<const FiltroComposto*>(&filtro)) {
+        for (const auto& figlio : composto->getFiltri()) {
+            nodi += contaNodi(*figlio);
+        }
+    } else if (auto negato = dynamic_cast<const FiltroNegato*>(&filtro)) {
+        nodi += contaNodi(*negato->getFiltro());
+    }
+    return nodi;
+}
+
+// Un nodo foglia tipico: vtable, criterio e valore con le loro stringhe brevi
+const qint64 BYTE_STIMATI_NODO = 96;
+
+} // namespace
+
+ParserFiltri::ParserFiltri(int capacitaCache)
+    : m_capacita(qMax(1, capacitaCache)), m_orologio(0)
+{
+}
+
+const QStringList& ParserFiltri::getCampiCriterio()
+{
+    static const QStringList campi = {
+        "autore", "editore", "genere", "isbn",
+        "regista", "attore", "casa_produzione",
+        "rivista", "categoria", "doi"
+    };
+    return campi;
+}
+
+bool ParserFiltri::isQuery(const QString& testo)
+{
+    QString pulito = testo.trimmed();
+    if (pulito.contains('"') || pulito.contains('(')
+        || pulito.contains(" OR ") || pulito.startsWith("NOT ")) {
+        return true;
+    }
+
+    for (const QString& parola : pulito.split(' ', Qt::SkipEmptyParts)) {
+        // Negazione solo se il meno è attaccato a un termine ("-horror"): un trattino
+        // isolato come in "2001 - Odissea nello spazio" resta una ricerca semplice
+        if (parola.size() > 1 && parola.at(0) == '-' && parola.at(1).isLetterOrNumber()) {
+            return true;
+        }
+
+        // I due punti contano solo dopo un campo noto: "Star Wars: Episodio IV" resta una ricerca
+        qsizetype dueP = parola.indexOf(':');
+        if (dueP > 0) {
+            QString campo = parola.left(dueP).toLower();
+            if (campo == "tipo" || campo == "anno" || getCampiCriterio().contains(campo)) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+std::unique_ptr<FiltroStrategy> ParserFiltri::compila(const QString& query, QString* errore)
+{
+    QString chiave = query.trimmed();
+    ++m_orologio;
+
+    auto it = m_cache.find(chiave);
+    if (it == m_cache.end()) {
+        if (m_cache.size() >= m_capacita) {
+            // Eliminazione della voce usata meno di recente (cache piccola: scansione lineare)
+            auto vecchia = m_cache.begin();
+            for (auto voce = m_cache.begin(); voce != m_cache.end(); ++voce) {
+                if (voce->ultimoUso < vecchia->ultimoUso) {
+                    vecchia = voce;
+                }
+            }
+            m_cache.erase(vecchia);
+        }
+
+        VoceCache voce;
+        voce.filtro = std::shared_ptr<const FiltroStrategy>(analizza(chiave, voce.errore));
+        it = m_cache.insert(chiave, voce);
+    }
+
+    it->ultimoUso = m_orologio;
+    if (errore) {
+        *errore = it->errore;
+    }
+    return it->filtro ? it->filtro->clone() : nullptr;
+}
+
+void ParserFiltri::svuotaCache()
+{
+    m_cache.clear();
+}
+
+qint64 ParserFiltri::byteOccupati() const
+{
+    qint64 byte = RapportoMemoria::byteHash(m_cache.size(), sizeof(QString) + sizeof(VoceCache));
+    for (auto it = m_cache.cbegin(); it != m_cache.cend(); ++it) {
+        byte += RapportoMemoria::byteStringa(it.key()) + RapportoMemoria::byteStringa(it->errore);
+        if (it->filtro) {
+            // Blocco di controllo dello shared_ptr più i nodi dell'albero
+            byte += RapportoMemoria::byteAllocazione(2 * sizeof(long))
+                    + contaNodi(*it->filtro) * RapportoMemoria::byteAllocazione(BYTE_STIMATI_NODO);
+        }
+    }
+    return byte;
+}
+
+std::unique_ptr<FiltroStrategy> ParserFiltri::analizza(const QString& query, QString& errore)
+{
+    try {
+        Analizzatore analizzatore(analisiLessicale(query));
+        auto albero = analizzatore.analizza();
+        errore.clear();
+        return semplifica(*albero);
+    } catch (const ErroreSintassi& e) {
+        errore = e.messaggio();
+        return nullptr;
+    }
+}
+
+std::unique_ptr<FiltroStrategy> ParserFiltri::semplifica(const FiltroStrategy& filtro)
+{
+    if (auto composto = dynamic_cast<const FiltroComposto*>(&filtro)) {
+        auto risultato = std::make_unique<FiltroComposto>(composto->getOperatore());
+        std::vector<std::unique_ptr<FiltroStrategy>> figli;
+        for (const auto& figlio : composto->getFiltri()) {
+            auto semplice = semplifica(*figlio);
+            // (a AND (b AND c)) diventa (a AND b AND c)
+            auto interno = dynamic_cast<const FiltroComposto*>(semplice.get());
+            if (interno && interno->getOperatore() == composto->getOperatore() && !interno->isEmpty()) {
+                for (const auto& nipote : interno->getFiltri()) {
+                    figli.push_back(nipote->clone());
+                }
+            } else {
+                figli.push_back(std::move(semplice));
+            }
+        }
+
+        if (figli.size() == 1) {
+            return std::move(figli.front());
+        }
+        for (auto& figlio : figli) {
+            risultato->addFiltro(std::move(figlio));
+        }
+        return risultato;
+    }
+
+    if (auto negato = dynamic_cast<const FiltroNegato*>(&filtro)) {
+        if (!negato->getFiltro()) {
+            return filtro.clone();
+        }
+        auto interno = semplifica(*negato->getFiltro());
+        // NOT NOT a diventa a
+        if (auto doppio = dynamic_cast<const FiltroNegato*>(interno.get())) {
+            if (doppio->getFiltro()) {
+                return doppio->getFiltro()->clone();
+            }
+        }
+        return std::make_unique<FiltroNegato>(std::move(interno));
+    }
+
+    return filtro.clone();
+}
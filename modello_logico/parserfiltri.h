@@ -0,0 +1,63 @@
+#ifndef PARSERFILTRI_H
+#define PARSERFILTRI_H
+
+#include "filtrostrategy.h"
+#include <QHash>
+#include <QString>
+#include <QStringList>
+#include <memory>
+
+/**
+ * @brief Compilatore del linguaggio di interrogazione testuale
+ *
+ * Traduce query come
+ *     tipo:film anno:1990..2000 regista:nolan -genere:horror "parola esatta"
+ * in un albero di FiltroStrategy. Sintassi:
+ *  - campo:valore (sottostringa), campo:=valore (esatto), campo:valore* (prefisso)
+ *  - tipo:libro|film|articolo, anno:N, anno:N..M, anno:N.., anno:..M
+ *  - parole e "frasi tra virgolette" cercano nel testo libero
+ *  - i termini affiancati sono in AND; OR, NOT / '-' e parentesi per il resto
+ *
+ * L'albero viene semplificato (composti annidati appiattiti, doppie negazioni
+ * rimosse) e memorizzato in una cache LRU indicizzata dal testo della query:
+ * le query ripetute costano solo una clone().
+ */
+class ParserFiltri
+{
+public:
+    explicit ParserFiltri(int capacitaCache = CAPACITA_CACHE_DEFAULT);
+
+    // nullptr se la query non è valida; il motivo viene scritto in errore
+    std::unique_ptr<FiltroStrategy> compila(const QString& query, QString* errore = nullptr);
+
+    void svuotaCache();
+    int dimensioneCache() const { return m_cache.size(); }
+
+    // Stima della memoria della cache, alberi dei filtri compresi (vedi RapportoMemoria)
+    qint64 byteOccupati() const;
+
+    // Vero se il testo usa la sintassi della query e non è una semplice ricerca
+    static bool isQuery(const QString& testo);
+
+    // Compilazione senza cache
+    static std::unique_ptr<FiltroStrategy> analizza(const QString& query, QString& errore);
+
+    static const QStringList& getCampiCriterio();
+
+    static const int CAPACITA_CACHE_DEFAULT = 64;
+
+private:
+    struct VoceCache {
+        std::shared_ptr<const FiltroStrategy> filtro;
+        QString errore;
+        quint64 ultimoUso;
+    };
+
+    static std::unique_ptr<FiltroStrategy> semplifica(const FiltroStrategy& filtro);
+
+    int m_capacita;
+    quint64 m_orologio;
+    QHash<QString, VoceCache> m_cache;
+};
+
+#endif
@@ -0,0 +1,329 @@
+#include "pianificatorefiltri.h"
+#include "statistichecollezione.h"
+#include <algorithm>
+#include <iterator>
+#include <limits>
+
+namespace {
+
+using Congiunzione = std::vector<std::unique_ptr<FiltroStrategy>>;
+using FormaDisgiuntiva = std::vector<Congiunzione>;
+
+Congiunzione clonaCongiunzione(const Congiunzione& congiunzione)
+{
+    Congiunzione copia;
+    copia.reserve(congiunzione.size());
+    for (const auto& letterale : congiunzione) {
+        copia.push_back(letterale->clone());
+    }
+    return copia;
+}
+
+// Espande il filtro (eventualmente negato) in OR di AND di letterali.
+// Le negazioni vengono spinte verso le foglie con le leggi di De Morgan.
+bool espandiDNF(const FiltroStrategy& filtro, bool negato, FormaDisgiuntiva& risultato, size_t limite)
+{
+    if (auto composto = dynamic_cast<const FiltroComposto*>(&filtro)) {
+        if (composto->isEmpty()) {
+            // Un composto vuoto accetta tutto, la sua negazione nulla
+            if (!negato) {
+                risultato.emplace_back();
+            }
+            return true;
+        }
+
+        bool congiuntivo = (composto->getOperatore() == FiltroComposto::And) != negato;
+        if (!congiuntivo) {
+            for (const auto& figlio : composto->getFiltri()) {
+                if (!espandiDNF(*figlio, negato, risultato, limite) || risultato.size() > limite) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        // AND: prodotto cartesiano delle forme normali dei figli
+        FormaDisgiuntiva parziale;
+        parziale.emplace_back();
+        for (const auto& figlio : composto->getFiltri()) {
+            FormaDisgiuntiva forma;
+            if (!espandiDNF(*figlio, negato, forma, limite)) {
+                return false;
+            }
+            if (parziale.size() * forma.size() > limite) {
+                return false;
+            }
+
+            FormaDisgiuntiva prodotto;
+            for (const auto& sinistra : parziale) {
+                for (const auto& destra : forma) {
+                    Congiunzione unione = clonaCongiunzione(sinistra);
+                    for (const auto& letterale : destra) {
+                        unione.push_back(letterale->clone());
+                    }
+                    prodotto.push_back(std::move(unione));
+                }
+            }
+            parziale = std::move(prodotto);
+        }
+
+        for (auto& congiunzione : parziale) {
+            risultato.push_back(std::move(congiunzione));
+        }
+        return risultato.size() <= limite;
+    }
+
+    if (auto negazione = dynamic_cast<const FiltroNegato*>(&filtro)) {
+        if (!negazione->getFiltro()) {
+            // NOT (vuoto) non accetta nulla
+            if (negato) {
+                risultato.emplace_back();
+            }
+            return true;
+        }
+        return espandiDNF(*negazione->getFiltro(), !negato, risultato, limite);
+    }
+
+    auto letterale = filtro.clone();
+    if (!letterale) {
+        return false;
+    }
+    if (negato) {
+        letterale = std::make_unique<FiltroNegato>(std::move(letterale));
+    }
+
+    Congiunzione congiunzione;
+    congiunzione.push_back(std::move(letterale));
+    risultato.push_back(std::move(congiunzione));
+    return true;
+}
+
+std::unique_ptr<FiltroStrategy> costruisciCongiunzione(Congiunzione& congiunzione)
+{
+    if (congiunzione.size() == 1) {
+        return std::move(congiunzione.front());
+    }
+
+    auto composto = std::make_unique<FiltroComposto>(FiltroComposto::And);
+    for (auto& letterale : congiunzione) {
+        composto->addFiltro(std::move(letterale));
+    }
+    return composto;
+}
+
+} // namespace
+
+PianificatoreFiltri::PianificatoreFiltri(const StatisticheCollezione& statistiche,
+                                         const SorgenteIndici* indici)
+    : m_statistiche(statistiche), m_indici(indici)
+{
+}
+
+PianoFiltro PianificatoreFiltri::pianifica(const FiltroStrategy& filtro) const
+{
+    PianoFiltro piano;
+
+    auto normalizzato = normalizzaDNF(filtro);
+    if (normalizzato) {
+        piano.spiegazione << "Normalizzato in forma disgiuntiva";
+        piano.filtro = riordina(*normalizzato);
+    } else {
+        piano.spiegazione << "Forma disgiuntiva troppo estesa, mantenuto l'albero originale";
+        piano.filtro = riordina(filtro);
+    }
+
+    size_t totale = m_statistiche.getTotale();
+    size_t stima = 0;
+    if (m_indici && stimaCandidati(*piano.filtro, stima) && stima < totale) {
+        PosizioniMedia candidati;
+        QStringList spiegazioneIndici;
+        if (generaCandidati(*piano.filtro, candidati, spiegazioneIndici)) {
+            piano.usaCandidati = true;
+            piano.candidati = std::move(candidati);
+            piano.spiegazione << spiegazioneIndici;
+        }
+    }
+
+    size_t daValutare = piano.usaCandidati ? piano.candidati.size() : totale;
+    piano.costoStimato = daValutare * piano.filtro->stimaCosto();
+    piano.spiegazione << QString("Ordine di valutazione: %1").arg(piano.filtro->getDescription());
+    piano.spiegazione << QString("Media da valutare: %1 su %2").arg(daValutare).arg(totale);
+
+    return piano;
+}
+
+std::unique_ptr<FiltroStrategy> PianificatoreFiltri::normalizzaDNF(const FiltroStrategy& filtro,
+                                                                    size_t maxCongiunzioni)
+{
+    FormaDisgiuntiva forma;
+    if (!espandiDNF(filtro, false, forma, maxCongiunzioni)) {
+        return nullptr;
+    }
+
+    if (forma.empty()) {
+        // Nessuna congiunzione soddisfacibile: filtro sempre falso
+        return std::make_unique<FiltroNegato>(std::make_unique<FiltroComposto>());
+    }
+
+    for (const auto& congiunzione : forma) {
+        if (congiunzione.empty()) {
+            // Una congiunzione vuota è sempre vera e assorbe tutte le altre
+            return std::make_unique<FiltroComposto>();
+        }
+    }
+
+    if (forma.size() == 1) {
+        return costruisciCongiunzione(forma.front());
+    }
+
+    auto disgiunzione = std::make_unique<FiltroComposto>(FiltroComposto::Or);
+    for (auto& congiunzione : forma) {
+        disgiunzione->addFiltro(costruisciCongiunzione(congiunzione));
+    }
+    return disgiunzione;
+}
+
+std::unique_ptr<FiltroStrategy> PianificatoreFiltri::riordina(const FiltroStrategy& filtro) const
+{
+    auto composto = dynamic_cast<const FiltroComposto*>(&filtro);
+    if (!composto) {
+        return filtro.clone();
+    }
+
+    struct Voce {
+        std::unique_ptr<FiltroStrategy> filtro;
+        double rango;
+    };
+
+    bool disgiuntivo = composto->getOperatore() == FiltroComposto::Or;
+    std::vector<Voce> voci;
+    voci.reserve(composto->size());
+
+    for (const auto& figlio : composto->getFiltri()) {
+        auto riordinato = riordina(*figlio);
+        double selettivita = riordinato->stimaSelettivita(m_statistiche);
+        double costo = std::max(riordinato->stimaCosto(), 0.001);
+
+        // In AND conviene valutare prima i filtri economici che scartano molto,
+        // in OR quelli economici che accettano molto (cortocircuito anticipato)
+        double utilita = disgiuntivo ? selettivita : 1.0 - selettivita;
+        double rango = utilita > 0.0 ? costo / utilita : std::numeric_limits<double>::infinity();
+        voci.push_back({std::move(riordinato), rango});
+    }
+
+    std::stable_sort(voci.begin(), voci.end(), [](const Voce& a, const Voce& b) {
+        return a.rango < b.rango;
+    });
+
+    auto risultato = std::make_unique<FiltroComposto>(composto->getOperatore());
+    for (auto& voce : voci) {
+        risultato->addFiltro(std::move(voce.filtro));
+    }
+    return risultato;
+}
+
+bool PianificatoreFiltri::stimaCandidati(const FiltroStrategy& filtro, size_t& stima) const
+{
+    if (!m_indici) {
+        return false;
+    }
+
+    if (m_indici->puoRisolvere(filtro, stima)) {
+        return true;
+    }
+
+    auto composto = dynamic_cast<const FiltroComposto*>(&filtro);
+    if (!composto || composto->isEmpty()) {
+        return false;
+    }
+
+    if (composto->getOperatore() == FiltroComposto::And) {
+        // Basta un figlio indicizzato: si usa il più selettivo
+        bool trovato = false;
+        for (const auto& figlio : composto->getFiltri()) {
+            size_t parziale = 0;
+            if (stimaCandidati(*figlio, parziale) && (!trovato || parziale < stima)) {
+                stima = parziale;
+                trovato = true;
+            }
+        }
+        return trovato;
+    }
+
+    // OR: tutti i rami devono essere indicizzati
+    size_t somma = 0;
+    for (const auto& figlio : composto->getFiltri()) {
+        size_t parziale = 0;
+        if (!stimaCandidati(*figlio, parziale)) {
+            return false;
+        }
+        somma += parziale;
+    }
+    stima = somma;
+    return true;
+}
+
+bool PianificatoreFiltri::generaCandidati(const FiltroStrategy& filtro, PosizioniMedia& candidati,
+                                          QStringList& spiegazione) const
+{
+    size_t stima = 0;
+    if (m_indici && m_indici->puoRisolvere(filtro, stima)) {
+        candidati = m_indici->candidati(filtro);
+        spiegazione << QString("Indice per %1 (~%2 candidati)").arg(filtro.getDescription()).arg(stima);
+        return true;
+    }
+
+    auto composto = dynamic_cast<const FiltroComposto*>(&filtro);
+    if (!composto || composto->isEmpty()) {
+        return false;
+    }
+
+    if (composto->getOperatore() == FiltroComposto::And) {
+        std::vector<std::pair<size_t, const FiltroStrategy*>> indicizzati;
+        for (const auto& figlio : composto->getFiltri()) {
+            size_t parziale = 0;
+            if (stimaCandidati(*figlio, parziale)) {
+                indicizzati.emplace_back(parziale, figlio.get());
+            }
+        }
+        if (indicizzati.empty()) {
+            return false;
+        }
+
+        std::sort(indicizzati.begin(), indicizzati.end(),
+                  [](const auto& a, const auto& b) { return a.first < b.first; });
+
+        if (!generaCandidati(*indicizzati.front().second, candidati, spiegazione)) {
+            return false;
+        }
+
+        // Interseca solo con gli altri indici abbastanza selettivi da ripagare la costruzione
+        size_t soglia = m_statistiche.getTotale() / 2;
+        for (size_t i = 1; i < indicizzati.size() && indicizzati[i].first < soglia; ++i) {
+            PosizioniMedia altri;
+            if (!generaCandidati(*indicizzati[i].second, altri, spiegazione)) {
+                continue;
+            }
+            PosizioniMedia intersezione;
+            std::set_intersection(candidati.begin(), candidati.end(), altri.begin(), altri.end(),
+                                  std::back_inserter(intersezione));
+            candidati = std::move(intersezione);
+        }
+        return true;
+    }
+
+    // OR: unione dei candidati di tutti i rami
+    PosizioniMedia unione;
+    for (const auto& figlio : composto->getFiltri()) {
+        PosizioniMedia ramo;
+        if (!generaCandidati(*figlio, ramo, spiegazione)) {
+            return false;
+        }
+        PosizioniMedia fusione;
+        std::set_union(unione.begin(), unione.end(), ramo.begin(), ramo.end(),
+                       std::back_inserter(fusione));
+        unione = std::move(fusione);
+    }
+    candidati = std::move(unione);
+    return true;
+}
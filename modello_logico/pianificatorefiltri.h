@@ -0,0 +1,72 @@
+#ifndef PIANIFICATOREFILTRI_H
+#define PIANIFICATOREFILTRI_H
+
+#include "filtrostrategy.h"
+#include <QStringList>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+class StatisticheCollezione;
+
+// Posizioni (indici in ordine di memorizzazione) dei media nella collezione
+using PosizioniMedia = std::vector<uint32_t>;
+
+/**
+ * @brief Interfaccia per gli indici che possono generare candidati per un filtro
+ *
+ * I candidati restituiti sono un sovrainsieme ordinato dei media accettati:
+ * il filtro completo viene comunque rivalutato su ciascuno di essi.
+ */
+class SorgenteIndici
+{
+public:
+    virtual ~SorgenteIndici() = default;
+    virtual bool puoRisolvere(const FiltroStrategy& filtro, size_t& stimaCandidati) const = 0;
+    virtual PosizioniMedia candidati(const FiltroStrategy& filtro) const = 0;
+};
+
+/**
+ * @brief Piano di esecuzione prodotto dal pianificatore
+ */
+struct PianoFiltro
+{
+    std::unique_ptr<FiltroStrategy> filtro;
+    bool usaCandidati = false;
+    PosizioniMedia candidati;
+    double costoStimato = 0.0;
+    QStringList spiegazione;
+};
+
+/**
+ * @brief Pianificatore a costi per alberi di FiltroStrategy
+ *
+ * Normalizza l'albero in forma normale disgiuntiva (OR di AND), ordina i
+ * figli per rapporto costo/selettività e, se disponibili, sceglie gli indici
+ * per generare i candidati invece di scorrere tutta la collezione.
+ */
+class PianificatoreFiltri
+{
+public:
+    PianificatoreFiltri(const StatisticheCollezione& statistiche,
+                        const SorgenteIndici* indici = nullptr);
+
+    PianoFiltro pianifica(const FiltroStrategy& filtro) const;
+
+    // Restituisce nullptr se la forma normale supera il limite di congiunzioni
+    static std::unique_ptr<FiltroStrategy> normalizzaDNF(const FiltroStrategy& filtro,
+                                                         size_t maxCongiunzioni = MAX_CONGIUNZIONI);
+
+    static const size_t MAX_CONGIUNZIONI = 64;
+
+private:
+    std::unique_ptr<FiltroStrategy> riordina(const FiltroStrategy& filtro) const;
+    bool generaCandidati(const FiltroStrategy& filtro, PosizioniMedia& candidati,
+                         QStringList& spiegazione) const;
+    bool stimaCandidati(const FiltroStrategy& filtro, size_t& stima) const;
+
+    const StatisticheCollezione& m_statistiche;
+    const SorgenteIndici* m_indici;
+};
+
+#endif
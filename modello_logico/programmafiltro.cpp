@@ -0,0 +1,459 @@
+#include "programmafiltro.h"
+#include "media.h"
+#include "libro.h"
+#include "film.h"
+#include "articolo.h"
+#include <QElapsedTimer>
+#include <QHash>
+#include <QStringList>
+#include <algorithm>
+#include <limits>
+
+namespace {
+
+// Confronto con l'operando già normalizzato in compilazione: il confronto
+// case-insensitive evita di allocare la copia in minuscolo del valore
+bool confrontaValore(const QString& valore, const QString& cercato, FiltroCriterio::Modalita modalita,
+                     Qt::CaseSensitivity sensibilita)
+{
+    switch (modalita) {
+        case FiltroCriterio::Esatto:
+            return valore.trimmed().compare(cercato, Qt::CaseInsensitive) == 0;
+        case FiltroCriterio::Prefisso:
+            return valore.trimmed().startsWith(cercato, Qt::CaseInsensitive);
+        default:
+            return valore.contains(cercato, sensibilita);
+    }
+}
+
+bool confrontaValori(const QStringList& valori, const QString& cercato, FiltroCriterio::Modalita modalita,
+                     Qt::CaseSensitivity sensibilita)
+{
+    for (const QString& valore : valori) {
+        if (confrontaValore(valore, cercato, modalita, sensibilita)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Stesso ordine di ProgrammaFiltro::Codice
+const char* nomeCodice(uint8_t codice)
+{
+    static const char* nomi[] = {
+        "VERO", "FALSO", "TIPO", "ANNO", "CONTIENE", "ESATTO", "PREFISSO",
+        "TESTO", "GENERICO", "NEGA", "SALTA_SE_FALSO", "SALTA_SE_VERO"
+    };
+    return codice < sizeof(nomi) / sizeof(nomi[0]) ? nomi[codice] : "?";
+}
+
+} // namespace
+
+ProgrammaFiltro::ProgrammaFiltro()
+{
+    emetti(Vero);
+}
+
+ProgrammaFiltro::ProgrammaFiltro(const FiltroStrategy& filtro)
+{
+    compila(filtro);
+    concatenaSalti();
+}
+
+ProgrammaFiltro::~ProgrammaFiltro() = default;
+ProgrammaFiltro::ProgrammaFiltro(ProgrammaFiltro&&) noexcept = default;
+ProgrammaFiltro& ProgrammaFiltro::operator=(ProgrammaFiltro&&) noexcept = default;
+
+bool ProgrammaFiltro::esegui(const Media* media) const
+{
+    if (!media) return false;
+
+    // Un solo registro booleano: le foglie lo scrivono, i salti lo leggono
+    bool registro = true;
+    const Istruzione* codice = m_codice.data();
+    const size_t fine = m_codice.size();
+    size_t pc = 0;
+
+    while (pc < fine) {
+        const Istruzione& istruzione = codice[pc];
+        switch (istruzione.codice) {
+            case Vero:
+                registro = true;
+                break;
+            case Falso:
+                registro = false;
+                break;
+            case Tipo:
+                registro = static_cast<int32_t>(media->getTipoMedia()) == istruzione.a;
+                break;
+            case Anno: {
+                int anno = media->getAnno();
+                registro = anno >= istruzione.a && anno <= istruzione.b;
+                break;
+            }
+            case Contiene:
+            case Esatto:
+            case Prefisso:
+                registro = confrontaCampo(media, istruzione);
+                break;
+            case Testo:
+                registro = media->matchesFilter(m_stringhe[istruzione.operando]);
+                break;
+            case Generico:
+                registro = m_generici[istruzione.operando]->matches(media);
+                break;
+            case Nega:
+                registro = !registro;
+                break;
+            case SaltaSeFalso:
+                if (!registro) {
+                    pc = static_cast<size_t>(istruzione.a);
+                    continue;
+                }
+                break;
+            case SaltaSeVero:
+                if (registro) {
+                    pc = static_cast<size_t>(istruzione.a);
+                    continue;
+                }
+                break;
+        }
+        ++pc;
+    }
+    return registro;
+}
+
+std::vector<Media*> ProgrammaFiltro::filtra(const std::vector<std::unique_ptr<Media>>& media) const
+{
+    std::vector<Media*> risultato;
+    for (const auto& elemento : media) {
+        if (esegui(elemento.get())) {
+            risultato.push_back(elemento.get());
+        }
+    }
+    return risultato;
+}
+
+std::vector<Media*> ProgrammaFiltro::filtra(const std::vector<std::unique_ptr<Media>>& media,
+                                            const PosizioniMedia& posizioni) const
+{
+    std::vector<Media*> risultato;
+    for (uint32_t posizione : posizioni) {
+        Media* elemento = media[posizione].get();
+        if (esegui(elemento)) {
+            risultato.push_back(elemento);
+        }
+    }
+    return risultato;
+}
+
+PosizioniMedia ProgrammaFiltro::seleziona(const std::vector<std::unique_ptr<Media>>& media) const
+{
+    PosizioniMedia risultato;
+    for (size_t i = 0; i < media.size(); ++i) {
+        if (esegui(media[i].get())) {
+            risultato.push_back(static_cast<uint32_t>(i));
+        }
+    }
+    return risultato;
+}
+
+PosizioniMedia ProgrammaFiltro::seleziona(const std::vector<std::unique_ptr<Media>>& media,
+                                          const PosizioniMedia& candidati) const
+{
+    PosizioniMedia risultato;
+    for (uint32_t posizione : candidati) {
+        if (esegui(media[posizione].get())) {
+            risultato.push_back(posizione);
+        }
+    }
+    return risultato;
+}
+
+size_t ProgrammaFiltro::conta(const std::vector<std::unique_ptr<Media>>& media) const
+{
+    return static_cast<size_t>(std::count_if(media.begin(), media.end(), [this](const std::unique_ptr<Media>& elemento) {
+        return esegui(elemento.get());
+    }));
+}
+
+size_t ProgrammaFiltro::conta(const std::vector<std::unique_ptr<Media>>& media, const PosizioniMedia& candidati) const
+{
+    return static_cast<size_t>(std::count_if(candidati.begin(), candidati.end(), [this, &media](uint32_t posizione) {
+        return esegui(media[posizione].get());
+    }));
+}
+
+QString ProgrammaFiltro::disassembla() const
+{
+    QStringList righe;
+    for (size_t pc = 0; pc < m_codice.size(); ++pc) {
+        const Istruzione& istruzione = m_codice[pc];
+        QString riga = QString("%1  %2").arg(static_cast<int>(pc), 3).arg(QString(nomeCodice(istruzione.codice)));
+        switch (istruzione.codice) {
+            case Tipo:
+            case SaltaSeFalso:
+            case SaltaSeVero:
+                riga += QString(" %1").arg(istruzione.a);
+                break;
+            case Anno:
+                riga += QString(" %1-%2").arg(istruzione.a).arg(istruzione.b);
+                break;
+            case Contiene:
+            case Esatto:
+            case Prefisso:
+                riga += QString(" campo=%1 \"%2\"").arg(static_cast<int>(istruzione.campo))
+                                                   .arg(m_stringhe[istruzione.operando]);
+                break;
+            case Testo:
+                riga += QString(" \"%1\"").arg(m_stringhe[istruzione.operando]);
+                break;
+            case Generico:
+                riga += " " + m_generici[istruzione.operando]->getDescription();
+                break;
+            default:
+                break;
+        }
+        righe << riga;
+    }
+    return righe.join("\n");
+}
+
+ProgrammaFiltro::Confronto ProgrammaFiltro::confronta(const FiltroStrategy& filtro,
+                                                      const std::vector<std::unique_ptr<Media>>& media,
+                                                      int ripetizioni)
+{
+    Confronto confronto;
+    confronto.nsAlbero = std::numeric_limits<qint64>::max();
+    confronto.nsProgramma = std::numeric_limits<qint64>::max();
+    QElapsedTimer timer;
+
+    for (int i = 0; i < std::max(1, ripetizioni); ++i) {
+        std::vector<Media*> perAlbero;
+        timer.start();
+        for (const auto& elemento : media) {
+            if (filtro.matches(elemento.get())) {
+                perAlbero.push_back(elemento.get());
+            }
+        }
+        confronto.nsAlbero = std::min(confronto.nsAlbero, timer.nsecsElapsed());
+
+        timer.start();
+        std::vector<Media*> perProgramma = ProgrammaFiltro(filtro).filtra(media);
+        confronto.nsProgramma = std::min(confronto.nsProgramma, timer.nsecsElapsed());
+
+        confronto.accettati = perProgramma.size();
+        confronto.coincidono = confronto.coincidono && perAlbero == perProgramma;
+    }
+    return confronto;
+}
+
+// Private methods
+void ProgrammaFiltro::compila(const FiltroStrategy& filtro)
+{
+    if (auto composto = dynamic_cast<const FiltroComposto*>(&filtro)) {
+        const auto& figli = composto->getFiltri();
+        if (figli.empty()) {
+            emetti(Vero);
+            return;
+        }
+
+        // Ogni figlio tranne l'ultimo esce in anticipo verso la fine del composto
+        Codice salto = composto->getOperatore() == FiltroComposto::Or ? SaltaSeVero : SaltaSeFalso;
+        std::vector<size_t> daCorreggere;
+        for (size_t i = 0; i < figli.size(); ++i) {
+            compila(*figli[i]);
+            if (i + 1 < figli.size()) {
+                daCorreggere.push_back(m_codice.size());
+                emetti(salto);
+            }
+        }
+        for (size_t indice : daCorreggere) {
+            m_codice[indice].a = static_cast<int32_t>(m_codice.size());
+        }
+        return;
+    }
+
+    if (auto negato = dynamic_cast<const FiltroNegato*>(&filtro)) {
+        if (!negato->getFiltro()) {
+            emetti(Falso);
+            return;
+        }
+        compila(*negato->getFiltro());
+        emetti(Nega);
+        return;
+    }
+
+    if (auto filtroTipo = dynamic_cast<const FiltroTipo*>(&filtro)) {
+        static const QHash<QString, Media::TipoMedia> tipi = {
+            {"libro", Media::TipoMedia::Libro},
+            {"film", Media::TipoMedia::Film},
+            {"articolo", Media::TipoMedia::Articolo}
+        };
+        auto it = tipi.constFind(filtroTipo->getTipo().toLower());
+        if (it == tipi.constEnd()) {
+            emetti(Falso);
+        } else {
+            emetti(Tipo, static_cast<int32_t>(it.value()));
+        }
+        return;
+    }
+
+    if (auto filtroAnno = dynamic_cast<const FiltroAnno*>(&filtro)) {
+        emetti(Anno, filtroAnno->getAnnoMin(), filtroAnno->getAnnoMax());
+        return;
+    }
+
+    if (auto criterio = dynamic_cast<const FiltroCriterio*>(&filtro)) {
+        compilaCriterio(*criterio);
+        return;
+    }
+
+    if (auto testo = dynamic_cast<const FiltroTesto*>(&filtro)) {
+        if (testo->getTesto().isEmpty()) {
+            emetti(Vero);
+            return;
+        }
+        emetti(Testo);
+        m_codice.back().operando = aggiungiStringa(testo->getTesto().toLower());
+        return;
+    }
+
+    // Filtro non noto al compilatore: resta una chiamata virtuale
+    auto copia = filtro.clone();
+    if (!copia) {
+        emetti(Falso);
+        return;
+    }
+    emetti(Generico);
+    m_codice.back().operando = static_cast<uint16_t>(m_generici.size());
+    m_generici.push_back(std::move(copia));
+}
+
+void ProgrammaFiltro::compilaCriterio(const FiltroCriterio& filtro)
+{
+    static const QHash<QString, Campo> campi = {
+        {"autore", Autore}, {"editore", Editore}, {"genere", Genere}, {"isbn", Isbn},
+        {"regista", Regista}, {"attore", Attore}, {"casa_produzione", CasaProduzione},
+        {"rivista", Rivista}, {"categoria", Categoria}, {"doi", Doi}
+    };
+
+    auto it = campi.constFind(filtro.getCriterio());
+    if (it == campi.constEnd()) {
+        // Nessun media espone il criterio: matchesCriteria restituirebbe sempre false
+        emetti(Falso);
+        return;
+    }
+
+    Campo campo = it.value();
+    switch (filtro.getModalita()) {
+        case FiltroCriterio::Esatto:
+            emetti(Esatto);
+            m_codice.back().operando = aggiungiStringa(FiltroCriterio::normalizzaValore(filtro.getValore()));
+            break;
+        case FiltroCriterio::Prefisso:
+            emetti(Prefisso);
+            m_codice.back().operando = aggiungiStringa(FiltroCriterio::normalizzaValore(filtro.getValore()));
+            break;
+        default: {
+            // ISBN e DOI sono confrontati alla lettera, come in matchesCriteria
+            bool letterale = campo == Isbn || campo == Doi;
+            emetti(Contiene, 0, letterale ? Qt::CaseSensitive : Qt::CaseInsensitive);
+            m_codice.back().operando = aggiungiStringa(letterale ? filtro.getValore()
+                                                                 : filtro.getValore().toLower());
+            break;
+        }
+    }
+    m_codice.back().campo = campo;
+}
+
+void ProgrammaFiltro::emetti(Codice codice, int32_t a, int32_t b)
+{
+    m_codice.push_back({codice, Autore, 0, a, b});
+}
+
+uint16_t ProgrammaFiltro::aggiungiStringa(const QString& stringa)
+{
+    m_stringhe.push_back(stringa);
+    return static_cast<uint16_t>(m_stringhe.size() - 1);
+}
+
+void ProgrammaFiltro::concatenaSalti()
+{
+    // Un salto che atterra su un altro salto con la stessa condizione lo segue
+    // subito; se la condizione è opposta il secondo salto non scatterà mai.
+    // Le destinazioni crescono sempre, quindi il processo termina.
+    for (size_t pc = m_codice.size(); pc-- > 0;) {
+        Istruzione& istruzione = m_codice[pc];
+        if (istruzione.codice != SaltaSeFalso && istruzione.codice != SaltaSeVero) {
+            continue;
+        }
+        size_t destinazione = static_cast<size_t>(istruzione.a);
+        while (destinazione < m_codice.size()) {
+            const Istruzione& arrivo = m_codice[destinazione];
+            if (arrivo.codice == istruzione.codice) {
+                destinazione = static_cast<size_t>(arrivo.a);
+            } else if (arrivo.codice == SaltaSeFalso || arrivo.codice == SaltaSeVero) {
+                ++destinazione;
+            } else {
+                break;
+            }
+        }
+        istruzione.a = static_cast<int32_t>(destinazione);
+    }
+}
+
+bool ProgrammaFiltro::confrontaCampo(const Media* media, const Istruzione& istruzione) const
+{
+    const QString& cercato = m_stringhe[istruzione.operando];
+    auto sensibilita = static_cast<Qt::CaseSensitivity>(istruzione.b);
+    FiltroCriterio::Modalita modalita = istruzione.codice == Esatto ? FiltroCriterio::Esatto
+                                    : istruzione.codice == Prefisso ? FiltroCriterio::Prefisso
+                                    : FiltroCriterio::Contiene;
+    Media::TipoMedia tipo = media->getTipoMedia();
+
+    // Il tag sostituisce dynamic_cast e chiamata virtuale: static_cast è sicuro
+    switch (istruzione.campo) {
+        case Autore:
+            if (tipo == Media::TipoMedia::Libro) {
+                return confrontaValore(static_cast<const Libro*>(media)->getAutore(), cercato, modalita, sensibilita);
+            }
+            if (tipo == Media::TipoMedia::Articolo) {
+                return confrontaValori(static_cast<const Articolo*>(media)->getAutori(), cercato, modalita, sensibilita);
+            }
+            return false;
+        case Editore:
+            return tipo == Media::TipoMedia::Libro &&
+                   confrontaValore(static_cast<const Libro*>(media)->getEditore(), cercato, modalita, sensibilita);
+        case Genere:
+            if (tipo == Media::TipoMedia::Libro) {
+                return confrontaValore(static_cast<const Libro*>(media)->getGenereString(), cercato, modalita, sensibilita);
+            }
+            if (tipo == Media::TipoMedia::Film) {
+                return confrontaValore(static_cast<const Film*>(media)->getGenereString(), cercato, modalita, sensibilita);
+            }
+            return false;
+        case Isbn:
+            return tipo == Media::TipoMedia::Libro &&
+                   confrontaValore(static_cast<const Libro*>(media)->getIsbn(), cercato, modalita, sensibilita);
+        case Regista:
+            return tipo == Media::TipoMedia::Film &&
+                   confrontaValore(static_cast<const Film*>(media)->getRegista(), cercato, modalita, sensibilita);
+        case Attore:
+            return tipo == Media::TipoMedia::Film &&
+                   confrontaValori(static_cast<const Film*>(media)->getAttori(), cercato, modalita, sensibilita);
+        case CasaProduzione:
+            return tipo == Media::TipoMedia::Film &&
+                   confrontaValore(static_cast<const Film*>(media)->getCasaProduzione(), cercato, modalita, sensibilita);
+        case Rivista:
+            return tipo == Media::TipoMedia::Articolo &&
+                   confrontaValore(static_cast<const Articolo*>(media)->getRivista(), cercato, modalita, sensibilita);
+        case Categoria:
+            return tipo == Media::TipoMedia::Articolo &&
+                   confrontaValore(static_cast<const Articolo*>(media)->getCategoriaString(), cercato, modalita, sensibilita);
+        case Doi:
+            return tipo == Media::TipoMedia::Articolo &&
+                   confrontaValore(static_cast<const Articolo*>(media)->getDoi(), cercato, modalita, sensibilita);
+    }
+    return false;
+}
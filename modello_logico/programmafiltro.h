@@ -0,0 +1,120 @@
+#ifndef PROGRAMMAFILTRO_H
+#define PROGRAMMAFILTRO_H
+
+#include "filtrostrategy.h"
+#include "pianificatorefiltri.h"
+#include <QString>
+#include <QtGlobal>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+class Media;
+
+/**
+ * @brief Forma compilata di un albero di FiltroStrategy
+ *
+ * L'albero viene abbassato a un vettore piatto di istruzioni con salti in
+ * avanti per il cortocircuito di AND/OR. Gli operandi sono normalizzati una
+ * volta sola in compilazione e il tipo concreto del media si legge dal tag,
+ * così l'interprete evita la chiamata virtuale per nodo e le conversioni
+ * toLower per media. I filtri sconosciuti restano valutati tramite matches().
+ */
+class ProgrammaFiltro
+{
+public:
+    // Programma vuoto: accetta ogni media, come un FiltroComposto vuoto
+    ProgrammaFiltro();
+    explicit ProgrammaFiltro(const FiltroStrategy& filtro);
+    ~ProgrammaFiltro();
+
+    ProgrammaFiltro(ProgrammaFiltro&&) noexcept;
+    ProgrammaFiltro& operator=(ProgrammaFiltro&&) noexcept;
+
+    bool esegui(const Media* media) const;
+    std::vector<Media*> filtra(const std::vector<std::unique_ptr<Media>>& media) const;
+    std::vector<Media*> filtra(const std::vector<std::unique_ptr<Media>>& media,
+                               const PosizioniMedia& posizioni) const;
+
+    // Come filtra, ma restituisce le posizioni accettate in ordine crescente
+    PosizioniMedia seleziona(const std::vector<std::unique_ptr<Media>>& media) const;
+    PosizioniMedia seleziona(const std::vector<std::unique_ptr<Media>>& media,
+                             const PosizioniMedia& candidati) const;
+
+    // Solo il numero di media accettati, senza materializzare i risultati
+    size_t conta(const std::vector<std::unique_ptr<Media>>& media) const;
+    size_t conta(const std::vector<std::unique_ptr<Media>>& media, const PosizioniMedia& candidati) const;
+
+    size_t getNumeroIstruzioni() const { return m_codice.size(); }
+    QString disassembla() const;
+
+    /**
+     * @brief Tempi di valutazione ad albero e compilata sugli stessi media
+     *
+     * Per ciascuna forma si tiene il minimo su più ripetizioni; la
+     * compilazione è inclusa nel tempo del programma.
+     */
+    struct Confronto
+    {
+        qint64 nsAlbero = 0;
+        qint64 nsProgramma = 0;
+        size_t accettati = 0;
+        bool coincidono = true;
+    };
+
+    static Confronto confronta(const FiltroStrategy& filtro,
+                               const std::vector<std::unique_ptr<Media>>& media,
+                               int ripetizioni = 5);
+
+private:
+    enum Codice : uint8_t {
+        Vero,
+        Falso,
+        Tipo,
+        Anno,
+        Contiene,
+        Esatto,
+        Prefisso,
+        Testo,
+        Generico,
+        Nega,
+        SaltaSeFalso,
+        SaltaSeVero
+    };
+
+    enum Campo : uint8_t {
+        Autore,
+        Editore,
+        Genere,
+        Isbn,
+        Regista,
+        Attore,
+        CasaProduzione,
+        Rivista,
+        Categoria,
+        Doi
+    };
+
+    // a, b: tipo, intervallo di anni, destinazione del salto o sensibilità al maiuscolo
+    struct Istruzione
+    {
+        Codice codice;
+        Campo campo;
+        uint16_t operando;
+        int32_t a;
+        int32_t b;
+    };
+
+    void compila(const FiltroStrategy& filtro);
+    void compilaCriterio(const FiltroCriterio& filtro);
+    void emetti(Codice codice, int32_t a = 0, int32_t b = 0);
+    uint16_t aggiungiStringa(const QString& stringa);
+    void concatenaSalti();
+    bool confrontaCampo(const Media* media, const Istruzione& istruzione) const;
+
+    std::vector<Istruzione> m_codice;
+    std::vector<QString> m_stringhe;
+    std::vector<std::unique_ptr<FiltroStrategy>> m_generici;
+};
+
+#endif
@@ -0,0 +1,218 @@
+#include "rapportomemoria.h"
+
+namespace {
+
+// Intestazione di QArrayData (contatore, flag, capacità) e overhead tipico di malloc
+const qint64 INTESTAZIONE_DATI_QT = 16;
+const qint64 OVERHEAD_ALLOCATORE = 16;
+
+} // namespace
+
+void RapportoMemoria::aggiungiMedia(const QString& tipo)
+{
+    m_perTipo[tipo].numero += 1;
+}
+
+void RapportoMemoria::aggiungiCampo(const QString& tipo, const QString& campo, Categoria categoria, qint64 byte)
+{
+    Campo& voce = m_perTipo[tipo].campi[campo];
+    voce.categoria = categoria;
+    voce.byte += byte;
+}
+
+void RapportoMemoria::aggiungiContenitore(const QString& nome, qint64 byte)
+{
+    m_contenitori[nome] += byte;
+}
+
+int RapportoMemoria::getNumeroMedia(const QString& tipo) const
+{
+    return m_perTipo.value(tipo).numero;
+}
+
+qint64 RapportoMemoria::getTotaleTipo(const QString& tipo) const
+{
+    qint64 totale = 0;
+    for (const Campo& campo : m_perTipo.value(tipo).campi) {
+        totale += campo.byte;
+    }
+    return totale;
+}
+
+qint64 RapportoMemoria::getTotaleCategoria(Categoria categoria) const
+{
+    qint64 totale = 0;
+    for (const VoceTipo& voce : m_perTipo) {
+        for (const Campo& campo : voce.campi) {
+            if (campo.categoria == categoria) {
+                totale += campo.byte;
+            }
+        }
+    }
+    return totale;
+}
+
+qint64 RapportoMemoria::getTotaleContenitori() const
+{
+    qint64 totale = 0;
+    for (qint64 byte : m_contenitori) {
+        totale += byte;
+    }
+    return totale;
+}
+
+qint64 RapportoMemoria::getTotale() const
+{
+    qint64 totale = getTotaleContenitori();
+    for (auto it = m_perTipo.begin(); it != m_perTipo.end(); ++it) {
+        totale += getTotaleTipo(it.key());
+    }
+    return totale;
+}
+
+QMap<QString, RapportoMemoria::Campo> RapportoMemoria::getCampi(const QString& tipo) const
+{
+    return m_perTipo.value(tipo).campi;
+}
+
+QString RapportoMemoria::toString() const
+{
+    QStringList righe;
+    righe << QString("Memoria stimata: %1").arg(formattaByte(getTotale()));
+
+    for (auto it = m_perTipo.begin(); it != m_perTipo.end(); ++it) {
+        const VoceTipo& voce = it.value();
+        qint64 totale = getTotaleTipo(it.key());
+        righe << QString();
+        righe << QString("%1: %2 media, %3 (%4 per media)")
+                     .arg(it.key())
+                     .arg(voce.numero)
+                     .arg(formattaByte(totale))
+                     .arg(formattaByte(voce.numero > 0 ? totale / voce.numero : 0));
+        for (auto campo = voce.campi.begin(); campo != voce.campi.end(); ++campo) {
+            righe << QString("  %1 [%2]: %3")
+                         .arg(campo.key(), nomeCategoria(campo->categoria), formattaByte(campo->byte));
+        }
+    }
+
+    righe << QString();
+    righe << QString("Per categoria:");
+    for (Categoria categoria : {Struttura, Stringhe, Liste, Date, Compressi}) {
+        righe << QString("  %1: %2").arg(nomeCategoria(categoria), formattaByte(getTotaleCategoria(categoria)));
+    }
+
+    righe << QString();
+    righe << QString("Contenitori: %1").arg(formattaByte(getTotaleContenitori()));
+    for (auto it = m_contenitori.begin(); it != m_contenitori.end(); ++it) {
+        righe << QString("  %1: %2").arg(it.key(), formattaByte(it.value()));
+    }
+
+    return righe.join('\n');
+}
+
+QJsonObject RapportoMemoria::toJson() const
+{
+    QJsonObject tipi;
+    for (auto it = m_perTipo.begin(); it != m_perTipo.end(); ++it) {
+        QJsonObject campi;
+        for (auto campo = it->campi.begin(); campo != it->campi.end(); ++campo) {
+            QJsonObject voce;
+            voce["categoria"] = nomeCategoria(campo->categoria);
+            voce["byte"] = campo->byte;
+            campi[campo.key()] = voce;
+        }
+
+        QJsonObject tipo;
+        tipo["numero"] = it->numero;
+        tipo["byte"] = getTotaleTipo(it.key());
+        tipo["campi"] = campi;
+        tipi[it.key()] = tipo;
+    }
+
+    QJsonObject contenitori;
+    for (auto it = m_contenitori.begin(); it != m_contenitori.end(); ++it) {
+        contenitori[it.key()] = it.value();
+    }
+
+    QJsonObject rapporto;
+    rapporto["totale"] = getTotale();
+    rapporto["tipi"] = tipi;
+    rapporto["contenitori"] = contenitori;
+    return rapporto;
+}
+
+qint64 RapportoMemoria::byteAllocazione(qint64 byteUtili)
+{
+    return byteUtili > 0 ? byteUtili + OVERHEAD_ALLOCATORE : 0;
+}
+
+qint64 RapportoMemoria::byteStringa(const QString& testo)
+{
+    // Le stringhe nulle o letterali non allocano; il terminatore è compreso nel blocco
+    if (testo.capacity() == 0) {
+        return 0;
+    }
+    return byteAllocazione(INTESTAZIONE_DATI_QT + (testo.capacity() + 1) * static_cast<qint64>(sizeof(QChar)));
+}
+
+qint64 RapportoMemoria::byteDati(const QByteArray& dati)
+{
+    if (dati.capacity() == 0) {
+        return 0;
+    }
+    return byteAllocazione(INTESTAZIONE_DATI_QT + dati.capacity() + 1);
+}
+
+qint64 RapportoMemoria::byteLista(const QStringList& lista)
+{
+    if (lista.capacity() == 0) {
+        return 0;
+    }
+
+    qint64 byte = byteAllocazione(INTESTAZIONE_DATI_QT + lista.capacity() * static_cast<qint64>(sizeof(QString)));
+    for (const QString& elemento : lista) {
+        byte += byteStringa(elemento);
+    }
+    return byte;
+}
+
+qint64 RapportoMemoria::byteHash(qint64 voci, qint64 byteVoce)
+{
+    // QHash di Qt 6: un byte di offset per bucket, al più metà dei bucket occupati,
+    // voci negli span da 128 bucket
+    if (voci <= 0) {
+        return 0;
+    }
+    const qint64 bucket = 2 * voci;
+    const qint64 span = bucket / 128 + 1;
+    return byteAllocazione(bucket + voci * byteVoce) + span * byteAllocazione(INTESTAZIONE_DATI_QT);
+}
+
+qint64 RapportoMemoria::byteNodoMappa(qint64 byteVoce)
+{
+    // Nodo rosso-nero di std::map: genitore, figli e colore prima della voce
+    return byteAllocazione(4 * static_cast<qint64>(sizeof(void*)) + byteVoce);
+}
+
+QString RapportoMemoria::nomeCategoria(Categoria categoria)
+{
+    switch (categoria) {
+        case Struttura: return "struttura";
+        case Stringhe: return "stringhe";
+        case Liste: return "liste";
+        case Date: return "date";
+        case Compressi: return "compressi";
+    }
+    return QString();
+}
+
+QString RapportoMemoria::formattaByte(qint64 byte)
+{
+    if (byte >= 1024 * 1024) {
+        return QString("%1 MB").arg(byte / (1024.0 * 1024.0), 0, 'f', 1);
+    }
+    if (byte >= 1024) {
+        return QString("%1 KB").arg(byte / 1024.0, 0, 'f', 1);
+    }
+    return QString("%1 B").arg(byte);
+}
@@ -0,0 +1,74 @@
+#ifndef RAPPORTOMEMORIA_H
+#define RAPPORTOMEMORIA_H
+
+#include <QByteArray>
+#include <QJsonObject>
+#include <QMap>
+#include <QString>
+#include <QStringList>
+#include <QtGlobal>
+
+/**
+ * @brief Stima della memoria occupata da una collezione
+ *
+ * Ogni media vi aggiunge i byte dei propri campi, raggruppati per tipo di
+ * media e per campo; la collezione aggiunge i propri contenitori. I valori
+ * sono stime: contano la capacità allocata di stringhe e liste più
+ * l'intestazione dei dati condivisi di Qt e l'overhead dell'allocatore, ma
+ * non sanno se un dato è condiviso (implicit sharing) con altre copie.
+ */
+class RapportoMemoria
+{
+public:
+    enum Categoria {
+        Struttura,   // l'oggetto stesso: campi numerici, enum, puntatori
+        Stringhe,
+        Liste,
+        Date,
+        Compressi
+    };
+
+    struct Campo {
+        Categoria categoria = Struttura;
+        qint64 byte = 0;
+    };
+
+    void aggiungiMedia(const QString& tipo);
+    void aggiungiCampo(const QString& tipo, const QString& campo, Categoria categoria, qint64 byte);
+    void aggiungiContenitore(const QString& nome, qint64 byte);
+
+    QStringList getTipi() const { return m_perTipo.keys(); }
+    int getNumeroMedia(const QString& tipo) const;
+    qint64 getTotaleTipo(const QString& tipo) const;
+    qint64 getTotaleCategoria(Categoria categoria) const;
+    qint64 getTotaleContenitori() const;
+    qint64 getTotale() const;
+    QMap<QString, Campo> getCampi(const QString& tipo) const;
+
+    QString toString() const;
+    QJsonObject toJson() const;
+
+    // Stime di heap per i tipi di Qt usati nei media
+    static qint64 byteAllocazione(qint64 byteUtili);
+    static qint64 byteStringa(const QString& testo);
+    static qint64 byteDati(const QByteArray& dati);
+    static qint64 byteLista(const QStringList& lista);
+
+    // Strutture degli indici, esclusi i dati a cui puntano le voci
+    static qint64 byteHash(qint64 voci, qint64 byteVoce);
+    static qint64 byteNodoMappa(qint64 byteVoce);
+
+    static QString nomeCategoria(Categoria categoria);
+    static QString formattaByte(qint64 byte);
+
+private:
+    struct VoceTipo {
+        int numero = 0;
+        QMap<QString, Campo> campi;
+    };
+
+    QMap<QString, VoceTipo> m_perTipo;
+    QMap<QString, qint64> m_contenitori;
+};
+
+#endif
@@ -0,0 +1,92 @@
+#include "risultatiricerca.h"
+#include "filtrostrategy.h"
+#include <algorithm>
+
+namespace {
+
+// Punteggio decrescente; a parità vale l'ordine della collezione
+bool precede(const RisultatoRicerca& a, const RisultatoRicerca& b)
+{
+    if (a.punteggio != b.punteggio) {
+        return a.punteggio > b.punteggio;
+    }
+    return a.posizione < b.posizione;
+}
+
+} // namespace
+
+RisultatiRicerca::RisultatiRicerca(std::vector<RisultatoRicerca> risultati)
+    : m_risultati(std::move(risultati))
+{
+}
+
+RisultatiRicerca RisultatiRicerca::inOrdine(std::vector<Media*> media)
+{
+    // La posizione nella lista fa da ordine: a punteggio uguale precede() la rispetta
+    std::vector<RisultatoRicerca> risultati;
+    risultati.reserve(media.size());
+    for (size_t i = 0; i < media.size(); ++i) {
+        risultati.push_back({media[i], 0.0, static_cast<uint32_t>(i)});
+    }
+
+    RisultatiRicerca ordinati(std::move(risultati));
+    ordinati.m_ordinati = ordinati.m_risultati.size();
+    return ordinati;
+}
+
+void RisultatiRicerca::filtra(const FiltroStrategy& filtro)
+{
+    // remove_if conserva l'ordine relativo: il prefisso già ordinato resta valido
+    size_t ordinatiRimasti = 0;
+    for (size_t i = 0; i < m_ordinati; ++i) {
+        if (filtro.matches(m_risultati[i].media)) {
+            ++ordinatiRimasti;
+        }
+    }
+
+    auto fine = std::remove_if(m_risultati.begin(), m_risultati.end(),
+                               [&filtro](const RisultatoRicerca& risultato) {
+                                   return !filtro.matches(risultato.media);
+                               });
+    m_risultati.erase(fine, m_risultati.end());
+    m_ordinati = ordinatiRimasti;
+}
+
+std::vector<Media*> RisultatiRicerca::intervallo(size_t inizio, size_t quanti)
+{
+    std::vector<Media*> media;
+    if (inizio >= m_risultati.size()) {
+        return media;
+    }
+
+    size_t fine = std::min(m_risultati.size(), inizio + quanti);
+    ordinaFino(fine);
+
+    media.reserve(fine - inizio);
+    for (size_t i = inizio; i < fine; ++i) {
+        media.push_back(m_risultati[i].media);
+    }
+    return media;
+}
+
+std::vector<Media*> RisultatiRicerca::pagina(size_t numero, size_t dimensione)
+{
+    return intervallo(numero * dimensione, dimensione);
+}
+
+void RisultatiRicerca::ordinaFino(size_t limite)
+{
+    limite = std::min(limite, m_risultati.size());
+    if (limite <= m_ordinati) {
+        return;
+    }
+
+    auto inizio = m_risultati.begin() + m_ordinati;
+    auto confine = m_risultati.begin() + limite;
+    if (confine != m_risultati.end()) {
+        // Porta in [inizio, confine) i migliori del resto, poi ordina solo quelli
+        std::nth_element(inizio, confine, m_risultati.end(), precede);
+    }
+    std::sort(inizio, confine, precede);
+    m_ordinati = limite;
+}
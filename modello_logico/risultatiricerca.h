@@ -0,0 +1,51 @@
+#ifndef RISULTATIRICERCA_H
+#define RISULTATIRICERCA_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class Media;
+class FiltroStrategy;
+
+struct RisultatoRicerca
+{
+    Media* media;
+    double punteggio;
+    uint32_t posizione;
+};
+
+/**
+ * @brief Risultati di una ricerca per rilevanza, ordinati su richiesta
+ *
+ * I punteggi vengono calcolati una sola volta. Ogni pagina richiesta
+ * estende il prefisso ordinato con nth_element sul resto e un sort della
+ * sola pagina, quindi i primi k costano O(n + k log k) e le pagine
+ * successive non rielaborano quelle già servite.
+ */
+class RisultatiRicerca
+{
+public:
+    RisultatiRicerca() = default;
+    explicit RisultatiRicerca(std::vector<RisultatoRicerca> risultati);
+
+    // Media già ordinati dal chiamante (es. per criteri espliciti): servono solo la paginazione
+    static RisultatiRicerca inOrdine(std::vector<Media*> media);
+
+    size_t totale() const { return m_risultati.size(); }
+    bool isEmpty() const { return m_risultati.empty(); }
+
+    // Scarta i risultati non accettati dal filtro (prima della paginazione)
+    void filtra(const FiltroStrategy& filtro);
+
+    std::vector<Media*> intervallo(size_t inizio, size_t quanti);
+    std::vector<Media*> pagina(size_t numero, size_t dimensione);
+
+private:
+    void ordinaFino(size_t limite);
+
+    std::vector<RisultatoRicerca> m_risultati;
+    size_t m_ordinati = 0;
+};
+
+#endif
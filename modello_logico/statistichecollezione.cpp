@@ -0,0 +1,58 @@
+#include "statistichecollezione.h"
+#include "media.h"
+#include "filtrostrategy.h"
+
+StatisticheCollezione::StatisticheCollezione(const std::vector<std::unique_ptr<Media>>& media)
+    : m_totale(media.size())
+{
+    for (const auto& m : media) {
+        if (!m) continue;
+        m_perTipo[m->getTypeDisplayName().toLower()]++;
+        m_anni[m->getAnno()]++;
+    }
+
+    // Campione a passo costante, così copre tutta la collezione
+    if (!media.empty()) {
+        size_t passo = qMax<size_t>(1, media.size() / DIMENSIONE_CAMPIONE);
+        for (size_t i = 0; i < media.size() && m_campione.size() < DIMENSIONE_CAMPIONE; i += passo) {
+            if (media[i]) {
+                m_campione.push_back(media[i].get());
+            }
+        }
+    }
+}
+
+size_t StatisticheCollezione::contaPerTipo(const QString& tipo) const
+{
+    return m_perTipo.value(tipo.toLower(), 0);
+}
+
+double StatisticheCollezione::frazioneAnni(int annoMin, int annoMax) const
+{
+    if (m_totale == 0 || annoMin > annoMax) {
+        return annoMin > annoMax ? 0.0 : 1.0;
+    }
+
+    size_t conteggio = 0;
+    for (auto it = m_anni.lower_bound(annoMin); it != m_anni.end() && it->first <= annoMax; ++it) {
+        conteggio += it->second;
+    }
+    return static_cast<double>(conteggio) / m_totale;
+}
+
+double StatisticheCollezione::selettivitaCampione(const FiltroStrategy& filtro) const
+{
+    if (m_campione.empty()) {
+        return 1.0;
+    }
+
+    size_t accettati = 0;
+    for (const Media* media : m_campione) {
+        if (filtro.matches(media)) {
+            ++accettati;
+        }
+    }
+
+    // Correzione additiva: un campione senza risultati non porta la stima a zero
+    return (accettati + 0.5) / (m_campione.size() + 1.0);
+}
@@ -0,0 +1,39 @@
+#ifndef STATISTICHECOLLEZIONE_H
+#define STATISTICHECOLLEZIONE_H
+
+#include <QString>
+#include <QHash>
+#include <map>
+#include <memory>
+#include <vector>
+
+class Media;
+class FiltroStrategy;
+
+/**
+ * @brief Statistiche sintetiche della collezione usate dal pianificatore dei filtri
+ *
+ * Raccoglie conteggi per tipo, distribuzione degli anni e un campione
+ * uniforme dei media su cui stimare la selettività dei filtri generici.
+ * Va ricostruita dopo ogni modifica della collezione.
+ */
+class StatisticheCollezione
+{
+public:
+    explicit StatisticheCollezione(const std::vector<std::unique_ptr<Media>>& media);
+
+    size_t getTotale() const { return m_totale; }
+    size_t contaPerTipo(const QString& tipo) const;
+    double frazioneAnni(int annoMin, int annoMax) const;
+    double selettivitaCampione(const FiltroStrategy& filtro) const;
+
+private:
+    size_t m_totale;
+    QHash<QString, size_t> m_perTipo;
+    std::map<int, size_t> m_anni;
+    std::vector<const Media*> m_campione;
+
+    static const size_t DIMENSIONE_CAMPIONE = 256;
+};
+
+#endif
@@ -0,0 +1,149 @@
+#include "testocompresso.h"
+#include "rapportomemoria.h"
+#include <QDebug>
+#include <QHash>
+#include <QMutex>
+#include <QMutexLocker>
+#include <atomic>
+
+namespace {
+
+struct VoceCache {
+    QString testo;
+    quint64 ultimoUso;
+};
+
+// Stato condiviso da tutti i testi: i media possono essere letti da più thread
+struct StatoCompressione {
+    QMutex mutex;
+    quint64 orologio = 0;
+    QHash<const TestoCompresso*, VoceCache> cache;
+    TestoCompresso::Statistiche statistiche = {0, 0, 0, 0, 0};
+};
+
+std::atomic<int> s_soglia(0);
+
+StatoCompressione& stato()
+{
+    static StatoCompressione istanza;
+    return istanza;
+}
+
+} // namespace
+
+TestoCompresso::~TestoCompresso()
+{
+    rilascia();
+}
+
+TestoCompresso& TestoCompresso::operator=(const QString& testo)
+{
+    rilascia();
+
+    int soglia = s_soglia.load(std::memory_order_relaxed);
+    if (soglia <= 0 || testo.size() < soglia) {
+        m_testo = testo;
+        return *this;
+    }
+
+    QByteArray compresso = qCompress(testo.toUtf8());
+    qint64 byteOriginali = static_cast<qint64>(testo.size()) * static_cast<qint64>(sizeof(QChar));
+    if (compresso.size() >= byteOriginali) {
+        // Testo poco comprimibile: non vale la decompressione a ogni lettura
+        m_testo = testo;
+        return *this;
+    }
+
+    m_compresso = compresso;
+    m_lunghezza = static_cast<int>(testo.size());
+
+    StatoCompressione& s = stato();
+    QMutexLocker locker(&s.mutex);
+    s.statistiche.testiCompressi += 1;
+    s.statistiche.byteOriginali += byteOriginali;
+    s.statistiche.byteCompressi += m_compresso.size();
+    return *this;
+}
+
+QString TestoCompresso::testo() const
+{
+    if (!isCompresso()) {
+        return m_testo;
+    }
+
+    StatoCompressione& s = stato();
+    {
+        QMutexLocker locker(&s.mutex);
+        ++s.orologio;
+        s.statistiche.letture += 1;
+        auto it = s.cache.find(this);
+        if (it != s.cache.end()) {
+            it->ultimoUso = s.orologio;
+            s.statistiche.lettureDallaCache += 1;
+            return it->testo;
+        }
+    }
+
+    // Decompressione fuori dal lock: è la parte costosa
+    QString testo = QString::fromUtf8(qUncompress(m_compresso));
+    if (testo.size() != m_lunghezza) {
+        qWarning() << "TestoCompresso: lunghezza decompressa inattesa";
+    }
+
+    QMutexLocker locker(&s.mutex);
+    if (s.cache.size() >= CAPACITA_CACHE && !s.cache.contains(this)) {
+        // Eliminazione della voce usata meno di recente (cache piccola: scansione lineare)
+        auto vecchia = s.cache.begin();
+        for (auto voce = s.cache.begin(); voce != s.cache.end(); ++voce) {
+            if (voce->ultimoUso < vecchia->ultimoUso) {
+                vecchia = voce;
+            }
+        }
+        s.cache.erase(vecchia);
+    }
+    s.cache.insert(this, VoceCache{testo, s.orologio});
+    return testo;
+}
+
+qint64 TestoCompresso::byteOccupati() const
+{
+    return isCompresso() ? RapportoMemoria::byteDati(m_compresso) : RapportoMemoria::byteStringa(m_testo);
+}
+
+void TestoCompresso::setSoglia(int caratteri)
+{
+    s_soglia.store(caratteri, std::memory_order_relaxed);
+}
+
+int TestoCompresso::getSoglia()
+{
+    return s_soglia.load(std::memory_order_relaxed);
+}
+
+TestoCompresso::Statistiche TestoCompresso::getStatistiche()
+{
+    StatoCompressione& s = stato();
+    QMutexLocker locker(&s.mutex);
+    return s.statistiche;
+}
+
+// Private methods
+void TestoCompresso::rilascia()
+{
+    m_testo.clear();
+    if (!isCompresso()) {
+        return;
+    }
+
+    // La voce in cache è indicizzata dall'indirizzo: va tolta prima che lo riusi un altro testo
+    StatoCompressione& s = stato();
+    QMutexLocker locker(&s.mutex);
+    s.cache.remove(this);
+    s.statistiche.testiCompressi -= 1;
+    s.statistiche.byteOriginali -= static_cast<qint64>(m_lunghezza) * static_cast<qint64>(sizeof(QChar));
+    s.statistiche.byteCompressi -= m_compresso.size();
+    locker.unlock();
+
+    m_compresso.clear();
+    m_lunghezza = 0;
+}
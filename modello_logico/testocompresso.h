@@ -0,0 +1,63 @@
+#ifndef TESTOCOMPRESSO_H
+#define TESTOCOMPRESSO_H
+
+#include <QByteArray>
+#include <QString>
+#include <QtGlobal>
+
+/**
+ * @brief Testo lungo conservato compresso in memoria
+ *
+ * I testi che superano la soglia (in caratteri) vengono compressi con
+ * qCompress sulla loro codifica UTF-8 e decompressi alla lettura; gli ultimi
+ * testi decodificati restano in una piccola cache LRU condivisa, così le
+ * letture ripetute della stessa scheda non pagano la decompressione.
+ * La soglia vale per le assegnazioni successive: 0 disattiva la compressione.
+ *
+ * Il costo si paga nelle ricerche per sottostringa sul testo completo
+ * (Media::matchesFilter, FiltroTesto): la cache tiene pochi testi, quindi
+ * scorrere una collezione decomprime ogni descrizione compressa. Le ricerche
+ * di sole parole prendono i candidati dall'IndiceTestuale e decomprimono
+ * solo quelli; con query di punteggiatura o filtri di testo frequenti
+ * conviene una soglia più alta.
+ */
+class TestoCompresso
+{
+public:
+    struct Statistiche {
+        qint64 testiCompressi;
+        qint64 byteOriginali;     // UTF-16, come occuperebbero da QString
+        qint64 byteCompressi;
+        qint64 letture;
+        qint64 lettureDallaCache;
+
+        qint64 byteRisparmiati() const { return byteOriginali - byteCompressi; }
+    };
+
+    TestoCompresso() = default;
+    explicit TestoCompresso(const QString& testo) { *this = testo; }
+    ~TestoCompresso();
+
+    TestoCompresso(const TestoCompresso&) = delete;
+    TestoCompresso& operator=(const TestoCompresso&) = delete;
+
+    TestoCompresso& operator=(const QString& testo);
+    QString testo() const;
+    bool isCompresso() const { return !m_compresso.isEmpty(); }
+    qint64 byteOccupati() const;
+
+    static void setSoglia(int caratteri);
+    static int getSoglia();
+    static Statistiche getStatistiche();
+
+    static const int CAPACITA_CACHE = 32;
+
+private:
+    void rilascia();
+
+    QString m_testo;
+    QByteArray m_compresso;
+    int m_lunghezza = 0;
+};
+
+#endif
@@ -0,0 +1,55 @@
+#include "testoricerca.h"
+
+QString TestoRicerca::normalizza(const QString& testo)
+{
+    QString risultato;
+    risultato.reserve(testo.size());
+
+    bool soloAscii = true;
+    for (QChar c : testo) {
+        if (c.unicode() >= 128) {
+            soloAscii = false;
+            break;
+        }
+    }
+
+    // Caso comune: niente decomposizione per il testo ASCII
+    const QString decomposto = soloAscii ? testo : testo.normalized(QString::NormalizationForm_D);
+    for (QChar c : decomposto) {
+        if (!c.isMark()) {
+            risultato.append(c.toLower());
+        }
+    }
+    return risultato;
+}
+
+bool TestoRicerca::soloParole(const QString& testo)
+{
+    bool parola = false;
+    for (QChar c : testo) {
+        if (c.isLetterOrNumber() || c.isMark()) {
+            parola = true;
+        } else if (!c.isSpace()) {
+            return false;
+        }
+    }
+    return parola;
+}
+
+QStringList TestoRicerca::tokenizza(const QString& testo)
+{
+    QStringList token;
+    QString normalizzato = normalizza(testo);
+
+    qsizetype inizio = -1;
+    for (qsizetype i = 0; i <= normalizzato.size(); ++i) {
+        bool alfanumerico = i < normalizzato.size() && normalizzato.at(i).isLetterOrNumber();
+        if (alfanumerico && inizio < 0) {
+            inizio = i;
+        } else if (!alfanumerico && inizio >= 0) {
+            token << normalizzato.mid(inizio, i - inizio);
+            inizio = -1;
+        }
+    }
+    return token;
+}
@@ -0,0 +1,24 @@
+#ifndef TESTORICERCA_H
+#define TESTORICERCA_H
+
+#include <QString>
+#include <QStringList>
+
+/**
+ * @brief Normalizzazione e tokenizzazione condivise dagli indici testuali
+ *
+ * Minuscole, accenti rimossi (decomposizione canonica senza segni
+ * diacritici) e separazione sui caratteri non alfanumerici: "Perché"
+ * e "perche" producono lo stesso termine.
+ */
+class TestoRicerca
+{
+public:
+    static QString normalizza(const QString& testo);
+    static QStringList tokenizza(const QString& testo);
+    
+    // Vero se il testo contiene almeno una parola e solo lettere, cifre e spazi
+    static bool soloParole(const QString& testo);
+};
+
+#endif
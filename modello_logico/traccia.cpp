@@ -0,0 +1,256 @@
+#include "traccia.h"
+#include <QByteArray>
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QThread>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+namespace {
+
+struct Evento {
+    const char* categoria;
+    const char* nome;
+    qint64 inizio;
+    qint64 durata;   // negativa per i contatori
+    qint64 valore;
+};
+
+struct Blocco {
+    Evento eventi[Traccia::EVENTI_PER_BLOCCO];
+};
+
+// Scritto solo dal thread proprietario; chi legge si ferma a "pubblicati"
+struct BufferThread {
+    int numero = 0;
+    QString nome;
+    std::atomic<Blocco*> blocchi[Traccia::BLOCCHI_PER_THREAD];
+    std::atomic<qint64> pubblicati{0};
+
+    BufferThread()
+    {
+        for (auto& blocco : blocchi) {
+            blocco.store(nullptr, std::memory_order_relaxed);
+        }
+    }
+
+    ~BufferThread()
+    {
+        for (auto& blocco : blocchi) {
+            delete blocco.load(std::memory_order_relaxed);
+        }
+    }
+};
+
+struct StatoTraccia {
+    // Solo per registrare i thread, azzerare e scrivere: mai durante la registrazione di un evento
+    QMutex mutex;
+    std::vector<std::unique_ptr<BufferThread>> buffer;
+    std::atomic<bool> attiva{false};
+    std::atomic<qint64> persi{0};
+    QElapsedTimer orologio;
+
+    StatoTraccia() { orologio.start(); }
+};
+
+StatoTraccia& stato()
+{
+    static StatoTraccia istanza;
+    return istanza;
+}
+
+// I buffer sopravvivono ai thread: la traccia può essere salvata dopo la loro fine
+thread_local BufferThread* t_buffer = nullptr;
+
+BufferThread& bufferCorrente()
+{
+    if (!t_buffer) {
+        StatoTraccia& s = stato();
+        QMutexLocker locker(&s.mutex);
+
+        auto nuovo = std::make_unique<BufferThread>();
+        nuovo->numero = static_cast<int>(s.buffer.size()) + 1;
+
+        QThread* thread = QThread::currentThread();
+        QCoreApplication* applicazione = QCoreApplication::instance();
+        if (applicazione && thread == applicazione->thread()) {
+            nuovo->nome = "principale";
+        } else if (thread && !thread->objectName().isEmpty()) {
+            nuovo->nome = thread->objectName();
+        } else {
+            nuovo->nome = QString("thread %1").arg(nuovo->numero);
+        }
+
+        t_buffer = nuovo.get();
+        s.buffer.push_back(std::move(nuovo));
+    }
+    return *t_buffer;
+}
+
+void aggiungi(const Evento& evento)
+{
+    BufferThread& buffer = bufferCorrente();
+    qint64 indice = buffer.pubblicati.load(std::memory_order_relaxed);
+
+    qint64 numeroBlocco = indice / Traccia::EVENTI_PER_BLOCCO;
+    if (numeroBlocco >= Traccia::BLOCCHI_PER_THREAD) {
+        stato().persi.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    Blocco* blocco = buffer.blocchi[numeroBlocco].load(std::memory_order_relaxed);
+    if (!blocco) {
+        blocco = new Blocco;
+        buffer.blocchi[numeroBlocco].store(blocco, std::memory_order_release);
+    }
+
+    blocco->eventi[indice % Traccia::EVENTI_PER_BLOCCO] = evento;
+    buffer.pubblicati.store(indice + 1, std::memory_order_release);
+}
+
+QByteArray stringaJson(const QByteArray& testo)
+{
+    QByteArray risultato;
+    risultato.reserve(testo.size() + 2);
+    risultato += '"';
+    for (char c : testo) {
+        if (c == '"' || c == '\\') {
+            risultato += '\\';
+            risultato += c;
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            risultato += "\\u00";
+            risultato += QByteArray::number(static_cast<int>(c), 16).rightJustified(2, '0');
+        } else {
+            risultato += c;
+        }
+    }
+    risultato += '"';
+    return risultato;
+}
+
+// Il formato trace_event usa microsecondi
+QByteArray microsecondi(qint64 nanosecondi)
+{
+    return QByteArray::number(static_cast<double>(nanosecondi) / 1000.0, 'f', 3);
+}
+
+const qint64 DIMENSIONE_SCRITTURA = 1024 * 1024;
+
+} // namespace
+
+void Traccia::avvia()
+{
+    StatoTraccia& s = stato();
+    QMutexLocker locker(&s.mutex);
+
+    // Un thread a metà di una registrazione può ripubblicare un solo evento vecchio
+    for (const auto& buffer : s.buffer) {
+        buffer->pubblicati.store(0, std::memory_order_release);
+    }
+    s.persi.store(0, std::memory_order_relaxed);
+    s.attiva.store(true, std::memory_order_release);
+}
+
+void Traccia::ferma()
+{
+    stato().attiva.store(false, std::memory_order_release);
+}
+
+bool Traccia::isAttiva()
+{
+    return stato().attiva.load(std::memory_order_relaxed);
+}
+
+void Traccia::registraIntervallo(const char* categoria, const char* nome, qint64 inizio, qint64 durata)
+{
+    aggiungi(Evento{categoria, nome, inizio, qMax<qint64>(0, durata), 0});
+}
+
+void Traccia::registraContatore(const char* categoria, const char* nome, qint64 valore)
+{
+    aggiungi(Evento{categoria, nome, adesso(), -1, valore});
+}
+
+qint64 Traccia::adesso()
+{
+    return stato().orologio.nsecsElapsed();
+}
+
+qint64 Traccia::getEventiPersi()
+{
+    return stato().persi.load(std::memory_order_relaxed);
+}
+
+qint64 Traccia::getNumeroEventi()
+{
+    StatoTraccia& s = stato();
+    QMutexLocker locker(&s.mutex);
+
+    qint64 totale = 0;
+    for (const auto& buffer : s.buffer) {
+        totale += buffer->pubblicati.load(std::memory_order_acquire);
+    }
+    return totale;
+}
+
+bool Traccia::scrivi(QIODevice& uscita)
+{
+    StatoTraccia& s = stato();
+    QMutexLocker locker(&s.mutex);
+
+    QByteArray testo = "{\"traceEvents\":[";
+    bool primo = true;
+    auto nuovoEvento = [&]() {
+        testo += primo ? "\n" : ",\n";
+        primo = false;
+    };
+
+    for (const auto& buffer : s.buffer) {
+        const QByteArray tid = QByteArray::number(buffer->numero);
+
+        nuovoEvento();
+        testo += "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" + tid
+                 + ",\"args\":{\"name\":" + stringaJson(buffer->nome.toUtf8()) + "}}";
+
+        const qint64 pubblicati = buffer->pubblicati.load(std::memory_order_acquire);
+        for (qint64 i = 0; i < pubblicati; ++i) {
+            const Blocco* blocco = buffer->blocchi[i / EVENTI_PER_BLOCCO].load(std::memory_order_acquire);
+            const Evento& evento = blocco->eventi[i % EVENTI_PER_BLOCCO];
+
+            nuovoEvento();
+            testo += "{\"name\":" + stringaJson(evento.nome)
+                     + ",\"cat\":" + stringaJson(evento.categoria)
+                     + ",\"ts\":" + microsecondi(evento.inizio)
+                     + ",\"pid\":1,\"tid\":" + tid;
+            if (evento.durata >= 0) {
+                testo += ",\"ph\":\"X\",\"dur\":" + microsecondi(evento.durata) + "}";
+            } else {
+                testo += ",\"ph\":\"C\",\"args\":{\"valore\":" + QByteArray::number(evento.valore) + "}}";
+            }
+
+            if (testo.size() >= DIMENSIONE_SCRITTURA) {
+                if (uscita.write(testo) != testo.size()) {
+                    return false;
+                }
+                testo.resize(0);
+            }
+        }
+    }
+
+    testo += "\n],\"displayTimeUnit\":\"ms\",\"otherData\":{\"eventi_persi\":"
+             + QByteArray::number(s.persi.load(std::memory_order_relaxed)) + "}}\n";
+    return uscita.write(testo) == testo.size();
+}
+
+bool Traccia::salva(const QString& filename)
+{
+    QFile file(filename);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        return false;
+    }
+    return scrivi(file);
+}
@@ -0,0 +1,94 @@
+#ifndef TRACCIA_H
+#define TRACCIA_H
+
+#include <QIODevice>
+#include <QString>
+#include <QtGlobal>
+
+/**
+ * @brief Tracciamento degli intervalli di esecuzione nel formato Chrome trace_event
+ *
+ * Gli intervalli (TRACCIA_INTERVALLO, per la durata di uno scope) e i
+ * contatori (TRACCIA_CONTATORE) vengono registrati in un buffer per thread:
+ * ogni thread scrive solo nel proprio, senza lock, e la scrittura pubblica il
+ * nuovo evento con un contatore atomico. salva() produce il JSON da aprire in
+ * chrome://tracing o Perfetto.
+ *
+ * Le macro esistono solo se il progetto è compilato con CONFIG+=traccia
+ * (BIBLIOTECA_TRACCIA); altrimenti non generano codice. Anche compilate, non
+ * registrano nulla finché la traccia non viene avviata.
+ *
+ * Nomi e categorie devono essere stringhe statiche (letterali): il buffer
+ * conserva solo i puntatori.
+ */
+class Traccia
+{
+public:
+    // Azzera gli eventi registrati e inizia a registrare
+    static void avvia();
+    static void ferma();
+    static bool isAttiva();
+
+    static void registraIntervallo(const char* categoria, const char* nome, qint64 inizio, qint64 durata);
+    static void registraContatore(const char* categoria, const char* nome, qint64 valore);
+
+    // Nanosecondi dall'avvio del processo
+    static qint64 adesso();
+
+    // Eventi persi perché il buffer di un thread era pieno
+    static qint64 getEventiPersi();
+    static qint64 getNumeroEventi();
+
+    // Da chiamare a traccia ferma: i thread potrebbero ancora scrivere
+    static bool scrivi(QIODevice& uscita);
+    static bool salva(const QString& filename);
+
+    // Eventi per thread: blocchi allocati al bisogno, fino al limite
+    static const int EVENTI_PER_BLOCCO = 4096;
+    static const int BLOCCHI_PER_THREAD = 64;
+};
+
+/**
+ * @brief Intervallo registrato dalla costruzione alla distruzione
+ */
+class IntervalloTraccia
+{
+public:
+    IntervalloTraccia(const char* categoria, const char* nome)
+        : m_categoria(categoria)
+        , m_nome(nome)
+        , m_inizio(Traccia::isAttiva() ? Traccia::adesso() : -1)
+    {
+    }
+
+    ~IntervalloTraccia()
+    {
+        if (m_inizio >= 0) {
+            Traccia::registraIntervallo(m_categoria, m_nome, m_inizio, Traccia::adesso() - m_inizio);
+        }
+    }
+
+    IntervalloTraccia(const IntervalloTraccia&) = delete;
+    IntervalloTraccia& operator=(const IntervalloTraccia&) = delete;
+
+private:
+    const char* m_categoria;
+    const char* m_nome;
+    qint64 m_inizio;
+};
+
+#ifdef BIBLIOTECA_TRACCIA
+#define TRACCIA_CONCATENA_(a, b) a##b
+#define TRACCIA_CONCATENA(a, b) TRACCIA_CONCATENA_(a, b)
+#define TRACCIA_INTERVALLO(categoria, nome) \
+    IntervalloTraccia TRACCIA_CONCATENA(intervalloTraccia_, __LINE__)(categoria, nome)
+#define TRACCIA_CONTATORE(categoria, nome, valore) \
+    do { \
+        if (Traccia::isAttiva()) Traccia::registraContatore(categoria, nome, static_cast<qint64>(valore)); \
+    } while (false)
+#else
+#define TRACCIA_INTERVALLO(categoria, nome) ((void)0)
+#define TRACCIA_CONTATORE(categoria, nome, valore) ((void)0)
+#endif
+
+#endif
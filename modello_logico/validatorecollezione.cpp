@@ -0,0 +1,143 @@
+#include "validatorecollezione.h"
+#include "libro.h"
+#include "traccia.h"
+#include <QElapsedTimer>
+#include <QSet>
+#include <QThread>
+#include <algorithm>
+#include <thread>
+
+QStringList RapportoValidazione::getMessaggi(ProblemaValidazione::Gravita gravita) const
+{
+    QStringList messaggi;
+    for (const ProblemaValidazione& problema : problemi) {
+        if (problema.gravita == gravita) {
+            messaggi << problema.messaggio;
+        }
+    }
+    return messaggi;
+}
+
+ValidatoreCollezione::ValidatoreCollezione(int numeroThread)
+    : m_numeroThread(numeroThread > 0 ? numeroThread : QThread::idealThreadCount())
+{
+    if (m_numeroThread < 1) {
+        m_numeroThread = 1;
+    }
+}
+
+RapportoValidazione ValidatoreCollezione::valida(const std::vector<std::unique_ptr<Media>>& media) const
+{
+    TRACCIA_INTERVALLO("modello", "ValidatoreCollezione::valida");
+    QElapsedTimer timer;
+    timer.start();
+
+    RapportoValidazione rapporto;
+    rapporto.controllati = media.size();
+
+    size_t numeroThread = std::min(static_cast<size_t>(m_numeroThread),
+                                   media.size() / MEDIA_MINIMI_PER_THREAD);
+    numeroThread = std::max<size_t>(numeroThread, 1);
+    rapporto.thread = static_cast<int>(numeroThread);
+
+    // Un vettore di problemi per intervallo: i thread non condividono nulla in scrittura
+    std::vector<std::vector<ProblemaValidazione>> perIntervallo(numeroThread);
+    const size_t passo = (media.size() + numeroThread - 1) / numeroThread;
+
+    std::vector<std::thread> thread;
+    thread.reserve(numeroThread - 1);
+    for (size_t t = 1; t < numeroThread; ++t) {
+        const size_t inizio = std::min(t * passo, media.size());
+        const size_t fine = std::min(inizio + passo, media.size());
+        thread.emplace_back([this, &media, &perIntervallo, t, inizio, fine]() {
+            validaIntervallo(media, inizio, fine, perIntervallo[t]);
+        });
+    }
+    // Il primo intervallo lo valida il thread chiamante
+    validaIntervallo(media, 0, std::min(passo, media.size()), perIntervallo[0]);
+    for (std::thread& t : thread) {
+        t.join();
+    }
+
+    for (auto& problemi : perIntervallo) {
+        rapporto.problemi.insert(rapporto.problemi.end(),
+                                 std::make_move_iterator(problemi.begin()),
+                                 std::make_move_iterator(problemi.end()));
+    }
+
+    cercaIdDuplicati(media, rapporto.problemi);
+
+    // Stabile: per lo stesso media i problemi dei dati precedono quello dell'ID
+    std::stable_sort(rapporto.problemi.begin(), rapporto.problemi.end(),
+                     [](const ProblemaValidazione& a, const ProblemaValidazione& b) {
+                         return a.indice < b.indice;
+                     });
+
+    for (const ProblemaValidazione& problema : rapporto.problemi) {
+        if (problema.gravita == ProblemaValidazione::Errore) {
+            ++rapporto.errori;
+        } else {
+            ++rapporto.avvisi;
+        }
+    }
+
+    rapporto.nsTotali = timer.nsecsElapsed();
+    TRACCIA_CONTATORE("modello", "problemi validazione", rapporto.problemi.size());
+    return rapporto;
+}
+
+// Private methods
+void ValidatoreCollezione::validaIntervallo(const std::vector<std::unique_ptr<Media>>& media,
+                                            size_t inizio, size_t fine,
+                                            std::vector<ProblemaValidazione>& problemi) const
+{
+    TRACCIA_INTERVALLO("modello", "ValidatoreCollezione::validaIntervallo");
+
+    for (size_t i = inizio; i < fine; ++i) {
+        const Media* elemento = media[i].get();
+
+        if (!elemento) {
+            problemi.push_back({ProblemaValidazione::Errore, i,
+                                QString("Media #%1: Puntatore nullo").arg(i)});
+            continue;
+        }
+
+        if (!elemento->isCompleteAndValid()) {
+            problemi.push_back({ProblemaValidazione::Errore, i,
+                                QString("Media #%1 (%2): Dati non validi").arg(i).arg(elemento->getTitolo())});
+            continue;
+        }
+
+        // Il formato dell'ISBN è già stato verificato da isCompleteAndValid
+        if (elemento->getTipoMedia() == Media::TipoMedia::Libro) {
+            const QString isbn = static_cast<const Libro*>(elemento)->getIsbn();
+            if (!isbn.isEmpty() && !Libro::isbnChecksumValido(isbn)) {
+                problemi.push_back({ProblemaValidazione::Avviso, i,
+                                    QString("Media #%1 (%2): cifra di controllo dell'ISBN %3 errata")
+                                        .arg(QString::number(i), elemento->getTitolo(), isbn)});
+            }
+        }
+    }
+}
+
+void ValidatoreCollezione::cercaIdDuplicati(const std::vector<std::unique_ptr<Media>>& media,
+                                            std::vector<ProblemaValidazione>& problemi) const
+{
+    TRACCIA_INTERVALLO("modello", "ValidatoreCollezione::cercaIdDuplicati");
+
+    QSet<QString> ids;
+    ids.reserve(static_cast<int>(media.size()));
+
+    for (size_t i = 0; i < media.size(); ++i) {
+        const Media* elemento = media[i].get();
+        if (!elemento) continue;
+
+        // Una sola ricerca nella tabella: l'ID è duplicato se l'inserimento non la fa crescere
+        const auto prima = ids.size();
+        ids.insert(elemento->getId());
+        if (ids.size() == prima) {
+            problemi.push_back({ProblemaValidazione::Errore, i,
+                                QString("Media #%1 (%2): ID duplicato").arg(i).arg(elemento->getTitolo())});
+        }
+    }
+}
@@ -0,0 +1,74 @@
+#ifndef VALIDATORECOLLEZIONE_H
+#define VALIDATORECOLLEZIONE_H
+
+#include "media.h"
+#include <QString>
+#include <QStringList>
+#include <memory>
+#include <vector>
+
+/**
+ * @brief Problema trovato dalla validazione di un media
+ */
+struct ProblemaValidazione
+{
+    enum Gravita {
+        Errore,   // il media non è valido (o l'ID è duplicato)
+        Avviso    // il media è valido ma un dato è sospetto, es. la cifra di controllo dell'ISBN
+    };
+
+    Gravita gravita;
+    size_t indice;      // posizione del media nella collezione
+    QString messaggio;
+};
+
+/**
+ * @brief Esito della validazione di una collezione
+ */
+struct RapportoValidazione
+{
+    size_t controllati = 0;
+    int errori = 0;
+    int avvisi = 0;
+    int thread = 1;
+    qint64 nsTotali = 0;
+    std::vector<ProblemaValidazione> problemi;   // in ordine di indice
+
+    bool isValido() const { return errori == 0; }
+    QStringList getMessaggi(ProblemaValidazione::Gravita gravita) const;
+};
+
+/**
+ * @brief Validazione in parallelo di una collezione
+ *
+ * I media vengono divisi in intervalli contigui, uno per thread: ogni thread
+ * valida i propri media (isCompleteAndValid e cifra di controllo dell'ISBN)
+ * e raccoglie i problemi in un vettore proprio, poi i vettori vengono
+ * concatenati nell'ordine della collezione. Gli ID duplicati si cercano in un
+ * secondo passaggio con una tabella hash.
+ *
+ * Ogni media è letto da un solo thread. I campi verificati sono tutti caldi,
+ * quindi anche con il caricamento pigro la validazione non legge il file.
+ * Durante la validazione la collezione non deve essere modificata.
+ */
+class ValidatoreCollezione
+{
+public:
+    // 0: un thread per core (QThread::idealThreadCount)
+    explicit ValidatoreCollezione(int numeroThread = 0);
+
+    RapportoValidazione valida(const std::vector<std::unique_ptr<Media>>& media) const;
+
+    // Sotto questa soglia per thread avviare un thread costa più della validazione
+    static const size_t MEDIA_MINIMI_PER_THREAD = 2048;
+
+private:
+    void validaIntervallo(const std::vector<std::unique_ptr<Media>>& media, size_t inizio, size_t fine,
+                          std::vector<ProblemaValidazione>& problemi) const;
+    void cercaIdDuplicati(const std::vector<std::unique_ptr<Media>>& media,
+                          std::vector<ProblemaValidazione>& problemi) const;
+
+    int m_numeroThread;
+};
+
+#endif
@@ -0,0 +1,74 @@
+# Libreria statica del modello logico e della persistenza JSON
+#
+# Dipende solo da QtCore: l'applicazione, la riga di comando e i benchmark
+# la collegano tramite ../modello.pri, senza ricompilarne i sorgenti.
+QT = core
+
+CONFIG += c++17 staticlib optimize_full
+TEMPLATE = lib
+TARGET = biblioteca_nucleo
+
+# Libreria nella cartella di build del progetto, senza sottocartelle debug/release
+DESTDIR = $$OUT_PWD
+
+INCLUDEPATH += .. \
+               ../modello_logico \
+               ../json
+
+SOURCES += ../modello_logico/media.cpp \
+           ../modello_logico/libro.cpp \
+           ../modello_logico/film.cpp \
+           ../modello_logico/articolo.cpp \
+           ../modello_logico/collezione.cpp \
+           ../modello_logico/filtrostrategy.cpp \
+           ../modello_logico/statistichecollezione.cpp \
+           ../modello_logico/pianificatorefiltri.cpp \
+           ../modello_logico/indicecollezione.cpp \
+           ../modello_logico/indicecompletamento.cpp \
+           ../modello_logico/testoricerca.cpp \
+           ../modello_logico/distanzamodifica.cpp \
+           ../modello_logico/indicetestuale.cpp \
+           ../modello_logico/risultatiricerca.cpp \
+           ../modello_logico/parserfiltri.cpp \
+           ../modello_logico/programmafiltro.cpp \
+           ../modello_logico/cachefiltri.cpp \
+           ../modello_logico/ordinamentomedia.cpp \
+           ../modello_logico/cursoremedia.cpp \
+           ../modello_logico/testocompresso.cpp \
+           ../modello_logico/rapportomemoria.cpp \
+           ../modello_logico/traccia.cpp \
+           ../modello_logico/validatorecollezione.cpp \
+           ../json/jsonmanager.cpp \
+           ../json/caricamentopigro.cpp
+
+HEADERS += ../modello_logico/media.h \
+           ../modello_logico/libro.h \
+           ../modello_logico/film.h \
+           ../modello_logico/articolo.h \
+           ../modello_logico/collezione.h \
+           ../modello_logico/filtrostrategy.h \
+           ../modello_logico/statistichecollezione.h \
+           ../modello_logico/pianificatorefiltri.h \
+           ../modello_logico/indicecollezione.h \
+           ../modello_logico/indicecompletamento.h \
+           ../modello_logico/testoricerca.h \
+           ../modello_logico/distanzamodifica.h \
+           ../modello_logico/indicetestuale.h \
+           ../modello_logico/risultatiricerca.h \
+           ../modello_logico/parserfiltri.h \
+           ../modello_logico/programmafiltro.h \
+           ../modello_logico/cachefiltri.h \
+           ../modello_logico/ordinamentomedia.h \
+           ../modello_logico/cursoremedia.h \
+           ../modello_logico/testocompresso.h \
+           ../modello_logico/rapportomemoria.h \
+           ../modello_logico/traccia.h \
+           ../modello_logico/validatorecollezione.h \
+           ../json/jsonmanager.h \
+           ../json/caricamentopigro.h
+
+# qmake CONFIG+=traccia: intervalli e contatori di Traccia compilati (vedi traccia.h)
+traccia: DEFINES += BIBLIOTECA_TRACCIA
+
+DEFINES += QT_DEPRECATED_WARNINGS
+DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0x060000
@@ -0,0 +1,19 @@
+# Generatore di collezioni sintetiche per i test di carico
+#
+# qmake generatore.pro && make
+# ./generatore_catalogo -n 1000000 -s 42 -o catalogo.json
+QT = core
+
+CONFIG += c++17 console
+CONFIG -= app_bundle
+
+TARGET = generatore_catalogo
+TEMPLATE = app
+
+SOURCES += main.cpp \
+           generatorecatalogo.cpp
+
+HEADERS += generatorecatalogo.h
+
+DEFINES += QT_DEPRECATED_WARNINGS
+DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0x060000
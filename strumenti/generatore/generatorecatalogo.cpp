@@ -0,0 +1,373 @@
+#include "generatorecatalogo.h"
+#include <QDate>
+#include <QDateTime>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+const double PI = 3.14159265358979323846;
+
+const QStringList NOMI = {
+    "Marco", "Giulia", "Luca", "Francesca", "Alessandro", "Chiara", "Andrea", "Sara",
+    "Matteo", "Valentina", "Lorenzo", "Elena", "Davide", "Martina", "Simone", "Alessia",
+    "Federico", "Silvia", "Riccardo", "Paola", "Giovanni", "Laura", "Stefano", "Anna",
+    "Paolo", "Roberta", "Michele", "Federica", "Antonio", "Beatrice", "Giorgio", "Marta",
+    "Pietro", "Irene", "Tommaso", "Camilla", "Emanuele", "Ilaria", "Filippo", "Noemi"
+};
+
+const QStringList COGNOMI = {
+    "Rossi", "Russo", "Ferrari", "Esposito", "Bianchi", "Romano", "Colombo", "Ricci",
+    "Marino", "Greco", "Bruno", "Gallo", "Conti", "De Luca", "Mancini", "Costa",
+    "Giordano", "Rizzo", "Lombardi", "Moretti", "Barbieri", "Fontana", "Santoro", "Mariani",
+    "Rinaldi", "Caruso", "Ferrara", "Galli", "Martini", "Leone", "Longo", "Gentile",
+    "Martinelli", "Vitale", "Lombardo", "Serra", "Coppola", "De Santis", "D'Angelo", "Marchetti",
+    "Parisi", "Villa", "Conte", "Ferraro", "Ferri", "Fabbri", "Bianco", "Marini",
+    "Grasso", "Valentini", "Messina", "Sala", "De Angelis", "Gatti", "Pellegrini", "Palumbo",
+    "Sanna", "Farina", "Rizzi", "Monti"
+};
+
+const QStringList EDITORI = {
+    "Mondadori", "Einaudi", "Feltrinelli", "Adelphi", "Bompiani", "Garzanti", "Rizzoli",
+    "Laterza", "Sellerio", "Il Mulino", "Zanichelli", "Longanesi", "Guanda", "Marsilio",
+    "Neri Pozza", "Fazi", "Minimum Fax", "Iperborea", "Salani", "Giunti"
+};
+
+const QStringList PREFISSI_RIVISTE = {
+    "Rivista di", "Annali di", "Quaderni di", "Giornale di", "Bollettino di", "Studi di", "Archivio di"
+};
+
+const QStringList ARGOMENTI = {
+    "Fisica", "Medicina", "Economia", "Storia", "Filosofia", "Informatica", "Biologia",
+    "Chimica", "Sociologia", "Arte", "Letteratura", "Ingegneria", "Statistica", "Ecologia", "Diritto"
+};
+
+const QStringList PAROLE = {
+    "di", "il", "la", "che", "e", "un", "una", "del", "della", "nel", "per", "con", "tra", "sul",
+    "storia", "tempo", "vita", "mondo", "notte", "giorno", "casa", "città", "mare", "amore",
+    "guerra", "memoria", "viaggio", "famiglia", "segreto", "ombra", "luce", "silenzio", "voce",
+    "strada", "fiume", "montagna", "giardino", "confine", "ritorno", "sogno", "destino", "verità",
+    "ultimo", "primo", "nuovo", "antico", "lungo", "breve", "oscuro", "chiaro", "perduto",
+    "ricerca", "analisi", "studio", "modello", "sistema", "metodo", "teoria", "effetto", "ruolo",
+    "sviluppo", "crisi", "società", "cultura", "scienza", "natura", "uomo", "donna", "bambino",
+    "padre", "madre", "fratello", "amico", "nemico", "re", "regina", "cavaliere", "viaggiatore",
+    "mistero", "indagine", "delitto", "avventura", "leggenda", "racconto", "cronaca", "diario",
+    "lettera", "libro", "parola", "numero", "immagine", "colore", "suono", "vento", "pioggia",
+    "neve", "sole", "luna", "stella", "cielo", "terra", "fuoco", "acqua", "pietra", "ferro",
+    "oro", "vetro", "carta", "porta", "finestra", "ponte", "torre", "isola", "deserto", "bosco"
+};
+
+// Genere, classificazione e categorie con i pesi relativi (indice = valore dell'enum)
+const std::vector<double> PESI_GENERE_LIBRO = {30, 15, 6, 8, 8, 12, 4, 8, 6, 3};
+const std::vector<double> PESI_GENERE_FILM = {14, 16, 20, 7, 7, 5, 10, 8, 4, 5, 2, 1, 1, 0.5};
+const std::vector<double> PESI_CLASSIFICAZIONE = {10, 25, 35, 25, 5};
+const std::vector<double> PESI_CATEGORIA = {25, 15, 15, 10, 6, 8, 4, 5, 4, 2, 3, 2, 1};
+const std::vector<double> PESI_TIPO_RIVISTA = {40, 15, 20, 5, 5, 5, 10};
+
+int sceltaPesata(QRandomGenerator& generatore, const std::vector<double>& pesi)
+{
+    double totale = 0;
+    for (double peso : pesi) {
+        totale += peso;
+    }
+    double valore = generatore.generateDouble() * totale;
+    for (size_t i = 0; i < pesi.size(); ++i) {
+        valore -= pesi[i];
+        if (valore < 0) {
+            return static_cast<int>(i);
+        }
+    }
+    return static_cast<int>(pesi.size()) - 1;
+}
+
+} // namespace
+
+GeneratoreCatalogo::DistribuzioneZipf::DistribuzioneZipf(int elementi, double esponente)
+{
+    m_cumulata.reserve(static_cast<size_t>(elementi));
+    double somma = 0;
+    for (int rango = 1; rango <= elementi; ++rango) {
+        somma += 1.0 / std::pow(rango, esponente);
+        m_cumulata.push_back(somma);
+    }
+    for (double& valore : m_cumulata) {
+        valore /= somma;
+    }
+}
+
+int GeneratoreCatalogo::DistribuzioneZipf::campiona(QRandomGenerator& generatore) const
+{
+    double valore = generatore.generateDouble();
+    auto it = std::upper_bound(m_cumulata.begin(), m_cumulata.end(), valore);
+    if (it == m_cumulata.end()) {
+        --it;
+    }
+    return static_cast<int>(it - m_cumulata.begin());
+}
+
+GeneratoreCatalogo::GeneratoreCatalogo(const Opzioni& opzioni)
+    : m_opzioni(opzioni),
+      m_generatore(opzioni.seme),
+      m_annoMassimo(opzioni.annoMassimo > 0 ? opzioni.annoMassimo : QDate::currentDate().year()),
+      m_libri(0), m_film(0), m_articoli(0),
+      m_autori(creaNomi(NUMERO_AUTORI, opzioni.seme + 1)),
+      m_registi(creaNomi(NUMERO_REGISTI, opzioni.seme + 2)),
+      m_attori(creaNomi(NUMERO_ATTORI, opzioni.seme + 3)),
+      m_zipfAutori(NUMERO_AUTORI, opzioni.esponenteZipf),
+      m_zipfRegisti(NUMERO_REGISTI, opzioni.esponenteZipf),
+      m_zipfAttori(NUMERO_ATTORI, opzioni.esponenteZipf),
+      m_zipfEditori(NUMERO_EDITORI, opzioni.esponenteZipf),
+      m_zipfCaseProduzione(NUMERO_CASE_PRODUZIONE, opzioni.esponenteZipf),
+      m_zipfRiviste(static_cast<int>(PREFISSI_RIVISTE.size() * ARGOMENTI.size()), opzioni.esponenteZipf),
+      m_zipfParole(static_cast<int>(PAROLE.size()), opzioni.esponenteZipf)
+{
+    // Editori e case oltre quelli reali: "Edizioni <cognome>", "<cognome> Film"
+    m_editori = EDITORI;
+    for (int i = 0; m_editori.size() < NUMERO_EDITORI; ++i) {
+        m_editori << QString("Edizioni %1").arg(COGNOMI[i % COGNOMI.size()]);
+    }
+    for (int i = 0; m_caseProduzione.size() < NUMERO_CASE_PRODUZIONE; ++i) {
+        m_caseProduzione << QString("%1 Film").arg(COGNOMI[(i * 7) % COGNOMI.size()]);
+    }
+    for (const QString& argomento : ARGOMENTI) {
+        for (const QString& prefisso : PREFISSI_RIVISTE) {
+            m_riviste << QString("%1 %2").arg(prefisso, argomento);
+        }
+    }
+}
+
+bool GeneratoreCatalogo::genera(QIODevice& uscita, const std::function<void(quint64)>& avanzamento)
+{
+    // Il documento è scritto a mano intorno ai singoli media, con le chiavi
+    // nello stesso ordine di QJsonDocument
+    QByteArray blocco;
+    const int DIMENSIONE_BLOCCO = 1 << 20;
+    blocco.reserve(DIMENSIONE_BLOCCO + 4096);
+    blocco.append("{\n    \"media\": [\n");
+
+    for (quint64 i = 0; i < m_opzioni.numero; ++i) {
+        blocco.append("        ");
+        blocco.append(QJsonDocument(prossimoMedia()).toJson(QJsonDocument::Compact));
+        blocco.append(i + 1 < m_opzioni.numero ? ",\n" : "\n");
+
+        if (blocco.size() >= DIMENSIONE_BLOCCO) {
+            if (uscita.write(blocco) != blocco.size()) {
+                return false;
+            }
+            blocco.resize(0);
+            if (avanzamento) {
+                avanzamento(i + 1);
+            }
+        }
+    }
+
+    QJsonObject metadata;
+    metadata["versione"] = "1.0";
+    metadata["data_creazione"] = QDateTime::currentDateTime().toString(Qt::ISODate);
+    metadata["numero_media"] = static_cast<qint64>(m_opzioni.numero);
+    metadata["generato_da"] = QString("Generatore catalogo (seme %1)").arg(m_opzioni.seme);
+
+    blocco.append("    ],\n    \"metadata\": ");
+    blocco.append(QJsonDocument(metadata).toJson(QJsonDocument::Compact));
+    blocco.append("\n}\n");
+
+    if (uscita.write(blocco) != blocco.size()) {
+        return false;
+    }
+    if (avanzamento) {
+        avanzamento(m_opzioni.numero);
+    }
+    return true;
+}
+
+QJsonObject GeneratoreCatalogo::prossimoMedia()
+{
+    double tipo = m_generatore.generateDouble();
+    if (tipo < m_opzioni.quotaLibri) {
+        return creaLibro();
+    }
+    if (tipo < m_opzioni.quotaLibri + m_opzioni.quotaFilm) {
+        return creaFilm();
+    }
+    return creaArticolo();
+}
+
+QString GeneratoreCatalogo::isbn13(quint64 corpo)
+{
+    // Prefisso 978 e gruppo 88 (area italiana), nove cifre di editore e titolo
+    QString dodici = QString("97888%1").arg(corpo % 10000000ULL, 7, 10, QChar('0'));
+    return QString("%1-%2%3").arg(dodici.left(3), dodici.mid(3)).arg(cifraControlloIsbn13(dodici));
+}
+
+int GeneratoreCatalogo::cifraControlloIsbn13(const QString& dodiciCifre)
+{
+    int somma = 0;
+    for (int i = 0; i < 12 && i < dodiciCifre.size(); ++i) {
+        int cifra = dodiciCifre[i].digitValue();
+        somma += (i % 2 == 0) ? cifra : cifra * 3;
+    }
+    return (10 - somma % 10) % 10;
+}
+
+// Private methods
+QJsonObject GeneratoreCatalogo::creaLibro()
+{
+    QJsonObject libro;
+    campiComuni(libro, "libro", ++m_libri, 1800);
+    libro["autore"] = scegli(m_autori, m_zipfAutori);
+    libro["editore"] = scegli(m_editori, m_zipfEditori);
+    libro["pagine"] = std::clamp(static_cast<int>(std::exp(5.6 + 0.5 * normale())), 48, 1800);
+    // Un libro su dieci senza ISBN, come nelle schede inserite a mano
+    libro["isbn"] = m_generatore.bounded(10) == 0 ? QString() : isbn13(m_generatore.generate64());
+    libro["genere"] = sceltaPesata(m_generatore, PESI_GENERE_LIBRO);
+    return libro;
+}
+
+QJsonObject GeneratoreCatalogo::creaFilm()
+{
+    QJsonObject film;
+    campiComuni(film, "film", ++m_film, 1920);
+    film["regista"] = scegli(m_registi, m_zipfRegisti);
+    film["attori"] = QJsonArray::fromStringList(persone(m_attori, m_zipfAttori, 1, 0.75, 25));
+    film["durata"] = std::clamp(static_cast<int>(105 + 20 * normale()), 60, 240);
+    film["genere"] = sceltaPesata(m_generatore, PESI_GENERE_FILM);
+    film["classificazione"] = sceltaPesata(m_generatore, PESI_CLASSIFICAZIONE);
+    film["casa_produzione"] = scegli(m_caseProduzione, m_zipfCaseProduzione);
+    return film;
+}
+
+QJsonObject GeneratoreCatalogo::creaArticolo()
+{
+    QJsonObject articolo;
+    campiComuni(articolo, "articolo", ++m_articoli, 1950);
+    int annoArticolo = articolo["anno"].toInt();
+
+    articolo["autori"] = QJsonArray::fromStringList(persone(m_autori, m_zipfAutori, 1, 0.55, 40));
+    articolo["rivista"] = scegli(m_riviste, m_zipfRiviste);
+    articolo["volume"] = QString::number(std::max(1, annoArticolo - 1950 + m_generatore.bounded(5)));
+    articolo["numero"] = QString::number(1 + m_generatore.bounded(12));
+    int primaPagina = 1 + m_generatore.bounded(400);
+    articolo["pagine"] = QString("%1-%2").arg(primaPagina).arg(primaPagina + 2 + m_generatore.bounded(30));
+    articolo["categoria"] = sceltaPesata(m_generatore, PESI_CATEGORIA);
+    articolo["tipo_rivista"] = sceltaPesata(m_generatore, PESI_TIPO_RIVISTA);
+
+    QDate data(annoArticolo, 1, 1);
+    data = data.addDays(m_generatore.bounded(data.daysInYear()));
+    if (data > QDate::currentDate()) {
+        data = QDate::currentDate();
+    }
+    articolo["data_pubblicazione"] = data.toString(Qt::ISODate);
+
+    // DOI: prefisso di registrazione di quattro o cinque cifre e suffisso libero
+    articolo["doi"] = m_generatore.bounded(5) == 0 ? QString()
+        : QString("10.%1/%2.%3.%4").arg(1000 + m_generatore.bounded(99000))
+                                    .arg(ARGOMENTI[m_generatore.bounded(ARGOMENTI.size())].toLower())
+                                    .arg(annoArticolo)
+                                    .arg(m_articoli);
+    return articolo;
+}
+
+void GeneratoreCatalogo::campiComuni(QJsonObject& media, const QString& tipo, quint64 numero, int annoMinimo)
+{
+    media["type"] = tipo;
+    media["id"] = QString("%1-%2").arg(tipo).arg(numero, 3, 10, QChar('0'));
+    media["titolo"] = titolo();
+    media["anno"] = anno(annoMinimo);
+    media["descrizione"] = descrizione();
+}
+
+int GeneratoreCatalogo::anno(int minimo)
+{
+    // Il cubo di un uniforme concentra gli anni vicino al presente
+    double u = m_generatore.generateDouble();
+    return m_annoMassimo - static_cast<int>(u * u * u * (m_annoMassimo - minimo));
+}
+
+QString GeneratoreCatalogo::titolo()
+{
+    int parole = 1 + geometrica(0, 0.6, 9);
+    QStringList testo;
+    for (int i = 0; i < parole; ++i) {
+        testo << scegli(PAROLE, m_zipfParole);
+    }
+    testo[0][0] = testo[0][0].toUpper();
+    return testo.join(' ');
+}
+
+QString GeneratoreCatalogo::descrizione()
+{
+    // Lunghezza log-normale: mediana di circa 40 parole, coda lunga fino a 600
+    int parole = std::clamp(static_cast<int>(std::exp(3.7 + 0.8 * normale())), 3, 600);
+    QString testo;
+    testo.reserve(parole * 8);
+    for (int i = 0; i < parole; ++i) {
+        if (i > 0) {
+            testo += (i % 15 == 0) ? QStringLiteral(". ") : QStringLiteral(" ");
+        }
+        testo += scegli(PAROLE, m_zipfParole);
+    }
+    testo[0] = testo[0].toUpper();
+    testo += '.';
+    return testo;
+}
+
+QStringList GeneratoreCatalogo::persone(const QStringList& serbatoio, const DistribuzioneZipf& distribuzione,
+                                        int minimo, double continua, int massimo)
+{
+    int quante = geometrica(minimo, continua, massimo);
+    QStringList risultato;
+    // Con esponenti alti i primi ranghi dominano: i tentativi sono limitati
+    for (int tentativi = 0; risultato.size() < quante && tentativi < quante * 20; ++tentativi) {
+        QString persona = scegli(serbatoio, distribuzione);
+        if (!risultato.contains(persona)) {
+            risultato << persona;
+        }
+    }
+    return risultato;
+}
+
+int GeneratoreCatalogo::geometrica(int minimo, double continua, int massimo)
+{
+    int valore = minimo;
+    while (valore < massimo && m_generatore.generateDouble() < continua) {
+        ++valore;
+    }
+    return valore;
+}
+
+double GeneratoreCatalogo::normale()
+{
+    // Box-Muller; 1 - u evita il logaritmo di zero
+    double u = 1.0 - m_generatore.generateDouble();
+    double v = m_generatore.generateDouble();
+    return std::sqrt(-2.0 * std::log(u)) * std::cos(2.0 * PI * v);
+}
+
+QString GeneratoreCatalogo::scegli(const QStringList& serbatoio, const DistribuzioneZipf& distribuzione)
+{
+    return serbatoio[distribuzione.campiona(m_generatore)];
+}
+
+QStringList GeneratoreCatalogo::creaNomi(int quanti, quint32 seme)
+{
+    // Nome e cognome, poi doppio cognome quando le combinazioni finiscono
+    QStringList nomi;
+    nomi.reserve(quanti);
+    const int combinazioni = static_cast<int>(NOMI.size() * COGNOMI.size());
+    for (int i = 0; i < quanti; ++i) {
+        QString nome = QString("%1 %2").arg(NOMI[i % NOMI.size()], COGNOMI[(i / NOMI.size()) % COGNOMI.size()]);
+        if (i >= combinazioni) {
+            nome += " " + COGNOMI[(i / combinazioni) % COGNOMI.size()];
+        }
+        nomi << nome;
+    }
+
+    // Fisher-Yates con il generatore di Qt: std::shuffle non è riproducibile tra librerie
+    QRandomGenerator generatore(seme);
+    for (int i = static_cast<int>(nomi.size()) - 1; i > 0; --i) {
+        nomi.swapItemsAt(i, generatore.bounded(i + 1));
+    }
+    return nomi;
+}
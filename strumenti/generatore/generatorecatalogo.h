@@ -0,0 +1,106 @@
+#ifndef GENERATORECATALOGO_H
+#define GENERATORECATALOGO_H
+
+#include <QIODevice>
+#include <QJsonObject>
+#include <QRandomGenerator>
+#include <QString>
+#include <QStringList>
+#include <functional>
+#include <vector>
+
+/**
+ * @brief Generatore di collezioni sintetiche nel formato di JsonManager
+ *
+ * Produce media validi con distribuzioni realistiche: autori, registi,
+ * attori, editori e parole seguono una legge di Zipf, gli anni sono
+ * sbilanciati verso il presente, le descrizioni hanno lunghezza log-normale
+ * e le liste di persone lunghezza geometrica; ISBN-13 e DOI sono ben formati
+ * (l'ISBN con la cifra di controllo corretta).
+ *
+ * Lo stesso seme (con lo stesso anno massimo) produce gli stessi media; solo
+ * la data di creazione nei metadata cambia. I media vengono serializzati e
+ * scritti uno alla volta: la memoria usata non dipende dal numero di media.
+ */
+class GeneratoreCatalogo
+{
+public:
+    struct Opzioni {
+        quint64 numero = 1000;
+        quint32 seme = 1;
+        double esponenteZipf = 1.1;
+        int annoMassimo = 0;   // 0 = anno corrente
+        // Quote dei tipi; il resto sono articoli
+        double quotaLibri = 0.5;
+        double quotaFilm = 0.3;
+    };
+
+    explicit GeneratoreCatalogo(const Opzioni& opzioni);
+
+    // Il callback di avanzamento riceve il numero di media già scritti
+    bool genera(QIODevice& uscita, const std::function<void(quint64)>& avanzamento = nullptr);
+
+    // Un media alla volta, per chi non vuole il file completo
+    QJsonObject prossimoMedia();
+
+    static QString isbn13(quint64 corpo);
+    static int cifraControlloIsbn13(const QString& dodiciCifre);
+
+private:
+    class DistribuzioneZipf
+    {
+    public:
+        DistribuzioneZipf(int elementi, double esponente);
+        int campiona(QRandomGenerator& generatore) const;
+
+    private:
+        std::vector<double> m_cumulata;
+    };
+
+    QJsonObject creaLibro();
+    QJsonObject creaFilm();
+    QJsonObject creaArticolo();
+    void campiComuni(QJsonObject& media, const QString& tipo, quint64 numero, int annoMinimo);
+
+    int anno(int minimo);
+    QString titolo();
+    QString descrizione();
+    QStringList persone(const QStringList& serbatoio, const DistribuzioneZipf& distribuzione,
+                        int minimo, double continua, int massimo);
+    int geometrica(int minimo, double continua, int massimo);
+    double normale();
+    QString scegli(const QStringList& serbatoio, const DistribuzioneZipf& distribuzione);
+
+    static QStringList creaNomi(int quanti, quint32 seme);
+
+    Opzioni m_opzioni;
+    QRandomGenerator m_generatore;
+    int m_annoMassimo;
+
+    quint64 m_libri;
+    quint64 m_film;
+    quint64 m_articoli;
+
+    QStringList m_autori;
+    QStringList m_registi;
+    QStringList m_attori;
+    QStringList m_editori;
+    QStringList m_caseProduzione;
+    QStringList m_riviste;
+
+    DistribuzioneZipf m_zipfAutori;
+    DistribuzioneZipf m_zipfRegisti;
+    DistribuzioneZipf m_zipfAttori;
+    DistribuzioneZipf m_zipfEditori;
+    DistribuzioneZipf m_zipfCaseProduzione;
+    DistribuzioneZipf m_zipfRiviste;
+    DistribuzioneZipf m_zipfParole;
+
+    static const int NUMERO_AUTORI = 20000;
+    static const int NUMERO_REGISTI = 3000;
+    static const int NUMERO_ATTORI = 30000;
+    static const int NUMERO_EDITORI = 40;
+    static const int NUMERO_CASE_PRODUZIONE = 30;
+};
+
+#endif
@@ -0,0 +1,76 @@
+#include "generatorecatalogo.h"
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QFile>
+#include <QTextStream>
+#include <cstdio>
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    app.setApplicationName("generatore_catalogo");
+    app.setApplicationVersion("1.0");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Genera una collezione sintetica nel formato di Biblioteca Manager");
+    parser.addHelpOption();
+    parser.addVersionOption();
+
+    QCommandLineOption numeroOpzione({"n", "numero"}, "Numero di media da generare.", "numero", "1000");
+    QCommandLineOption semeOpzione({"s", "seme"}, "Seme del generatore casuale.", "seme", "1");
+    QCommandLineOption zipfOpzione({"z", "zipf"}, "Esponente della legge di Zipf.", "esponente", "1.1");
+    QCommandLineOption annoOpzione("anno-massimo", "Anno più recente (predefinito: l'anno corrente).", "anno", "0");
+    QCommandLineOption libriOpzione("libri", "Quota dei libri (0-1).", "quota", "0.5");
+    QCommandLineOption filmOpzione("film", "Quota dei film (0-1); il resto sono articoli.", "quota", "0.3");
+    QCommandLineOption uscitaOpzione({"o", "output"}, "File di uscita (predefinito: standard output).", "file");
+    parser.addOptions({numeroOpzione, semeOpzione, zipfOpzione, annoOpzione, libriOpzione, filmOpzione, uscitaOpzione});
+    parser.process(app);
+
+    QTextStream errori(stderr);
+    GeneratoreCatalogo::Opzioni opzioni;
+    bool ok = true;
+    bool valido = true;
+    opzioni.numero = parser.value(numeroOpzione).toULongLong(&ok);
+    valido = valido && ok;
+    opzioni.seme = parser.value(semeOpzione).toUInt(&ok);
+    valido = valido && ok;
+    opzioni.esponenteZipf = parser.value(zipfOpzione).toDouble(&ok);
+    valido = valido && ok && opzioni.esponenteZipf > 0;
+    opzioni.annoMassimo = parser.value(annoOpzione).toInt(&ok);
+    valido = valido && ok;
+    opzioni.quotaLibri = parser.value(libriOpzione).toDouble(&ok);
+    valido = valido && ok;
+    opzioni.quotaFilm = parser.value(filmOpzione).toDouble(&ok);
+    valido = valido && ok && opzioni.quotaLibri >= 0 && opzioni.quotaFilm >= 0
+             && opzioni.quotaLibri + opzioni.quotaFilm <= 1.0;
+    if (!valido) {
+        errori << "Parametri non validi\n";
+        return 1;
+    }
+
+    QFile uscita;
+    bool aperto;
+    if (parser.isSet(uscitaOpzione)) {
+        uscita.setFileName(parser.value(uscitaOpzione));
+        aperto = uscita.open(QIODevice::WriteOnly);
+    } else {
+        aperto = uscita.open(stdout, QIODevice::WriteOnly);
+    }
+    if (!aperto) {
+        errori << "Impossibile aprire l'uscita: " << uscita.errorString() << "\n";
+        return 1;
+    }
+
+    GeneratoreCatalogo generatore(opzioni);
+    bool scritto = generatore.genera(uscita, [&](quint64 scritti) {
+        errori << QString("\r%1 / %2 media").arg(scritti).arg(opzioni.numero);
+        errori.flush();
+    });
+    errori << "\n";
+
+    if (!scritto) {
+        errori << "Errore di scrittura: " << uscita.errorString() << "\n";
+        return 1;
+    }
+    return 0;
+}